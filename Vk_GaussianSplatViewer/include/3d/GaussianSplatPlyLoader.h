@@ -3,19 +3,48 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <memory>
 
 #include "../structs/geometry/GaussianSurface.h"
 
+namespace tinyply
+{
+    struct PlyData;
+}
+
 namespace splat_loader
 {
     class GaussianSplatPlyLoader
     {
     public:
+        //Parses and decodes the whole file into get_gaussians()
         bool load(const std::string& file_path);
 
+        //Reads the raw vertex properties without building GaussianSurfaces yet
+        bool open(const std::string& file_path);
+
+        [[nodiscard]] size_t get_vertex_count() const { return vertex_count; }
+
+        //Interleaves the opened properties into vertex_count surfaces at destination.
+        //Writes every surface once in order and never reads back, so destination can be write-combined mapped GPU memory
+        void decode(GaussianSurface* destination) const;
+
+        //Same for the count surfaces starting at vertex first, so the staging ring can be filled one chunk at a time
+        void decode(GaussianSurface* destination, size_t first, size_t count) const;
+
         [[nodiscard]] const std::vector<GaussianSurface>& get_gaussians() const { return gaussians; }
 
     private:
         std::vector<GaussianSurface> gaussians;
+
+        size_t vertex_count = 0;
+
+        std::shared_ptr<tinyply::PlyData> position[3];
+        std::shared_ptr<tinyply::PlyData> normal[3];
+        std::shared_ptr<tinyply::PlyData> opacity;
+        std::shared_ptr<tinyply::PlyData> scale[3];
+        std::shared_ptr<tinyply::PlyData> rotation[4];
+        std::shared_ptr<tinyply::PlyData> f_dc[3];
+        std::shared_ptr<tinyply::PlyData> f_rest[45];
     };
 } // splat_loader
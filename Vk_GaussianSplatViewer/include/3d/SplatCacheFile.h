@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+#include "../structs/geometry/GaussianSurface.h"
+
+namespace splat_loader
+{
+    //Header of a binary splat cache. The surfaces follow at data_offset as a raw GaussianSurface array
+    struct SplatCacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t surface_size;
+        uint64_t surface_count;
+        uint64_t data_offset;
+    };
+
+    //Memory mapped binary splat cache of a source PLY, kept in the per user cache directory.
+    //Data offset and file size are padded to cache_alignment, so the whole mapping can be imported as host memory
+    //(VK_EXT_external_memory_host) on any device whose import alignment is not larger than that
+    class SplatCacheFile
+    {
+    public:
+        static constexpr uint64_t cache_alignment = 64 * 1024;
+        static constexpr uint32_t cache_version = 1;
+        static constexpr const char* cache_extension = ".gsvcache";
+        static constexpr const char* cache_directory_name = "Vk_GaussianSplatViewer";
+
+        SplatCacheFile() = default;
+        ~SplatCacheFile();
+
+        SplatCacheFile(const SplatCacheFile&) = delete;
+        SplatCacheFile& operator=(const SplatCacheFile&) = delete;
+
+        //Maps an existing cache. Pages are mapped copy-on-write rather than read-only because some drivers
+        //only import host memory they could write to; nothing ever writes through this mapping
+        bool open(const std::string& file_path);
+        void close();
+
+        //Creates a cache for surface_count surfaces and lets writer fill them directly in the mapped file.
+        //The cache only appears under file_path once it was completely written. Missing parent directories are created
+        static bool write(const std::string& file_path, size_t surface_count, const std::function<void(GaussianSurface* destination)>& writer);
+
+        //Cache of source_path in get_cache_directory(), named after the file and a hash of its absolute path,
+        //so sources in read-only or shared folders get one too and equally named files do not collide
+        [[nodiscard]] static std::string get_cache_path(const std::string& source_path);
+
+        //%LOCALAPPDATA% on Windows, $XDG_CACHE_HOME or ~/.cache elsewhere, with cache_directory_name appended.
+        //Falls back to the system temp directory when none of them is set
+        [[nodiscard]] static std::filesystem::path get_cache_directory();
+        [[nodiscard]] static bool is_cache_file(const std::string& file_path);
+
+        //Does the cache exist and is it newer than its source file?
+        [[nodiscard]] static bool is_up_to_date(const std::string& cache_path, const std::string& source_path);
+
+        [[nodiscard]] size_t get_surface_count() const { return surface_count; }
+        [[nodiscard]] const GaussianSurface* get_surfaces() const;
+
+        //Whole page aligned mapping, and where the surfaces start inside it
+        [[nodiscard]] void* get_mapping() const { return mapping; }
+        [[nodiscard]] uint64_t get_mapping_size() const { return mapping_size; }
+        [[nodiscard]] uint64_t get_data_offset() const { return data_offset; }
+
+    private:
+        void* mapping = nullptr;
+        uint64_t mapping_size = 0;
+        uint64_t data_offset = 0;
+        size_t surface_count = 0;
+
+#ifdef _WIN32
+        void* file_handle = nullptr;
+        void* mapping_handle = nullptr;
+#else
+        int file_descriptor = -1;
+#endif
+
+        bool map_file(const std::string& file_path, uint64_t size, bool create);
+
+        //Writes the mapped pages of a created cache to disk
+        bool flush() const;
+    };
+}
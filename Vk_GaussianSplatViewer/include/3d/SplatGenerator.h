@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "enums/SplatDistribution.h"
+#include "../structs/geometry/GaussianSurface.h"
+
+namespace splat_loader
+{
+    //Distribution of one per-splat value
+    struct ValueDistribution
+    {
+        enum class Type : uint8_t
+        {
+            //Always a
+            Constant,
+
+            //Between a and b
+            Uniform,
+
+            //Median a, sigma b in log space
+            LogNormal
+        };
+
+        Type type = Type::Uniform;
+        float a = 0.0f;
+        float b = 1.0f;
+
+        [[nodiscard]] float sample(std::mt19937& rng) const;
+    };
+
+    struct SplatGeneratorParams
+    {
+        size_t count = 1000000;
+        uint32_t seed = 1;
+
+        SplatDistribution distribution = SplatDistribution::Uniform;
+
+        //Half size of the generated volume, around the origin
+        float extent = 2.0f;
+
+        //Clustered only
+        uint32_t cluster_count = 64;
+        float cluster_radius = 0.08f;
+
+        //World space size of each axis, stored as log like trained scenes
+        ValueDistribution scale = { ValueDistribution::Type::LogNormal, 0.01f, 0.5f };
+
+        //Stored as a logit like trained scenes
+        ValueDistribution opacity = { ValueDistribution::Type::Uniform, 0.2f, 0.95f };
+
+        //Higher order coefficients are filled up to this degree, the rest stay zero
+        uint32_t sh_degree = 3;
+
+        //0 uses every hardware thread
+        uint32_t thread_count = 0;
+    };
+
+    //Seeded synthetic scenes for load, sort and render benchmarks.
+    //Splats are generated in fixed size chunks, each with its own RNG stream derived from the seed and the chunk index,
+    //so the output only depends on the parameters and not on the thread count
+    class SplatGenerator
+    {
+    public:
+        static constexpr size_t chunk_size = 64 * 1024;
+
+        //Fills params.count surfaces. Every surface is written once and in order within its chunk, so destination can be mapped GPU memory
+        static void generate(const SplatGeneratorParams& params, GaussianSurface* destination);
+
+        //Fills the count surfaces starting at first, identical to that range of the whole scene. Whole chunks are generated in place,
+        //a chunk the range only partly covers is generated up to the end of the range and its tail copied
+        static void generate(const SplatGeneratorParams& params, size_t first, size_t count, GaussianSurface* destination);
+
+        [[nodiscard]] static std::vector<GaussianSurface> generate(const SplatGeneratorParams& params);
+
+        //Binary little endian PLY with the properties GaussianSplatPlyLoader reads, streamed chunk by chunk
+        static bool write_ply(const std::string& file_path, const SplatGeneratorParams& params);
+
+        //.gsvcache paths are written as a splat cache, everything else as PLY
+        static bool write(const std::string& file_path, const SplatGeneratorParams& params);
+
+        //Applies one command line option (--count, --seed, --distribution, ...). Returns false if name is not a generator option
+        static bool parse_argument(const std::string& name, const char* value, SplatGeneratorParams& params);
+
+        [[nodiscard]] static const char* get_usage();
+
+    private:
+        static std::vector<glm::vec3> create_cluster_centers(const SplatGeneratorParams& params);
+
+        static void generate_chunk(const SplatGeneratorParams& params, const std::vector<glm::vec3>& cluster_centers, size_t chunk_index,
+                                   GaussianSurface* destination, size_t count);
+
+        //Runs generate_chunk for chunks [first_chunk, first_chunk + chunk_count) on the worker threads
+        static void generate_chunks(const SplatGeneratorParams& params, const std::vector<glm::vec3>& cluster_centers, size_t first_chunk,
+                                    size_t chunk_count, GaussianSurface* destination);
+
+        static uint32_t get_thread_count(const SplatGeneratorParams& params);
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch/CameraPath.h"
+#include "batch/ImageWriter.h"
+
+struct FrameReadback;
+
+namespace batch
+{
+    struct BatchOptions
+    {
+        std::string scene_path;
+        std::string camera_path;
+        std::string output_directory;
+
+        ImageFormat format = ImageFormat::PNG;
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+
+        //Offscreen frame slots, the GPU keeps rendering while older frames are read back and encoded
+        uint32_t frames_in_flight = 3;
+
+        //0 picks one less than the hardware thread count
+        uint32_t encoder_threads = 0;
+
+        //Chrome trace of the CPU zones written after the run, empty for none
+        std::string cpu_trace_path;
+    };
+
+    //Renders every pose of a camera path offscreen and writes one image per pose.
+    //Read back frames are handed to a bounded queue of encoder threads so encoding overlaps rendering of the next frames
+    class BatchRenderer
+    {
+    public:
+        explicit BatchRenderer(BatchOptions options);
+
+        //Parses the arguments following --batch: <scene> <poses.json|csv> <output dir> [--format png|exr] [--width N] [--height N]
+        //[--frames-in-flight N] [--threads N] [--cpu-trace <file>]
+        static bool parse_arguments(int argc, char** argv, BatchOptions& out_options);
+
+        static void print_usage();
+
+        //Returns the process exit code
+        int run();
+
+    private:
+        struct EncodeJob
+        {
+            std::string file_path;
+            std::vector<uint8_t> pixels;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        BatchOptions options;
+        std::vector<CameraPose> poses;
+
+        std::vector<std::thread> encoders;
+        std::deque<EncodeJob> jobs;
+        std::mutex jobs_mutex;
+        std::condition_variable jobs_available;
+        std::condition_variable jobs_space;
+        size_t max_queued_jobs = 0;
+        bool stop_encoders = false;
+
+        uint32_t written_count = 0;
+        uint32_t failed_count = 0;
+
+        void start_encoders(uint32_t thread_count);
+        void stop_and_join_encoders();
+        void encoder_loop();
+
+        //Readback callback, runs on the render thread
+        void queue_frame(const FrameReadback& readback);
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace camera
+{
+    class FirstPersonCamera;
+}
+
+namespace batch
+{
+    //One evaluation view. Either position/yaw/pitch like the interactive camera, or a recorded world to camera matrix
+    struct CameraPose
+    {
+        //Output file name without extension
+        std::string name;
+
+        glm::vec3 position{0.0f};
+        float yaw = -90.0f;
+        float pitch = 0.0f;
+        float fov = 45.0f;
+
+        bool has_view_matrix = false;
+        glm::mat4 view{1.0f};
+
+        //Pinhole intrinsics in pixels of the output image
+        bool has_intrinsics = false;
+        float fx = 0.0f;
+        float fy = 0.0f;
+        float cx = 0.0f;
+        float cy = 0.0f;
+    };
+
+    //Loads camera pose lists for batch rendering.
+    //JSON: {"frames": [ ... ]} or a top level array of objects with
+    //  "name", "position" [x,y,z], "yaw", "pitch", "fov", "view" (16 floats, column major) and "intrinsics" {fx, fy, cx, cy}.
+    //CSV: a header row naming the columns out of name,x,y,z,yaw,pitch,fov,fx,fy,cx,cy, then one pose per row. Lines starting with # are skipped
+    class CameraPath
+    {
+    public:
+        static bool load(const std::string& file_path, std::vector<CameraPose>& out_poses);
+
+        //Puts the camera into pose for a width x height image
+        static void apply(const CameraPose& pose, camera::FirstPersonCamera& camera, uint32_t width, uint32_t height);
+
+    private:
+        static bool load_json(const std::string& file_path, std::vector<CameraPose>& out_poses);
+        static bool load_csv(const std::string& file_path, std::vector<CameraPose>& out_poses);
+
+        static std::string get_default_name(size_t index);
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace batch
+{
+    enum class ImageFormat : uint8_t
+    {
+        PNG,
+        EXR
+    };
+
+    //Writes RGBA8 sRGB frames read back from the renderer
+    class ImageWriter
+    {
+    public:
+        static bool write(const std::string& file_path, ImageFormat format, const uint8_t* rgba, uint32_t width, uint32_t height);
+
+        static bool write_png(const std::string& file_path, const uint8_t* rgba, uint32_t width, uint32_t height);
+
+        //Uncompressed scanline OpenEXR with linear half float RGBA channels
+        static bool write_exr(const std::string& file_path, const uint8_t* rgba, uint32_t width, uint32_t height);
+
+        [[nodiscard]] static const char* get_extension(ImageFormat format);
+
+    private:
+        static void append_attribute(std::vector<uint8_t>& header, const char* name, const char* type, const void* data, uint32_t size);
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <nlohmann/json.hpp>
+
+#include "3d/SplatGenerator.h"
+#include "bench/CameraSpline.h"
+#include "bench/FrameStats.h"
+#include "enums/RenderMode.h"
+
+struct EngineContext;
+
+namespace bench
+{
+    struct BenchOptions
+    {
+        //PLY or splat cache. Empty renders a procedurally generated scene instead
+        std::string scene_path;
+        splat_loader::SplatGeneratorParams synthetic;
+
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+        uint32_t frames_in_flight = 2;
+
+        uint32_t warmup_frames = 30;
+        uint32_t frames = 600;
+
+        //Orbit of the camera spline
+        glm::vec3 orbit_center{0.0f};
+        float orbit_radius = 5.0f;
+
+        RenderMode render_mode = RenderMode::HardwareRaster;
+
+        //Every combination is run, mesh shading only where the device supports it
+        std::vector<bool> mesh_shader_modes = { false, true };
+        std::vector<uint32_t> sh_degrees = { 0, 1, 2, 3 };
+
+        //Empty prints the report to stdout
+        std::string output_path;
+
+        //Chrome trace of the CPU zones of all runs, empty for none
+        std::string cpu_trace_path;
+    };
+
+    //Headless flythrough benchmark. For each pipeline / SH degree combination the same camera spline is rendered offscreen,
+    //recording per frame the CPU time of renderer_update, the wall time between frames and the GPU time of both queues
+    class Benchmark
+    {
+    public:
+        explicit Benchmark(BenchOptions options);
+
+        static bool parse_arguments(int argc, char** argv, BenchOptions& out_options);
+        static void print_usage();
+
+        //Returns the process exit code
+        int run();
+
+    private:
+        struct RunResult
+        {
+            bool mesh_shaders = false;
+            uint32_t sh_degree = 0;
+
+            FrameStats cpu_ms;
+            FrameStats frame_ms;
+            FrameStats gpu_ms;
+            FrameStats gpu_compute_ms;
+            FrameStats gpu_graphics_ms;
+        };
+
+        BenchOptions options;
+        CameraSpline spline;
+
+        bool load_scene(EngineContext& engine_context) const;
+
+        static void create_synthetic_scene(EngineContext& engine_context, const splat_loader::SplatGeneratorParams& params);
+
+        RunResult run_configuration(EngineContext& engine_context, bool mesh_shaders, uint32_t sh_degree) const;
+
+        nlohmann::json create_report(EngineContext& engine_context, const std::vector<RunResult>& results) const;
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace camera
+{
+    class FirstPersonCamera;
+}
+
+namespace bench
+{
+    //Closed Catmull-Rom spline of camera positions and look-at targets.
+    //Sampled by frame index rather than elapsed time, so every run renders the exact same views
+    class CameraSpline
+    {
+    public:
+        struct ControlPoint
+        {
+            glm::vec3 position{0.0f};
+            glm::vec3 target{0.0f};
+        };
+
+        CameraSpline() = default;
+        explicit CameraSpline(std::vector<ControlPoint> control_points);
+
+        //Flythrough circling center: control points alternate in radius and height so the path also dollies and cranes
+        static CameraSpline create_orbit(const glm::vec3& center, float radius, uint32_t control_point_count = 8);
+
+        //t in [0, 1) covers the whole loop
+        [[nodiscard]] ControlPoint evaluate(float t) const;
+
+        //Places the camera at sample frame of frame_count
+        void apply(camera::FirstPersonCamera& camera, uint32_t frame, uint32_t frame_count) const;
+
+    private:
+        std::vector<ControlPoint> control_points;
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace bench
+{
+    //Samples of one per-frame metric in milliseconds
+    class FrameStats
+    {
+    public:
+        struct Summary
+        {
+            float mean = 0.0f;
+            float p50 = 0.0f;
+            float p95 = 0.0f;
+            float p99 = 0.0f;
+            float min = 0.0f;
+            float max = 0.0f;
+            size_t count = 0;
+        };
+
+        void reserve(size_t count) { samples.reserve(count); }
+        void add(float milliseconds) { samples.push_back(milliseconds); }
+        [[nodiscard]] bool empty() const { return samples.empty(); }
+
+        [[nodiscard]] Summary summarize() const;
+
+        [[nodiscard]] nlohmann::json to_json() const;
+
+    private:
+        std::vector<float> samples;
+
+        //Nearest rank on sorted samples
+        static float get_percentile(const std::vector<float>& sorted, float percentile);
+    };
+}
@@ -36,6 +36,18 @@ namespace camera
         void set_mouse_sensitivity(float sensitivity);
         void set_fov(float field_of_view);
 
+        // Yaw and pitch in degrees, same convention as mouse look
+        void set_orientation(float yaw_degrees, float pitch_degrees);
+
+        // Recorded pose: world to camera matrix (camera looks down -z), used instead of position/yaw/pitch
+        void set_view_matrix(const glm::mat4& view);
+
+        // Pinhole intrinsics in pixels for a width x height image, used instead of fov and aspect ratio
+        void set_intrinsics(float fx, float fy, float cx, float cy, float width, float height);
+
+        // Back to position/yaw/pitch and fov
+        void clear_pose_overrides();
+
         // Getters
         glm::vec3 get_position() const;
         glm::vec3 get_front() const;
@@ -68,5 +80,12 @@ namespace camera
         // Camera options
         float movement_speed;
         float mouse_sensitivity;
+
+        // Overrides set from recorded camera paths
+        bool has_view_override = false;
+        glm::mat4 view_override{1.0f};
+        bool has_intrinsics = false;
+        glm::vec4 focal_and_center{0.0f};
+        glm::vec2 image_size{0.0f};
     };
 }
@@ -3,4 +3,66 @@
 
 constexpr uint32_t window_width = 1024;
 constexpr uint32_t window_height = 768;
-constexpr const char* window_title = "Vulkan Gaussian Renderer";
\ No newline at end of file
+constexpr const char* window_title = "Vulkan Gaussian Renderer";
+
+//Root folder of the compiled (.spv) shaders
+constexpr const char* shader_directory = R"(D:\Projects\CPP\Vk_GaussianSplat\Vk_GaussianSplatViewer\shaders\)";
+
+//Driver compiled shader object binaries, reused across launches. Disable to measure startup without the cache
+constexpr bool use_shader_binary_cache = true;
+constexpr const char* shader_cache_directory = "shader_cache";
+
+//Pipeline backend (no native shader objects): VkPipelineCache saved across launches
+constexpr const char* pipeline_cache_file = "pipeline_cache.bin";
+
+//Enable VK_LAYER_KHRONOS_shader_object instead of falling back to pipelines on drivers without VK_EXT_shader_object
+constexpr bool allow_shader_object_emulation = false;
+
+//Workgroup size shared by the splat compute passes (must match local_size_x in the shaders)
+constexpr uint32_t splat_workgroup_size = 256;
+
+//Bytes of per-frame uniform data (one slot per frame in flight in the uniform ring)
+constexpr uint64_t frame_uniform_slot_size = 64 * 1024;
+
+//Highest spherical harmonics degree stored in the splat files (16 coefficients per channel)
+constexpr uint32_t max_sh_degree = 3;
+
+//Screen tile edge in pixels used by the compute rasterizer (must match TILE_SIZE in the shaders)
+constexpr uint32_t tile_size = 16;
+
+//Average number of tiles a splat may overlap before keys are dropped for the frame
+constexpr uint32_t tile_keys_per_splat = 8;
+
+//Upper bound of the tile key capacity (4 bytes per key in each sort buffer), whatever the splat count
+constexpr uint64_t max_tile_keys = 256ull * 1024 * 1024;
+
+//Splats per task/mesh workgroup (CLUSTER_SIZE in the mesh shaders)
+constexpr uint32_t mesh_cluster_size = 32;
+
+//Keys handled by one radix sort workgroup (SORT_KEYS_PER_WORKGROUP in the shaders)
+constexpr uint32_t sort_keys_per_workgroup = 256 * 16;
+
+//Persistently mapped staging ring used by the upload manager, and the largest copy submitted at once
+constexpr uint64_t upload_staging_size = 64ull * 1024 * 1024;
+constexpr uint64_t upload_chunk_size = 8ull * 1024 * 1024;
+
+//Timestamp scopes each queue lane can record per frame, deeper or later scopes only get debug labels
+constexpr uint32_t gpu_profiler_max_scopes = 64;
+
+//Frames kept for the per pass timing graphs and the profile export
+constexpr uint32_t gpu_profiler_history_length = 240;
+
+//Written by the Export button of the GPU passes panel
+constexpr auto gpu_profile_file = "gpu_profile.csv";
+
+//CPU zones kept per thread (power of two), a trace holds the most recent ones
+constexpr uint32_t cpu_profiler_events_per_thread = 1u << 16;
+
+//Written by the Export CPU Trace button, open in chrome://tracing or ui.perfetto.dev
+constexpr auto cpu_trace_file = "cpu_trace.json";
+
+//Device local heaps warn above this fraction of the budget VK_EXT_memory_budget reports
+constexpr double memory_budget_warning = 0.8;
+
+//New scenes that would push device local usage above this fraction of the budget keep their splats in system memory
+constexpr double memory_budget_limit = 0.9;
\ No newline at end of file
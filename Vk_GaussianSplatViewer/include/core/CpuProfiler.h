@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+//Scoped CPU zones, written as complete events to a Chrome/Perfetto trace (chrome://tracing, ui.perfetto.dev).
+//GSV_CPU_PROFILER is set by the GSV_CPU_PROFILER CMake option, without it the zone macros expand to nothing
+#if GSV_CPU_PROFILER
+#define GSV_CPU_ZONE_CONCAT_INNER(a, b) a##b
+#define GSV_CPU_ZONE_CONCAT(a, b) GSV_CPU_ZONE_CONCAT_INNER(a, b)
+#define GSV_CPU_ZONE(name) core::CpuZone GSV_CPU_ZONE_CONCAT(cpu_zone_, __LINE__)(name)
+#else
+#define GSV_CPU_ZONE(name) ((void)0)
+#endif
+
+namespace core
+{
+    //Every thread appends to its own ring buffer, so recording never takes a lock. Only registering a new thread
+    //and flushing do. The rings keep the most recent events, older ones are overwritten
+    class CpuProfiler
+    {
+    public:
+        //Shown as the thread's track name in the trace
+        static void set_thread_name(const std::string& name);
+
+        //Zone names must outlive the profiler, in practice string literals
+        static void record(const char* name, int64_t start_ns, int64_t end_ns);
+
+        static int64_t now_ns();
+
+        //Writes the events currently held by all threads. Recording threads keep going while this runs
+        static bool write_chrome_trace(const std::string& file_path);
+
+        [[nodiscard]] static constexpr bool is_compiled_in()
+        {
+#if GSV_CPU_PROFILER
+            return true;
+#else
+            return false;
+#endif
+        }
+    };
+
+    class CpuZone
+    {
+    public:
+        explicit CpuZone(const char* name) : name(name), start_ns(CpuProfiler::now_ns()) {}
+        ~CpuZone() { CpuProfiler::record(name, start_ns, CpuProfiler::now_ns()); }
+
+        CpuZone(const CpuZone&) = delete;
+        CpuZone& operator=(const CpuZone&) = delete;
+
+    private:
+        const char* name;
+        int64_t start_ns;
+    };
+}
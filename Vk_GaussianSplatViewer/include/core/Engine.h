@@ -13,15 +13,21 @@ namespace core
     public:
         void init();
 
+        //No window, surface or swapchain: frames go to offscreen images of this size and are read back through
+        //RenderPass::set_readback_callback. The caller drives frames with Renderer::renderer_update instead of run()
+        void init_headless(uint32_t width, uint32_t height, uint32_t max_frames_in_flight = 2);
+
         void run() const;
         void cleanup();
 
+        [[nodiscard]] EngineContext& get_engine_context() const { return *engine_context; }
+
     private:
         //Stored here pass this as a pointer or reference wherever needed
         std::unique_ptr<EngineContext> engine_context;
 
         void create_window() const;
-        void create_renderer() const;
+        void create_renderer(const VkExtent2D* offscreen_extent = nullptr, uint32_t max_frames_in_flight = 2) const;
         void create_ui_and_input() const;
         void create_buffer_container() const;
 
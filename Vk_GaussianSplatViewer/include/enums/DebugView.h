@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+//Replaces the splat color in the preprocess pass. Values match DEBUG_VIEW_* in shaders/common/variant.glsl
+enum class DebugView : uint8_t
+{
+    None,
+
+    //View space depth on a heat ramp
+    Depth,
+
+    //Screen space radius of the splat footprint
+    Radius,
+
+    //Cached opacity as gray, drawn fully opaque
+    Opacity,
+
+    //Fragments (hardware raster) or evaluated splats (tile compute) per pixel on a heat ramp. Drawn by the overdraw pass
+    Overdraw,
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+//What a VMA allocation holds, see utils::MemoryTracker. Allocations made outside VMA (the ImGui backend) are not categorized
+enum class MemoryCategory : uint8_t
+{
+    //Gaussian surfaces, per-splat records and the color cache
+    Splats,
+
+    //Keys, values, histograms and tile ranges of the tile compute rasterizer
+    Sort,
+
+    //Upload ring, readback copies and other host visible transfer buffers
+    Staging,
+
+    //Per frame uniform ring
+    Uniforms,
+
+    //Compute output images and offscreen color targets
+    Targets,
+
+    Depth,
+
+    //Overdraw counters and other debug view resources
+    Debug,
+
+    Other,
+
+    Count
+};
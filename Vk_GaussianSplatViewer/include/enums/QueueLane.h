@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+//Queues that submit through the FrameScheduler, each one owns a timeline semaphore
+enum class QueueLane : uint8_t
+{
+    Graphics,
+
+    //Async compute (sort, cull, SH). Aliases the graphics queue when the device has no separate compute family
+    Compute,
+
+    //Dedicated transfer queue used for uploads
+    Transfer,
+
+    Count
+};
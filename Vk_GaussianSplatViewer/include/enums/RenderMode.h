@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+enum class RenderMode : uint8_t
+{
+    //Point sprites rasterized by the fixed function pipeline
+    HardwareRaster,
+
+    //16x16 tile binning, sort and front-to-back blending in compute
+    TileCompute,
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+//Spatial layout of procedurally generated splats
+enum class SplatDistribution : uint8_t
+{
+    //Uniform in a cube
+    Uniform,
+
+    //Gaussian blobs around random cluster centers, like the dense objects of a capture
+    Clustered,
+
+    //Flat splats lying on a sphere and a ground plane, oriented along the surface like trained scenes
+    Surface
+};
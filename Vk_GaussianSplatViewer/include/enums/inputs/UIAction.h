@@ -3,7 +3,20 @@
 enum class UIAction
 {
     ALLOCATE_SPLAT_MEMORY,
+    APPEND_SPLAT_MEMORY,
     LOAD_GAUSSIAN_SPLAT,
     LOAD_POINT_CLOUD,
-    TOGGLE_VIEW
+    TOGGLE_VIEW,
+    SET_RENDER_MODE,
+    TOGGLE_MESH_SHADERS,
+    SET_SH_DEGREE,
+    TOGGLE_COLOR_CACHE,
+    SET_COLOR_CACHE_THRESHOLD,
+    TOGGLE_ASYNC_COMPUTE,
+    TOGGLE_FRUSTUM_CULLING,
+    SET_DEBUG_VIEW,
+    SET_OVERDRAW_SCALE,
+    TOGGLE_SPLAT_CACHE,
+    EXPORT_GPU_PROFILE,
+    EXPORT_CPU_TRACE
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <vulkan/vulkan_core.h>
+#include "materials/PipelineObject.h"
 #include "materials/ShaderObject.h"
 
 struct EngineContext;
@@ -24,18 +25,24 @@ namespace material
         void init();
 
         void add_shader_object(std::unique_ptr<ShaderObject> shader_object);
+        void add_pipeline_object(std::unique_ptr<PipelineObject> pipeline_object);
         void add_pipeline_layout(VkPipelineLayout pipeline_layout);
         void add_descriptor_set(VkDescriptorSet descriptor_set);
 
         [[nodiscard]] VkPipelineLayout get_pipeline_layout() const { return pipeline_layout; }
         [[nodiscard]] ShaderObject* get_shader_object() const { return shader_object.get(); }
+        [[nodiscard]] PipelineObject* get_pipeline_object() const { return pipeline_object.get(); }
         VkDescriptorSet& get_descriptor_set()  { return descriptor_set; }
         [[nodiscard]] std::string get_material_name() const { return material_name; }
 
+        //Binds the shader objects or the pipeline, whichever backend the material was built for
+        void bind(VkCommandBuffer command_buffer) const;
+
         void cleanup();
 
     private: 
         std::unique_ptr<ShaderObject> shader_object;
+        std::unique_ptr<PipelineObject> pipeline_object;
         VkDescriptorSet descriptor_set;
         VkPipelineLayout pipeline_layout;
 
@@ -1,7 +1,10 @@
 ﻿#pragma once
 
 #include "Material.h"
+#include "ShaderVariant.h"
 #include <string>
+#include <unordered_map>
+#include "config/Config.inl"
 
 struct EngineContext;
 
@@ -13,16 +16,51 @@ namespace material
 
         MaterialUtils(EngineContext& engine_context) : engine_context(engine_context)
         {
-            vertex_shader_path = R"(D:\Projects\CPP\Vk_GaussianSplat\Vk_GaussianSplatViewer\shaders\gaussian_surface\gaussian.vert.spv)";
-            fragment_shader_path = R"(D:\Projects\CPP\Vk_GaussianSplat\Vk_GaussianSplatViewer\shaders\gaussian_surface\gaussian.frag.spv)";
+            vertex_shader_path = std::string(shader_directory) + R"(gaussian_surface\gaussian.vert.spv)";
+            fragment_shader_path = std::string(shader_directory) + R"(gaussian_surface\gaussian.frag.spv)";
         }
 
         [[nodiscard]] std::shared_ptr<Material> create_material(const std::string& name) const;
 
+        //Creates a material holding a single compute shader object. Push constants are visible to the compute stage only
+        [[nodiscard]] std::shared_ptr<Material> create_compute_material(const std::string& name,
+                                                                        const std::string& compute_shader_path,
+                                                                        uint32_t push_constant_size,
+                                                                        const VkDescriptorSetLayout* set_layouts = nullptr,
+                                                                        uint32_t set_layout_count = 0,
+                                                                        const VkSpecializationInfo* specialization_info = nullptr) const;
+
+        //Creates a task/mesh/fragment material. Push constants are visible to all three stages
+        [[nodiscard]] std::shared_ptr<Material> create_mesh_material(const std::string& name,
+                                                                     const std::string& task_shader_path,
+                                                                     const std::string& mesh_shader_path,
+                                                                     uint32_t push_constant_size) const;
+
+        //Compute material specialized for the variant. Compiled on first request, later requests return the cached material.
+        //The cache lives in this instance, so a pass that switches variants keeps its MaterialUtils around
+        [[nodiscard]] std::shared_ptr<Material> get_compute_variant(const std::string& name,
+                                                                    const std::string& compute_shader_path,
+                                                                    uint32_t push_constant_size,
+                                                                    const ShaderVariant& variant);
+
+        //Destroys every cached variant
+        void cleanup_variants();
+
+        [[nodiscard]] size_t get_variant_count() const { return variants.size(); }
+
     private:
         EngineContext& engine_context;
+
+        //Native shader objects, or VkPipelines built through the on-disk pipeline cache
+        [[nodiscard]] bool use_shader_objects() const;
+        [[nodiscard]] VkPipelineCache get_pipeline_cache() const;
+        [[nodiscard]] PipelineObject::GraphicsState get_graphics_state(VkPolygonMode polygon_mode) const;
+
         std::string vertex_shader_path;
         std::string fragment_shader_path;
 
+        //name + ShaderVariant::get_key()
+        std::unordered_map<std::string, std::shared_ptr<Material>> variants;
+
     };
 }
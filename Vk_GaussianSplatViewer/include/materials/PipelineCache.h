@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vulkan/vulkan_core.h>
+
+struct EngineContext;
+
+namespace material
+{
+    //VkPipelineCache persisted to disk for the pipeline backend.
+    //The saved blob is only handed back to the driver when its header matches this device (vendor, device, cache UUID)
+    class PipelineCache
+    {
+    public:
+        PipelineCache(EngineContext& engine_context, std::string file_path);
+
+        bool init();
+
+        //Writes the current cache contents, then destroys the cache
+        void cleanup();
+
+        [[nodiscard]] VkPipelineCache get_pipeline_cache() const { return pipeline_cache; }
+
+        //Size of the blob that was loaded at startup, 0 on a cold start
+        [[nodiscard]] size_t get_loaded_size() const { return loaded_size; }
+
+    private:
+        EngineContext& engine_context;
+        std::string file_path;
+
+        VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+        size_t loaded_size = 0;
+
+        void save() const;
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include "VkBootstrapDispatch.h"
+
+namespace material
+{
+    //Classic VkPipeline counterpart of ShaderObject, used when the driver has no native VK_EXT_shader_object.
+    //State GeometryPass sets through core dynamic state stays dynamic; what would need extended dynamic state 3
+    //(polygon mode, blending, sample state) is baked in at creation
+    class PipelineObject
+    {
+    public:
+        //Attachments of the dynamic rendering pass and the baked raster state
+        struct GraphicsState
+        {
+            VkFormat color_format = VK_FORMAT_UNDEFINED;
+            VkFormat depth_stencil_format = VK_FORMAT_UNDEFINED;
+            VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
+        };
+
+        PipelineObject() = default;
+        ~PipelineObject() = default;
+
+        //Vertex/fragment pipeline with dynamic vertex input (VK_EXT_vertex_input_dynamic_state)
+        bool create_graphics_pipeline(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                      const char* vertex_code, size_t vertex_code_size,
+                                      const char* fragment_code, size_t fragment_code_size,
+                                      const GraphicsState& state);
+
+        //Task -> mesh -> fragment pipeline (VK_EXT_mesh_shader)
+        bool create_mesh_pipeline(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                  const char* task_code, size_t task_code_size,
+                                  const char* mesh_code, size_t mesh_code_size,
+                                  const char* fragment_code, size_t fragment_code_size,
+                                  const GraphicsState& state);
+
+        bool create_compute_pipeline(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                     const char* compute_code, size_t compute_code_size,
+                                     const VkSpecializationInfo* specialization_info = nullptr);
+
+        void bind(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer) const;
+
+        void destroy(const vkb::DispatchTable& disp);
+
+    private:
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+        static VkShaderModule create_shader_module(const vkb::DispatchTable& disp, const char* code, size_t code_size);
+
+        bool create_graphics(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                             const VkPipelineShaderStageCreateInfo* stages, uint32_t stage_count, const GraphicsState& state,
+                             bool has_vertex_input);
+    };
+}
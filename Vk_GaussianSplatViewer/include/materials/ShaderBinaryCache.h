@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct EngineContext;
+
+namespace material
+{
+    //Header of one cache entry. Per shader sizes follow, then the binaries padded to 16 bytes
+    struct ShaderBinaryCacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t shader_count;
+        uint8_t device_uuid[VK_UUID_SIZE];
+        uint8_t shader_binary_uuid[VK_UUID_SIZE];
+        uint32_t driver_version;
+        uint32_t shader_binary_version;
+        uint64_t source_hash;
+    };
+
+    //On-disk cache of shader object binaries (vkGetShaderBinaryDataEXT).
+    //Each linked group of shaders is one file named after the hash of its SPIR-V and create infos. An entry is only
+    //reused when device UUID, driver version and the driver's shader binary UUID/version still match; otherwise the
+    //SPIR-V is compiled again and the entry overwritten
+    class ShaderBinaryCache
+    {
+    public:
+        ShaderBinaryCache(EngineContext& engine_context, std::string cache_directory, bool enabled);
+
+        //Drop-in for createShadersEXT with SPIR-V create infos
+        VkResult create_shaders(uint32_t count, const VkShaderCreateInfoEXT* create_infos, VkShaderEXT* out_shaders);
+
+        //Shader groups created from cached binaries / compiled from SPIR-V, and the host time spent creating all of them
+        [[nodiscard]] uint32_t get_hit_count() const { return hit_count; }
+        [[nodiscard]] uint32_t get_miss_count() const { return miss_count; }
+        [[nodiscard]] float get_creation_ms() const { return creation_ms; }
+        [[nodiscard]] bool is_enabled() const { return enabled; }
+
+    private:
+        //Keeps binaries 16 byte aligned, as VK_SHADER_CODE_TYPE_BINARY_EXT requires
+        struct alignas(16) BinaryBlock
+        {
+            uint8_t bytes[16];
+        };
+
+        EngineContext& engine_context;
+        std::string cache_directory;
+        bool enabled;
+
+        uint8_t device_uuid[VK_UUID_SIZE]{};
+        uint8_t shader_binary_uuid[VK_UUID_SIZE]{};
+        uint32_t driver_version = 0;
+        uint32_t shader_binary_version = 0;
+
+        uint32_t hit_count = 0;
+        uint32_t miss_count = 0;
+        float creation_ms = 0.0f;
+
+        static uint64_t hash_create_infos(uint32_t count, const VkShaderCreateInfoEXT* create_infos);
+        [[nodiscard]] std::string get_entry_path(uint64_t source_hash) const;
+
+        //Reads an entry and points binary_infos at its binaries. False when missing or written for another device/driver
+        bool load(const std::string& path, uint64_t source_hash, uint32_t count, const VkShaderCreateInfoEXT* create_infos,
+                  std::vector<BinaryBlock>& file_data, std::vector<VkShaderCreateInfoEXT>& binary_infos) const;
+        void store(const std::string& path, uint64_t source_hash, uint32_t count, const VkShaderEXT* shaders) const;
+    };
+}
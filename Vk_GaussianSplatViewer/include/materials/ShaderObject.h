@@ -10,6 +10,8 @@ struct Init;
 
 namespace material
 {
+	class ShaderBinaryCache;
+
 	class ShaderObject
 	{
 	public:
@@ -65,6 +67,12 @@ namespace material
 				shader = _shader;
 			}
 
+			//Must stay alive until the shader object is created
+			void set_specialization_info(const VkSpecializationInfo* specialization_info)
+			{
+				vk_shader_create_info.pSpecializationInfo = specialization_info;
+			}
+
 			void destroy(const vkb::DispatchTable& disp);
 		};
 
@@ -75,30 +83,60 @@ namespace material
 			char* vertexShader, size_t vertShaderSize,
 			char* fragmentShader, size_t fragShaderSize,
 			const VkDescriptorSetLayout *pSetLayouts, uint32_t setLayoutCount,
-			const VkPushConstantRange *pPushConstantRange, uint32_t pPushConstantCount);
+			const VkPushConstantRange *pPushConstantRange, uint32_t pPushConstantCount,
+			ShaderBinaryCache* binary_cache = nullptr);
+
+		void create_compute_shader(const vkb::DispatchTable& disp,
+			char* computeShader, size_t compShaderSize,
+			const VkDescriptorSetLayout *pSetLayouts, uint32_t setLayoutCount,
+			const VkPushConstantRange *pPushConstantRange, uint32_t pPushConstantCount,
+			const VkSpecializationInfo *pSpecializationInfo = nullptr,
+			ShaderBinaryCache* binary_cache = nullptr);
+
+		//Linked task -> mesh -> fragment shaders (VK_EXT_mesh_shader)
+		void create_mesh_shaders(const vkb::DispatchTable& disp,
+			char* taskShader, size_t taskShaderSize,
+			char* meshShader, size_t meshShaderSize,
+			char* fragmentShader, size_t fragShaderSize,
+			const VkDescriptorSetLayout *pSetLayouts, uint32_t setLayoutCount,
+			const VkPushConstantRange *pPushConstantRange, uint32_t pPushConstantCount,
+			ShaderBinaryCache* binary_cache = nullptr);
     
 		void destroy_shaders(const vkb::DispatchTable& disp);
 
 		static void bind_shader(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer, const ShaderObject::Shader *shader);
 		void bind_material_shader(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer) const;
 
+		//With the mesh shader feature enabled every draw needs the task/mesh stages bound, even if to VK_NULL_HANDLE
+		static void unbind_mesh_stages(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer);
+
 		template<size_t N>
 		static void set_initial_state(vkb::DispatchTable& disp, VkExtent2D viewport_extent, VkCommandBuffer cmd_buffer, VkVertexInputBindingDescription2EXT
 		                              vertex_input_binding, std::array<VkVertexInputAttributeDescription2EXT, N> input_attribute_description,
 		                              VkExtent2D scissor_extents,
-		                              VkOffset2D scissor_offset);
+		                              VkOffset2D scissor_offset,
+		                              bool set_extended_state = true);
 
 	private:
-		static void build_linked_shaders(const vkb::DispatchTable& disp, ShaderObject::Shader* vert, ShaderObject::Shader* frag);
+		static void build_linked_shaders(const vkb::DispatchTable& disp, ShaderObject::Shader* vert, ShaderObject::Shader* frag,
+		                                 ShaderBinaryCache* binary_cache);
+
+		//Goes through the binary cache when there is one
+		static VkResult create_shader_objects(const vkb::DispatchTable& disp, ShaderBinaryCache* binary_cache, uint32_t count,
+		                                      const VkShaderCreateInfoEXT* create_infos, VkShaderEXT* shaders);
     
 		std::unique_ptr<Shader> vert_shader;
 		std::unique_ptr<Shader> frag_shader;
+		std::unique_ptr<Shader> comp_shader;
+		std::unique_ptr<Shader> task_shader;
+		std::unique_ptr<Shader> mesh_shader;
 	};
 
 	template <size_t N>
 	void ShaderObject::set_initial_state(vkb::DispatchTable& disp, VkExtent2D viewport_extent, VkCommandBuffer cmd_buffer,
 	                                     VkVertexInputBindingDescription2EXT vertex_input_binding,
-	                                     std::array<VkVertexInputAttributeDescription2EXT, N> input_attribute_description, VkExtent2D scissor_extents, VkOffset2D scissor_offset)
+	                                     std::array<VkVertexInputAttributeDescription2EXT, N> input_attribute_description, VkExtent2D scissor_extents, VkOffset2D scissor_offset,
+	                                     bool set_extended_state)
 	{
 		{
 			// Set viewport and scissor
@@ -126,12 +164,17 @@ namespace material
 			disp.cmdSetDepthCompareOpEXT(cmd_buffer, VK_COMPARE_OP_LESS);
 			disp.cmdSetPrimitiveTopologyEXT(cmd_buffer, VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
 			disp.cmdSetRasterizerDiscardEnableEXT(cmd_buffer, VK_FALSE);
-			disp.cmdSetPolygonModeEXT(cmd_buffer, VK_POLYGON_MODE_POINT);
-			disp.cmdSetRasterizationSamplesEXT(cmd_buffer, VK_SAMPLE_COUNT_1_BIT);
-			disp.cmdSetAlphaToCoverageEnableEXT(cmd_buffer, VK_FALSE);
 			disp.cmdSetDepthBiasEnableEXT(cmd_buffer, VK_FALSE);
 			disp.cmdSetStencilTestEnableEXT(cmd_buffer, VK_FALSE);
 			disp.cmdSetPrimitiveRestartEnableEXT(cmd_buffer, VK_FALSE);
+		}
+
+		//Extended dynamic state 3, which a VkPipeline bakes in instead (PipelineObject)
+		if (set_extended_state)
+		{
+			disp.cmdSetPolygonModeEXT(cmd_buffer, VK_POLYGON_MODE_POINT);
+			disp.cmdSetRasterizationSamplesEXT(cmd_buffer, VK_SAMPLE_COUNT_1_BIT);
+			disp.cmdSetAlphaToCoverageEnableEXT(cmd_buffer, VK_FALSE);
 
 			const VkSampleMask sample_mask = 0xFF;
 			disp.cmdSetSampleMaskEXT(cmd_buffer, VK_SAMPLE_COUNT_1_BIT, &sample_mask);
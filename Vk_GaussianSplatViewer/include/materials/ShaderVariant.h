@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vulkan/vulkan_core.h>
+
+#include "enums/DebugView.h"
+
+namespace material
+{
+    //Feature switches compiled into the splat compute shaders as specialization constants.
+    //Every combination is its own shader, so a disabled feature is removed by the compiler instead of branched over
+    struct ShaderVariant
+    {
+        //constant_id 0, SH bands evaluated by the color cache pass
+        uint32_t sh_degree = 3;
+
+        //constant_id 1, guard band frustum test in the preprocess pass
+        bool frustum_culling = true;
+
+        //constant_id 2, color override in the preprocess pass
+        DebugView debug_view = DebugView::None;
+
+        //Unique per combination, used as the cache key in MaterialUtils
+        [[nodiscard]] std::string get_key() const;
+    };
+
+    //Owns the constant data a VkSpecializationInfo points to, so it is not copyable
+    class SpecializationData
+    {
+    public:
+        explicit SpecializationData(const ShaderVariant& variant);
+
+        SpecializationData(const SpecializationData&) = delete;
+        SpecializationData& operator=(const SpecializationData&) = delete;
+
+        [[nodiscard]] const VkSpecializationInfo* get_info() const { return &specialization_info; }
+
+    private:
+        //Booleans are 32 bit VkBool32 in SPIR-V
+        std::array<uint32_t, 3> values{};
+        std::array<VkSpecializationMapEntry, 3> map_entries{};
+        VkSpecializationInfo specialization_info{};
+    };
+}
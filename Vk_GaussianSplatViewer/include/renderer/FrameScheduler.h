@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "enums/QueueLane.h"
+
+struct EngineContext;
+
+namespace core::renderer
+{
+    //Average host observed latency (submit -> timeline value reached) of one kind of submission
+    struct SubmissionLatency
+    {
+        float last_ms = 0.0f;
+        float average_ms = 0.0f;
+        uint64_t count = 0;
+    };
+
+    //A point on the timeline of one queue. Value 0 is always reached
+    struct TimelinePoint
+    {
+        QueueLane lane = QueueLane::Graphics;
+        uint64_t value = 0;
+    };
+
+    //Owns one timeline semaphore per queue lane; every submission signals the next value of its lane.
+    //Uploads, compute and graphics work wait on exact points instead of host side fences.
+    //Lanes are separate because queues complete out of order relative to each other, and a timeline must only grow
+    class FrameScheduler
+    {
+    public:
+        FrameScheduler(EngineContext& engine_context, uint32_t max_frames_in_flight);
+
+        bool init();
+        void cleanup();
+
+        //Blocks until the last submission of this frame slot has finished on the GPU
+        void wait_for_frame_slot(uint32_t frame);
+
+        //Blocks until the timeline of point.lane reached point.value
+        void wait_for(TimelinePoint point) const;
+
+        //Submits command buffers and signals the next value of the lane, which is returned.
+        //The binary semaphores are still needed for the swapchain
+        TimelinePoint submit(QueueLane lane, VkQueue queue, const std::vector<VkCommandBuffer>& command_buffers,
+                             const std::vector<VkSemaphoreSubmitInfo>& wait_semaphores,
+                             const std::vector<VkSemaphoreSubmitInfo>& binary_signal_semaphores,
+                             const std::string& label);
+
+        //Submits the graphics work of a frame and remembers its point for the frame slot.
+        //Anything the frame depends on on other lanes must be in wait_semaphores
+        TimelinePoint submit_frame(uint32_t frame, VkQueue queue, VkCommandBuffer command_buffer,
+                                   const std::vector<VkSemaphoreSubmitInfo>& wait_semaphores,
+                                   const std::vector<VkSemaphoreSubmitInfo>& binary_signal_semaphores);
+
+        //Wait info for a submission that must not pass stage_mask before point was reached
+        [[nodiscard]] VkSemaphoreSubmitInfo make_wait_info(TimelinePoint point, VkPipelineStageFlags2 stage_mask) const;
+
+        //Resolves finished submissions into latency stats. Called once per frame
+        void poll();
+
+        [[nodiscard]] uint64_t get_completed_value(QueueLane lane) const;
+        [[nodiscard]] TimelinePoint get_last_submitted(QueueLane lane) const { return { lane, last_submitted_values[static_cast<size_t>(lane)] }; }
+        [[nodiscard]] VkSemaphore get_timeline_semaphore(QueueLane lane) const { return timeline_semaphores[static_cast<size_t>(lane)]; }
+        [[nodiscard]] const std::map<std::string, SubmissionLatency>& get_latencies() const { return latencies; }
+
+    private:
+        struct PendingSubmission
+        {
+            std::string label;
+            uint64_t value;
+            std::chrono::high_resolution_clock::time_point submit_time;
+        };
+
+        static constexpr size_t lane_count = static_cast<size_t>(QueueLane::Count);
+
+        EngineContext& engine_context;
+
+        std::array<VkSemaphore, lane_count> timeline_semaphores{};
+        std::array<uint64_t, lane_count> last_submitted_values{};
+
+        //Graphics point of the last submission that used each frame slot
+        std::vector<TimelinePoint> frame_points;
+
+        std::array<std::deque<PendingSubmission>, lane_count> pending_submissions;
+        std::map<std::string, SubmissionLatency> latencies;
+    };
+}
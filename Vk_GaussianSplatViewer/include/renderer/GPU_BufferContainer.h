@@ -1,9 +1,14 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "structs/GPU_Buffer.h"
+#include "structs/UploadReport.h"
 #include "structs/geometry/GaussianSurface.h"
+#include "renderer/GrowableBuffer.h"
+#include "renderer/UniformRing.h"
 
 struct EngineContext;
 
@@ -12,30 +17,121 @@ namespace camera
     class FirstPersonCamera;
 }
 
+namespace splat_loader
+{
+    class SplatCacheFile;
+}
+
 namespace core::renderer
 {
     class GPU_BufferContainer
     {
     public:
+        //Writes count surfaces, starting first surfaces into the new ones, to destination
+        using SurfaceDecoder = std::function<void(GaussianSurface* destination, size_t first, size_t count)>;
+
         GPU_BufferContainer(EngineContext& engine_context);
 
-        //Camera Buffer
-        GPU_Buffer camera_data_buffer;
+        //Per-frame uniform data (camera, ...) lives in a persistently mapped ring, one slot per frame in flight
+        std::unique_ptr<UniformRing> frame_uniforms;
+
+        //Where this frame's CameraData was written in the ring. Passed to shaders as a push constant
+        VkDeviceAddress camera_data_address = 0;
+
+        //Frame slot that is currently being recorded, and how many slots exist
+        uint32_t frame_index = 0;
+        uint32_t frame_count = 1;
 
         //Gaussian Buffers
         GPU_Buffer mesh_vertices_buffer;
         GPU_Buffer mesh_indices_buffer;
 
-        GPU_Buffer gaussian_buffer;
+        //Grows by doubling with a GPU side copy, so appending surfaces to a scene only uploads the new ones.
+        //Read the handle and address through get_buffer(), they change when it grows
+        GrowableBuffer gaussian_buffer;
+
+        //Set when the last gaussian allocation did not fit the VRAM budget and its surfaces were placed in system memory instead
+        bool gaussians_in_system_memory = false;
+
+        //Per-splat screen space records written by the preprocess pass (one SplatRecord per gaussian).
+        //One copy per frame in flight so async compute of the next frame can overlap this frame's raster
+        std::vector<GPU_Buffer> splat_record_buffers;
+
+        //Per-splat RGBA16F color evaluated from the SH coefficients by the color cache pass
+        GPU_Buffer color_cache_buffer;
+
+        //One uint per pixel counting fragments for the overdraw view. Owned by the overdraw pass, which sets
+        //overdraw_enabled before the camera data of the frame is written
+        GPU_Buffer overdraw_buffer;
+        bool overdraw_enabled = false;
+
+        //Transient memory of the compute passes, from the scratch pool. Passes bind their scratch buffers into it with
+        //MemoryUtils::create_aliasing_buffer, so passes running one after another on the compute queue share the same bytes.
+        //Nothing in it survives from one pass to the next; a pass starts with a barrier against all earlier compute work
+        GPU_Buffer compute_scratch_buffer;
+
+        //Bumped whenever the scratch memory is reallocated. Buffers bound into the old memory must be recreated
+        uint32_t compute_scratch_version = 0;
 
         //How many surfaces has the uploader extracted?
         uint32_t gaussian_count = 0;
 
-        void allocate_camera_buffer(const camera::FirstPersonCamera& first_person_camera);
+        //Bumped every time the gaussian surfaces change (replaced, appended or updated) so cached data can be invalidated
+        uint32_t scene_version = 0;
+
+        //Path and host throughput of the last gaussian buffer upload
+        UploadReport last_gaussian_upload;
+
+        void allocate_camera_buffer(const camera::FirstPersonCamera& first_person_camera, uint32_t frame_count);
 
         void allocate_gaussian_surface_buffer(const std::vector<GaussianSurface>& gaussians);
 
+        //Lets decoder write count surfaces into the new gaussian buffer. On resizable BAR / UMA devices
+        //that is mapped VRAM and decoder is called once for all of them, otherwise it fills the staging ring a chunk at a time.
+        //Either way a loader decodes the file without an intermediate copy
+        void allocate_gaussian_surface_buffer(size_t count, const SurfaceDecoder& decoder);
+
+        //Fills the new gaussian buffer from a mapped splat cache. With VK_EXT_external_memory_host the transfer queue reads the
+        //file pages directly and the cache stays mapped until that copy finished; otherwise the mapping is written like any other source
+        void allocate_gaussian_surface_buffer(std::shared_ptr<splat_loader::SplatCacheFile> cache_file);
+
+        //Same as the allocate overloads, but the surfaces are added after the current ones instead of replacing them.
+        //Only the new surfaces are uploaded; when the buffer has to grow, the old ones are copied on the GPU
+        void append_gaussian_surfaces(size_t count, const SurfaceDecoder& decoder);
+        void append_gaussian_surfaces(std::shared_ptr<splat_loader::SplatCacheFile> cache_file);
+
+        //Overwrites count surfaces starting at first, uploading only that range. Waits for the frames in flight
+        void update_gaussian_surfaces(size_t first, const GaussianSurface* surfaces, size_t count);
+
+        //Writes the camera matrices and viewport of the frame that is about to be recorded into that frame's ring slot
+        void update_camera_buffer(const camera::FirstPersonCamera& first_person_camera, VkExtent2D extent, uint32_t frame);
+
+        [[nodiscard]] GPU_Buffer& get_splat_record_buffer() { return splat_record_buffers[frame_index]; }
+
+        void destroy_splat_record_buffers();
+
+        //Grows the compute scratch to at least size bytes. Returns true when it was reallocated
+        bool reserve_compute_scratch(VkDeviceSize size);
+
     private:
         EngineContext& engine_context;
+
+        //Capacity the splat records and color cache were allocated for
+        size_t per_splat_capacity = 0;
+
+        //Allocation callback of gaussian_buffer. Places the surfaces in system memory when they do not fit the VRAM budget
+        void create_gaussian_memory(VkDeviceSize size, GPU_Buffer& out_buffer);
+
+        void append_surfaces(size_t count, const SurfaceDecoder& decoder);
+        void append_surfaces(const std::shared_ptr<splat_loader::SplatCacheFile>& cache_file);
+
+        //Publishes the new surface count and follows the gaussian buffer's capacity with the per-splat buffers
+        void finish_surface_change(bool replaced);
+
+        //Splat records and color cache sized for count surfaces
+        void allocate_per_splat_buffers(size_t count);
+
+        //Defragments the splat pool once the previous scene's buffers are gone
+        void compact_splat_memory();
     };
 }
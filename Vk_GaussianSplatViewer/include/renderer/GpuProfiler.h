@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "enums/QueueLane.h"
+
+struct EngineContext;
+
+namespace core::renderer
+{
+    //GPU time of one named scope in the last finished frame. Scopes recorded several times in a frame (radix passes) are summed
+    struct GpuScopeTiming
+    {
+        std::string name;
+        uint32_t depth = 0;
+        float milliseconds = 0.0f;
+    };
+
+    //Rolling per scope history, oldest value at offset
+    struct GpuScopeHistory
+    {
+        std::string name;
+        uint32_t depth = 0;
+        std::vector<float> values;
+    };
+
+    //Nested timestamp scopes per pass and dispatch, with one query pool per frame slot so results are read once the
+    //slot was waited on and never stall. Each queue lane owns its own query range, reset by the command buffer that writes it.
+    //Every scope also opens a debug utils label so captures in external tools show the same structure
+    class GpuProfiler
+    {
+    public:
+        explicit GpuProfiler(EngineContext& engine_context);
+
+        bool init(uint32_t frame_count, uint32_t max_scopes_per_lane, uint32_t history_length);
+        void cleanup();
+
+        //After the slot was waited on: collects the results of its previous frame
+        void begin_frame(uint32_t frame);
+
+        //Resets the lane's queries in command_buffer and makes it the lane's command buffer for this frame
+        void begin_lane(VkCommandBuffer command_buffer, QueueLane lane);
+
+        //Scopes nest per command buffer. Without timestamp support only the debug labels are written
+        void begin_scope(VkCommandBuffer command_buffer, const char* name);
+        void end_scope(VkCommandBuffer command_buffer);
+
+        [[nodiscard]] bool is_supported() const { return supported; }
+
+        //Time of a scope in the last finished frame, 0 if it was not recorded
+        [[nodiscard]] float get_scope_ms(const char* name) const;
+
+        [[nodiscard]] const std::vector<GpuScopeTiming>& get_last_frame() const { return last_frame; }
+        [[nodiscard]] const std::vector<GpuScopeHistory>& get_history() const { return history; }
+        [[nodiscard]] uint32_t get_history_offset() const { return history_offset; }
+
+        //One row per retained frame, one column per scope
+        bool export_csv(const std::string& file_path) const;
+
+    private:
+        struct ScopeRecord
+        {
+            std::string name;
+            uint32_t depth = 0;
+            QueueLane lane = QueueLane::Graphics;
+            uint32_t query = 0;
+            bool closed = false;
+        };
+
+        struct LaneState
+        {
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            uint32_t first_query = 0;
+            uint32_t used_queries = 0;
+
+            //Open scopes, index into the frame's records or -1 when the lane ran out of queries
+            std::vector<int32_t> open_scopes;
+        };
+
+        struct FrameQueries
+        {
+            VkQueryPool query_pool = VK_NULL_HANDLE;
+            std::vector<ScopeRecord> records;
+            uint32_t lane_query_counts[static_cast<size_t>(QueueLane::Count)]{};
+        };
+
+        EngineContext& engine_context;
+
+        std::vector<FrameQueries> frames;
+        LaneState lanes[static_cast<size_t>(QueueLane::Count)];
+        uint32_t current_frame = 0;
+
+        uint32_t queries_per_lane = 0;
+        bool supported = false;
+        bool has_debug_labels = false;
+        float timestamp_period = 1.0f;
+        uint64_t timestamp_mask = ~0ull;
+
+        std::vector<GpuScopeTiming> last_frame;
+        std::vector<GpuScopeHistory> history;
+        uint32_t history_length = 0;
+        uint32_t history_offset = 0;
+
+        LaneState* find_lane(VkCommandBuffer command_buffer, QueueLane* out_lane = nullptr);
+
+        void read_results(uint32_t frame);
+        void push_history();
+    };
+}
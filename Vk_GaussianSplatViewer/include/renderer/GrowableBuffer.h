@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+
+#include "renderer/FrameScheduler.h"
+#include "structs/GPU_Buffer.h"
+#include "structs/UploadReport.h"
+
+struct EngineContext;
+
+namespace core::renderer
+{
+    //Device buffer of fixed size elements that grows by doubling its capacity. Growing copies the live elements on the GPU
+    //(transfer queue), so appends and sub-range updates only ever transfer the bytes they write.
+    //The buffer handle and device address change when it grows; users read them from get_buffer() every frame
+    class GrowableBuffer
+    {
+    public:
+        //Creates the memory for a capacity in bytes. Must include VK_BUFFER_USAGE_TRANSFER_SRC_BIT and TRANSFER_DST_BIT and share
+        //the buffer with the transfer family, so growing can copy out of it and uploads into it
+        using AllocateFunction = std::function<void(VkDeviceSize size, GPU_Buffer& out_buffer)>;
+
+        //Writes count elements, starting first elements into the written range, to destination
+        using ElementWriter = std::function<void(void* destination, size_t first, size_t count)>;
+
+        GrowableBuffer(EngineContext& engine_context, VkDeviceSize element_size, AllocateFunction allocate);
+
+        //Drops all elements and allocates exactly capacity elements, for data that replaces everything (a new scene)
+        void reset(size_t capacity);
+
+        //Makes room for at least capacity elements, keeping the current ones. Waits for the device to be idle when the buffer
+        //has to be reallocated, since frames in flight still read the old one. Returns false when the current elements could
+        //not be copied into the larger buffer, which then stays as it was
+        bool reserve(size_t capacity);
+
+        //Adds count elements written by writer, in place when the buffer is host visible and otherwise straight into the
+        //staging ring, one chunk of whole elements per call. Returns false (nothing added) when the buffer could not grow
+        bool append(size_t count, const ElementWriter& writer, UploadReport* report = nullptr);
+
+        //Adds count elements without writing them, for data copied in on the GPU. first is the index of the first one
+        bool append_uninitialized(size_t count, size_t& first);
+
+        //Overwrites count elements starting at first. Waits for the frames in flight, which may read the old values
+        TimelinePoint update(size_t first, const void* data, size_t count);
+
+        void destroy();
+
+        [[nodiscard]] GPU_Buffer& get_buffer() { return buffer; }
+        [[nodiscard]] const GPU_Buffer& get_buffer() const { return buffer; }
+
+        [[nodiscard]] size_t get_size() const { return size; }
+        [[nodiscard]] size_t get_capacity() const { return capacity; }
+        [[nodiscard]] VkDeviceSize get_element_size() const { return element_size; }
+
+    private:
+        EngineContext& engine_context;
+        VkDeviceSize element_size;
+        AllocateFunction allocate;
+
+        GPU_Buffer buffer;
+        size_t size = 0;
+        size_t capacity = 0;
+
+        //Mapped buffers are written directly (the range is not read by frames in flight), others through the staging ring
+        TimelinePoint write(size_t first, size_t count, const ElementWriter& writer, UploadReport* report);
+    };
+}
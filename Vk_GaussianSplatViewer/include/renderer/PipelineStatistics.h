@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct EngineContext;
+
+namespace core::renderer
+{
+    //Pipeline statistics query around the rasterized splats of a frame: vertex and fragment shader invocations and the
+    //primitives reaching the clipper. One query per frame slot, read once the slot was waited on like the GPU profiler.
+    //Requires the pipelineStatisticsQuery feature, otherwise every call is a no-op
+    class PipelineStatistics
+    {
+    public:
+        explicit PipelineStatistics(EngineContext& engine_context);
+
+        bool init(uint32_t frame_count);
+        void cleanup();
+
+        //After the slot was waited on: collects the counts of its previous frame
+        void begin_frame(uint32_t frame);
+
+        //Outside of rendering, before begin
+        void reset(VkCommandBuffer command_buffer);
+
+        //Inside the rendering scope that draws the splats
+        void begin(VkCommandBuffer command_buffer);
+        void end(VkCommandBuffer command_buffer);
+
+        [[nodiscard]] bool is_supported() const { return supported; }
+
+        //Did the last finished frame run the query? Tile compute frames do not rasterize splats
+        [[nodiscard]] bool has_results() const { return has_last_results; }
+
+        //Zero on the mesh shader path, which has no vertex stage
+        [[nodiscard]] uint64_t get_vertex_invocations() const { return vertex_invocations; }
+        [[nodiscard]] uint64_t get_clipping_primitives() const { return clipping_primitives; }
+        [[nodiscard]] uint64_t get_fragment_invocations() const { return fragment_invocations; }
+
+    private:
+        struct FrameQuery
+        {
+            VkQueryPool query_pool = VK_NULL_HANDLE;
+
+            //Was the query begun and ended in the frame last recorded into this slot?
+            bool written = false;
+        };
+
+        EngineContext& engine_context;
+
+        std::vector<FrameQuery> frames;
+        uint32_t current_frame = 0;
+        bool supported = false;
+
+        bool has_last_results = false;
+        uint64_t vertex_invocations = 0;
+        uint64_t clipping_primitives = 0;
+        uint64_t fragment_invocations = 0;
+    };
+}
@@ -1,6 +1,13 @@
 ﻿#pragma once
 
+#include <functional>
+
+#include "FrameScheduler.h"
+#include "GpuProfiler.h"
+#include "PipelineStatistics.h"
 #include "Subpass.h"
+#include "UploadManager.h"
+#include "structs/FrameReadback.h"
 #include "structs/Vk_Image.h"
 #include "GPU_BufferContainer.h"
 
@@ -29,6 +36,35 @@ namespace core::renderer
         [[nodiscard]] VkCommandPool get_command_pool() const { return command_pool; }
         [[nodiscard]] Vk_Image* get_depth_stencil_image() const { return depth_stencil_image.get(); }
 
+        //CPU time of the last frame spent blocked on its frame slot and spent recording
+        [[nodiscard]] float get_slot_wait_ms() const { return slot_wait_ms; }
+        [[nodiscard]] float get_record_ms() const { return record_ms; }
+
+        [[nodiscard]] FrameScheduler* get_frame_scheduler() const { return frame_scheduler.get(); }
+        [[nodiscard]] UploadManager* get_upload_manager() const { return upload_manager.get(); }
+
+        //Per pass and per dispatch GPU times
+        [[nodiscard]] GpuProfiler* get_gpu_profiler() const { return gpu_profiler.get(); }
+
+        //Shader invocation counts of the rasterized splats
+        [[nodiscard]] PipelineStatistics* get_pipeline_statistics() const { return pipeline_statistics.get(); }
+
+        //GPU time of the last finished frame on the compute and the graphics queue (the profiler's top level scopes)
+        [[nodiscard]] bool has_queue_timestamps() const { return gpu_profiler && gpu_profiler->is_supported(); }
+        [[nodiscard]] float get_compute_queue_ms() const { return gpu_profiler->get_scope_ms(compute_scope_name); }
+        [[nodiscard]] float get_graphics_queue_ms() const { return gpu_profiler->get_scope_ms(graphics_scope_name); }
+        [[nodiscard]] bool is_async_compute_active() const { return async_compute_active; }
+
+        //Offscreen only: receives every frame's pixels once its frame slot was waited on, from record_commands_and_draw or flush_readbacks
+        void set_readback_callback(std::function<void(const FrameReadback&)> callback) { readback_callback = std::move(callback); }
+
+        //Offscreen only: waits for the frames still in flight and hands their pixels to the callback, oldest first
+        void flush_readbacks();
+
+        //Offscreen only: tags the frames submitted from now on, handed back in FrameReadback::tag. Frames that fail to submit
+        //never reach the callback, so a tag identifies what was rendered even when frame numbers skip
+        void set_frame_tag(int64_t tag) { frame_tag = tag; }
+
         void create_command_pool();
         void reset_command_pool();
 
@@ -42,6 +78,9 @@ namespace core::renderer
 
         bool draw_frame(uint32_t image_index);
 
+        //For a frame whose image was acquired but whose work could not be submitted
+        void skip_acquired_frame(const VkSemaphoreSubmitInfo& acquire_wait);
+
         void record_subpasses(uint32_t image_index);
         void recreate_render_resources();
 
@@ -49,22 +88,56 @@ namespace core::renderer
         void cleanup();
 
     private:
+        static constexpr const char* compute_scope_name = "Compute";
+        static constexpr const char* graphics_scope_name = "Graphics";
+
         std::vector<std::unique_ptr<Subpass>> subpasses;
         std::vector<VkCommandBuffer> command_buffers;
 
         vulkanapp::SwapchainManager* swapchain_manager{};
         vulkanapp::DeviceManager* device_manager{};
 
+        //Binary semaphores are only kept for acquire/present, everything else goes through the timeline.
+        //Acquire semaphores belong to a frame slot, render finished ones to a swapchain image: the present that waits on one
+        //is only known to be done once that image is acquired again, not when the frame slot comes around
         std::vector<VkSemaphore> available_semaphores;
         std::vector<VkSemaphore> finished_semaphores;
 
-        std::vector<VkFence> in_flight_fences;
-        std::vector<VkFence> image_in_flight;
+        std::unique_ptr<FrameScheduler> frame_scheduler;
+
+        //Buffer uploads on the transfer queue
+        std::unique_ptr<UploadManager> upload_manager;
 
         EngineContext& engine_context;
 
+        //Used for one off uploads
         VkCommandPool command_pool;
 
+        //One transient pool per frame in flight, reset as a whole once its timeline value was reached
+        std::vector<VkCommandPool> frame_command_pools;
+
+        //Same for the async compute queue family. Only created when the device has one
+        std::vector<VkCommandPool> compute_command_pools;
+        std::vector<VkCommandBuffer> compute_command_buffers;
+
+        //Is the compute work of the frames currently in flight submitted to the async compute queue?
+        bool async_compute_active = false;
+
+        std::unique_ptr<GpuProfiler> gpu_profiler;
+        std::unique_ptr<PipelineStatistics> pipeline_statistics;
+
+        //Advanced every frame so VMA refreshes its heap budgets from the driver
+        uint32_t allocator_frame_index = 0;
+
+        //Offscreen only: one host visible copy of the color image per frame slot
+        std::vector<GPU_Buffer> readback_buffers;
+        std::vector<uint64_t> readback_frame_numbers;
+        std::vector<int64_t> readback_tags;
+        std::vector<bool> readback_pending;
+        uint64_t submitted_frame_count = 0;
+        int64_t frame_tag = -1;
+        std::function<void(const FrameReadback&)> readback_callback;
+
         GPU_BufferContainer* common_scene_data;
 
         //Store created Depth Stencils
@@ -74,7 +147,17 @@ namespace core::renderer
 
         size_t current_frame = 0;
 
+        float slot_wait_ms = 0.0f;
+        float record_ms = 0.0f;
+
         bool create_sync_objects();
+
+        //One per swapchain image, recreated when a new swapchain has a different image count
+        bool create_finished_semaphores();
+        void destroy_finished_semaphores();
+        void create_readback_buffers();
+        void record_readback(VkCommandBuffer command_buffer, uint32_t image_index);
+        void deliver_readback(uint32_t frame);
         void set_new_camera_aspect_ratio() const;
     };
 }
@@ -7,6 +7,7 @@
 #include "renderer/RenderPass.h"
 #include "camera/FirstPersonCamera.h"
 #include "GPU_BufferContainer.h"
+#include "structs/scene/RenderSettings.h"
 
 struct EngineContext;
 struct WindowCreateParams;
@@ -25,6 +26,9 @@ namespace core::renderer
 
         [[nodiscard]] camera::FirstPersonCamera* get_camera() const { return first_person_camera.get(); }
 
+        //Call before renderer_init to render into offscreen images of the given size instead of a window swapchain
+        void set_headless(VkExtent2D extent) { headless = true; offscreen_extent = extent; }
+
         void renderer_init();
         void renderer_update();
 
@@ -32,6 +36,8 @@ namespace core::renderer
 
         [[nodiscard]] RenderPass* get_render_pass() const { return render_pass.get(); }
 
+        [[nodiscard]] RenderSettings& get_render_settings() { return render_settings; }
+
         void create_camera_and_buffer();
 
     private:
@@ -44,10 +50,18 @@ namespace core::renderer
 
         std::unique_ptr<RenderPass> render_pass;
 
+        RenderSettings render_settings;
+
+        bool headless = false;
+        VkExtent2D offscreen_extent{};
+
+        void register_ui_actions();
+
         void init_vulkan();
 
         void create_swapchain() const;
         void create_device() const;
+        void create_shader_caches() const;
 
         void cleanup();
     };
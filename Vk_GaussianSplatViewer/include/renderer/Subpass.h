@@ -38,6 +38,19 @@ namespace core::renderer
 
         virtual void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) = 0;
 
+        //Compute work (sort, cull, SH) of the frame. Recorded for every pass before any record_commands,
+        //into the async compute command buffer when async compute is active, otherwise at the start of the graphics one
+        virtual void record_compute_commands(VkCommandBuffer* command_buffer);
+
+        //Does record_compute_commands record anything? Only those passes get a compute profiler scope
+        [[nodiscard]] virtual bool has_compute_commands() const { return false; }
+
+        //Profiler scope and debug label name
+        [[nodiscard]] virtual const char* get_name() const = 0;
+
+        //Set by the render pass for every frame
+        void set_async_compute(bool enabled) { async_compute = enabled; }
+
         void set_material(const std::shared_ptr<material::Material>& material);
 
         virtual void cleanup();
@@ -59,5 +72,23 @@ namespace core::renderer
         VkRenderingAttachmentInfoKHR depth_attachment_info;
 
         std::shared_ptr<material::Material> material_to_use;
+
+        //Is the compute work of this frame running on the async compute queue?
+        bool async_compute = false;
+
+        //Hands a buffer written by compute over to the graphics queue. Releases ownership when async compute is active.
+        //Recorded at the end of record_compute_commands
+        void release_to_graphics(VkCommandBuffer command_buffer, VkBuffer buffer, VkAccessFlags2 src_access_mask) const;
+
+        //Matching acquire at the start of record_commands. Without async compute it is a plain compute -> consumer barrier
+        void acquire_from_compute(VkCommandBuffer command_buffer, VkBuffer buffer, VkPipelineStageFlags2 dst_stage_mask, VkAccessFlags2 dst_access_mask) const;
+
+        //Copies a compute output image (written in GENERAL layout) over the swapchain image, which the geometry pass
+        //left in attachment layout and is returned to it for the ImGui pass
+        void blit_to_swapchain(VkCommandBuffer command_buffer, VkImage image, VkExtent2D extent, uint32_t image_index) const;
+
+        //Nested GPU profiler scope inside this pass, e.g. around single dispatches
+        void begin_gpu_scope(VkCommandBuffer command_buffer, const char* name) const;
+        void end_gpu_scope(VkCommandBuffer command_buffer) const;
     };
 }
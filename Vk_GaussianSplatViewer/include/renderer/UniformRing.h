@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstring>
+#include <vulkan/vulkan_core.h>
+
+#include "structs/GPU_Buffer.h"
+
+struct EngineContext;
+
+namespace core::renderer
+{
+    //Sub-allocation inside the uniform ring. Shaders reach it through address in a push constant
+    struct UniformAllocation
+    {
+        void* mapped_data = nullptr;
+        VkDeviceAddress address = 0;
+        VkDeviceSize offset = 0;
+    };
+
+    //Persistently mapped buffer split into one slot per frame in flight.
+    //A slot is only rewritten after its frame slot was waited on, so CPU writes never stall on the GPU
+    class UniformRing
+    {
+    public:
+        explicit UniformRing(EngineContext& engine_context);
+
+        bool init(uint32_t frame_count, VkDeviceSize slot_size);
+        void cleanup();
+
+        //Rewinds the slot of this frame. Everything allocated from it by the previous use is released
+        void begin_frame(uint32_t frame);
+
+        //Returns an aligned region inside the current slot (address 0 when the slot is full)
+        UniformAllocation allocate(VkDeviceSize size);
+
+        template<typename T>
+        VkDeviceAddress write(const T& data)
+        {
+            UniformAllocation allocation = allocate(sizeof(T));
+            if (allocation.mapped_data == nullptr)
+            {
+                return 0;
+            }
+
+            memcpy(allocation.mapped_data, &data, sizeof(T));
+            flush(allocation, sizeof(T));
+
+            return allocation.address;
+        }
+
+    private:
+        EngineContext& engine_context;
+
+        GPU_Buffer ring_buffer;
+
+        VkDeviceSize slot_size = 0;
+        VkDeviceSize alignment = 256;
+
+        uint32_t current_slot = 0;
+        VkDeviceSize slot_offset = 0;
+
+        //No-op on coherent memory
+        void flush(const UniformAllocation& allocation, VkDeviceSize size) const;
+    };
+}
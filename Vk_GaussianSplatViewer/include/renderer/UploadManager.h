@@ -0,0 +1,94 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "renderer/FrameScheduler.h"
+#include "structs/GPU_Buffer.h"
+
+struct EngineContext;
+
+namespace core::renderer
+{
+    //Streams host data into device buffers on the transfer queue.
+    //Data is copied into a persistently mapped staging ring in chunks; every chunk is its own submission on the
+    //transfer lane, so the CPU fills the next chunk while the previous one is copied. The host only blocks when
+    //the ring wraps onto a chunk that is still in flight, never on the graphics queue
+    class UploadManager
+    {
+    public:
+        //Writes size bytes of an upload, starting offset bytes into it, to destination
+        using ChunkWriter = std::function<void(void* destination, VkDeviceSize offset, VkDeviceSize size)>;
+
+        UploadManager(EngineContext& engine_context, FrameScheduler& frame_scheduler);
+
+        bool init(VkDeviceSize staging_size, VkDeviceSize chunk_size);
+        void cleanup();
+
+        //Copies size bytes to dst_buffer at dst_offset. The destination must be shared with the transfer family.
+        //Returns the transfer point after which the data is visible; consumers wait on it instead of the host
+        TimelinePoint upload(const void* data, VkDeviceSize size, VkBuffer dst_buffer, VkDeviceSize dst_offset = 0);
+
+        //Same, but writer produces the data straight into each staging chunk, so it never needs a host copy of the whole upload.
+        //Chunks end on multiples of granularity, e.g. the element size for a decoder that only writes whole elements
+        TimelinePoint upload(VkDeviceSize size, const ChunkWriter& writer, VkBuffer dst_buffer, VkDeviceSize dst_offset = 0,
+                             VkDeviceSize granularity = 1);
+
+        //GPU side copy from a buffer the transfer queue can already read (e.g. imported host memory), no staging
+        TimelinePoint copy(VkBuffer src_buffer, VkDeviceSize src_offset, VkBuffer dst_buffer, VkDeviceSize dst_offset, VkDeviceSize size);
+
+        //Runs release once the transfer lane reached point, e.g. to free the source of a copy
+        void release_after(TimelinePoint point, std::function<void()> release);
+
+        //Point of the most recent upload. Work that reads uploaded buffers waits on it
+        [[nodiscard]] TimelinePoint get_last_upload() const { return last_upload; }
+
+        //Bytes copied since startup and the host side throughput of the last upload call
+        [[nodiscard]] VkDeviceSize get_uploaded_bytes() const { return uploaded_bytes; }
+        [[nodiscard]] float get_last_upload_mb_per_s() const { return last_upload_mb_per_s; }
+
+        //Recycles command buffers and ring space of finished chunks and runs due releases
+        void retire_completed();
+
+    private:
+        struct InFlightChunk
+        {
+            VkDeviceSize staging_offset;
+            VkDeviceSize size;
+            TimelinePoint point;
+            VkCommandBuffer command_buffer;
+        };
+
+        struct PendingRelease
+        {
+            TimelinePoint point;
+            std::function<void()> release;
+        };
+
+        EngineContext& engine_context;
+        FrameScheduler& frame_scheduler;
+
+        GPU_Buffer staging_buffer;
+        VkDeviceSize staging_size = 0;
+        VkDeviceSize chunk_size = 0;
+        VkDeviceSize ring_head = 0;
+
+        VkCommandPool command_pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> free_command_buffers;
+        std::deque<InFlightChunk> in_flight_chunks;
+        std::deque<PendingRelease> pending_releases;
+
+        TimelinePoint last_upload{ QueueLane::Transfer, 0 };
+        VkDeviceSize uploaded_bytes = 0;
+        float last_upload_mb_per_s = 0.0f;
+
+        //Returns the ring offset of a free region of size bytes, waiting for older chunks that still use it
+        VkDeviceSize acquire_staging(VkDeviceSize size);
+        VkCommandBuffer acquire_command_buffer();
+
+        //Submits a recorded copy on the transfer lane. Returns false (and recycles the command buffer) when the submit failed
+        bool submit_copy(VkCommandBuffer command_buffer, VkDeviceSize staging_offset, VkDeviceSize staging_used);
+    };
+}
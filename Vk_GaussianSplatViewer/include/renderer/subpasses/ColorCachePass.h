@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <glm/vec3.hpp>
+
+#include "config/Config.inl"
+#include "materials/MaterialUtils.h"
+#include "renderer/Subpass.h"
+
+namespace core::renderer
+{
+    class GPU_BufferContainer;
+
+    //Evaluates the view dependent SH color of every splat into an RGBA16F cache.
+    //Only re-runs when the camera moved past a threshold, the SH degree changed or a new scene was loaded
+    class ColorCachePass : public Subpass
+    {
+    public:
+        ColorCachePass(EngineContext& engine_context, uint32_t max_frames_in_flight);
+
+        void frame_pre_recording() override;
+        void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) override;
+        void record_compute_commands(VkCommandBuffer* command_buffer) override;
+
+        [[nodiscard]] bool has_compute_commands() const override { return true; }
+        [[nodiscard]] const char* get_name() const override { return "Color cache"; }
+
+        void cleanup() override;
+
+    private:
+        GPU_BufferContainer* buffer_container;
+
+        //One specialized variant per SH degree so unused bands are compiled out, built when a degree is first used
+        material::MaterialUtils material_utils;
+
+        //State the cache was last built with
+        bool cache_valid = false;
+        glm::vec3 cached_camera_position{0.0f};
+        uint32_t cached_sh_degree = 0;
+        uint32_t cached_scene_version = 0;
+
+        bool update_this_frame = false;
+    };
+}
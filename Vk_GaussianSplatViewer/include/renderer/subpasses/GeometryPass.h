@@ -19,9 +19,24 @@ namespace core::renderer
 
         void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) override;
 
+        [[nodiscard]] const char* get_name() const override { return "Geometry"; }
+
         void cleanup() override;
 
     private:
+        //Task/mesh shader variant, only created when the device supports VK_EXT_mesh_shader
+        std::shared_ptr<material::Material> mesh_material;
+
+        void record_vertex_path(VkCommandBuffer command_buffer) const;
+        void record_mesh_path(VkCommandBuffer command_buffer) const;
+
+        //Zeroes the overdraw counters before this frame's splats count into them
+        void clear_overdraw_counts(VkCommandBuffer command_buffer) const;
+
+        //Loads a PLY or .gsvcache into the gaussian buffer, replacing the scene or appended to it.
+        //An up to date cache next to a PLY is imported instead of parsing the PLY
+        void load_splat_file(const std::string& file_path, bool append);
+
         camera::FirstPersonCamera* camera;
         VkExtent2D extents{};
         CameraData camera_data{};
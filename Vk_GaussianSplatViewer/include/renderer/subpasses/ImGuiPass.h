@@ -15,6 +15,9 @@ namespace core::renderer
         ~ImGuiPass() override;
 
         void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) override;
+
+        [[nodiscard]] const char* get_name() const override { return "ImGui"; }
+
         void cleanup() override;
 
     private:
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "renderer/Subpass.h"
+#include "structs/Vk_Image.h"
+#include "structs/scene/PushConstantBlock.h"
+
+namespace core::renderer
+{
+    class GPU_BufferContainer;
+
+    //Overdraw debug view. While it is selected the splat shaders count fragments (hardware raster) or evaluated splats
+    //(tile compute) per pixel into a counter buffer; this pass maps the counts to a heat ramp and blits it over the frame
+    class OverdrawPass : public Subpass
+    {
+    public:
+        OverdrawPass(EngineContext& engine_context, uint32_t max_frames_in_flight);
+
+        //Sizes the counter buffer and output image for the viewport and enables counting for the frame
+        void frame_pre_recording() override;
+
+        //Heatmap resolve and the blit to the swapchain
+        void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) override;
+
+        [[nodiscard]] const char* get_name() const override { return "Overdraw"; }
+
+        void cleanup() override;
+
+    private:
+        GPU_BufferContainer* buffer_container;
+
+        Vk_Image output_image{};
+        VkExtent2D output_extent{};
+
+        VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+        VkDescriptorSetLayout descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+        OverdrawPushConstantBlock push_constants{};
+
+        void create_descriptors();
+        void create_resources(VkExtent2D extent);
+        void destroy_resources();
+    };
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "materials/MaterialUtils.h"
+#include "renderer/Subpass.h"
+
+namespace core::renderer
+{
+    class GPU_BufferContainer;
+
+    //Compute stage that projects every gaussian once per frame into a compact SplatRecord
+    class PreprocessPass : public Subpass
+    {
+    public:
+        PreprocessPass(EngineContext& engine_context, uint32_t max_frames_in_flight);
+
+        //Picks the variant for the current culling and debug view settings
+        void frame_pre_recording() override;
+
+        void record_compute_commands(VkCommandBuffer* command_buffer) override;
+
+        //Only takes the records over on the graphics queue
+        void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) override;
+
+        [[nodiscard]] bool has_compute_commands() const override { return true; }
+        [[nodiscard]] const char* get_name() const override { return "Preprocess"; }
+
+        void cleanup() override;
+
+    private:
+        GPU_BufferContainer* buffer_container;
+
+        //Owns the specialized preprocess variants
+        material::MaterialUtils material_utils;
+    };
+}
@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include <array>
+#include <vector>
+
+#include "renderer/Subpass.h"
+#include "structs/GPU_Buffer.h"
+#include "structs/Vk_Image.h"
+#include "structs/scene/PushConstantBlock.h"
+
+namespace core::renderer
+{
+    class GPU_BufferContainer;
+
+    //Compute rasterizer following the original 3DGS tile renderer:
+    //splats are duplicated per 16x16 tile, radix sorted by (tile, depth), and every tile is blended
+    //front to back in one workgroup. The result is blitted to the swapchain before the ImGui pass
+    class TileRasterPass : public Subpass
+    {
+    public:
+        TileRasterPass(EngineContext& engine_context, uint32_t max_frames_in_flight);
+
+        void frame_pre_recording() override;
+
+        //Key duplication, sort and tile ranges
+        void record_compute_commands(VkCommandBuffer* command_buffer) override;
+
+        //Tile blending and the blit to the swapchain
+        void record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last) override;
+
+        [[nodiscard]] bool has_compute_commands() const override { return true; }
+        [[nodiscard]] const char* get_name() const override { return "Tile raster"; }
+
+        void cleanup() override;
+
+    private:
+        GPU_BufferContainer* buffer_container;
+
+        std::shared_ptr<material::Material> duplicate_material;
+        std::shared_ptr<material::Material> sort_args_material;
+        std::shared_ptr<material::Material> histogram_material;
+        std::shared_ptr<material::Material> scan_material;
+        std::shared_ptr<material::Material> scatter_material;
+        std::shared_ptr<material::Material> ranges_material;
+
+        //Output image written by the tile blend kernel
+        Vk_Image output_image{};
+        VkExtent2D output_extent{};
+
+        VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+        VkDescriptorSetLayout descriptor_set_layout = VK_NULL_HANDLE;
+        VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+        //Outputs of the sort that the blend kernel reads on the graphics queue.
+        //One set per frame in flight so the next frame can be sorted while this one is blended
+        struct FrameSortBuffers
+        {
+            GPU_Buffer sorted_value_buffer;
+            GPU_Buffer tile_range_buffer;
+        };
+
+        std::vector<FrameSortBuffers> frame_sort_buffers;
+
+        //Scratch buffers only touched by compute, bound into the shared compute scratch memory of the buffer container.
+        //Keys and values are ping-ponged between the radix passes, the sorted values end up in the frame's sorted_value_buffer
+        GPU_Buffer sort_state_buffer;
+        std::array<GPU_Buffer, 2> key_buffers;
+        GPU_Buffer value_scratch_buffer;
+        GPU_Buffer histogram_buffer;
+
+        //compute_scratch_version the scratch buffers were bound at
+        uint32_t scratch_version = 0;
+
+        uint32_t key_capacity = 0;
+        uint32_t allocated_gaussian_capacity = 0;
+        uint32_t tile_count_x = 0;
+        uint32_t tile_count_y = 0;
+        uint32_t tile_bits = 1;
+
+        TileRasterPushConstantBlock push_constants{};
+
+        void create_descriptors();
+        void create_output_image(VkExtent2D extent);
+        void destroy_output_image();
+
+        void allocate_sort_buffers(uint32_t gaussian_capacity);
+        void destroy_sort_buffers();
+
+        //(Re)binds the scratch buffers into the compute scratch, growing it when needed
+        void bind_sort_scratch();
+        void destroy_sort_scratch();
+
+        void allocate_tile_range_buffers();
+        void destroy_tile_range_buffers();
+
+        //Value buffer of a radix ping-pong slot for the given frame
+        [[nodiscard]] const GPU_Buffer& get_value_buffer(uint32_t slot) const;
+
+        void dispatch(VkCommandBuffer command_buffer, const material::Material& material, uint32_t group_count_x, uint32_t group_count_y = 1) const;
+        void dispatch_indirect(VkCommandBuffer command_buffer, const material::Material& material, VkDeviceSize offset) const;
+        void compute_barrier(VkCommandBuffer command_buffer) const;
+    };
+}
@@ -10,6 +10,8 @@
 #include "renderer/Renderer.h"
 #include "vulkanapp/DeviceManager.h"
 #include "renderer/GPU_BufferContainer.h"
+#include "materials/PipelineCache.h"
+#include "materials/ShaderBinaryCache.h"
 
 struct EngineContext
 {
@@ -18,6 +20,10 @@ struct EngineContext
     std::unique_ptr<vulkanapp::SwapchainManager> swapchain_manager;
     std::unique_ptr<core::renderer::Renderer> renderer;
 
+    //Compiled shaders kept across launches; only the one matching the material backend exists
+    std::unique_ptr<material::ShaderBinaryCache> shader_binary_cache;
+    std::unique_ptr<material::PipelineCache> pipeline_cache;
+
     std::unique_ptr<core::renderer::GPU_BufferContainer> buffer_container;
 
     std::unique_ptr<input::InputManager> input_manager;
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+//Pixels of a finished offscreen frame. Only valid during the readback callback, copy them to keep them
+struct FrameReadback
+{
+    //Counts submitted frames from 0, in submission order
+    uint64_t frame_number = 0;
+
+    //RenderPass::set_frame_tag value the frame was submitted with, -1 when none was set
+    int64_t tag = -1;
+
+    VkExtent2D extent{};
+    VkFormat format = VK_FORMAT_UNDEFINED;
+
+    //Tightly packed rows, top row first
+    const uint8_t* pixels = nullptr;
+    VkDeviceSize size = 0;
+};
@@ -8,4 +8,8 @@ struct GPU_Buffer
     VmaAllocation allocation = VK_NULL_HANDLE;
     VmaAllocationInfo allocation_info{};
     VkDeviceAddress buffer_address{};
+
+    //Creation parameters, kept so defragmentation can recreate the buffer where its memory moved to
+    VkDeviceSize size = 0;
+    VkBufferUsageFlags usage = 0;
 };
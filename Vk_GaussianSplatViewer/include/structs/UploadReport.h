@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+//Route the data took into device memory
+enum class UploadPath : uint8_t
+{
+    //Copied into the staging ring, then by the transfer queue
+    Staging,
+
+    //Written straight into host visible device memory (resizable BAR / UMA)
+    Direct,
+
+    //Mapped file imported as host memory (VK_EXT_external_memory_host) and copied by the transfer queue, no host copy at all
+    HostImport
+};
+
+//How data reached a device local buffer and how fast the host side of it was
+struct UploadReport
+{
+    UploadPath path = UploadPath::Staging;
+
+    VkDeviceSize bytes = 0;
+
+    //Host time spent producing and writing the data, including decoding when the loader writes in place
+    float milliseconds = 0.0f;
+    float megabytes_per_second = 0.0f;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+//Compact screen space splat written by the preprocess compute pass (32 bytes).
+//Half precision values are packed two per uint (packHalf2x16)
+struct SplatRecord
+{
+    float center[2];           // screen position in pixels
+    float depth;               // view space depth, 0 when the splat was culled
+
+    uint32_t conic_xy;         // inverse 2D covariance (a, b)
+    uint32_t conic_z_radius;   // inverse 2D covariance (c), radius in pixels
+
+    uint32_t color_rg;
+    uint32_t color_ba;         // b, opacity
+
+    uint32_t splat_index;      // index into the source GaussianSurface buffer
+};
+
+static_assert(sizeof(SplatRecord) == 32, "SplatRecord must match the GLSL layout");
+
+struct SplatRecordDescriptor
+{
+    static VkVertexInputBindingDescription2EXT get_binding_description()
+    {
+        VkVertexInputBindingDescription2EXT binding_description{};
+        binding_description.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT;
+        binding_description.pNext = nullptr;
+        binding_description.binding = 0;
+        binding_description.stride = sizeof(SplatRecord);
+        binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        binding_description.divisor = 1;
+
+        return binding_description;
+    }
+
+    static std::array<VkVertexInputAttributeDescription2EXT, 6> get_attribute_descriptions()
+    {
+        std::array<VkVertexInputAttributeDescription2EXT, 6> attributes{};
+
+        // center (vec2)
+        attributes[0].sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        attributes[0].pNext = nullptr;
+        attributes[0].location = 0;
+        attributes[0].binding = 0;
+        attributes[0].format = VK_FORMAT_R32G32_SFLOAT;
+        attributes[0].offset = offsetof(SplatRecord, center);
+
+        // depth (float)
+        attributes[1].sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        attributes[1].pNext = nullptr;
+        attributes[1].location = 1;
+        attributes[1].binding = 0;
+        attributes[1].format = VK_FORMAT_R32_SFLOAT;
+        attributes[1].offset = offsetof(SplatRecord, depth);
+
+        // conic_xy (uint)
+        attributes[2].sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        attributes[2].pNext = nullptr;
+        attributes[2].location = 2;
+        attributes[2].binding = 0;
+        attributes[2].format = VK_FORMAT_R32_UINT;
+        attributes[2].offset = offsetof(SplatRecord, conic_xy);
+
+        // conic_z_radius (uint)
+        attributes[3].sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        attributes[3].pNext = nullptr;
+        attributes[3].location = 3;
+        attributes[3].binding = 0;
+        attributes[3].format = VK_FORMAT_R32_UINT;
+        attributes[3].offset = offsetof(SplatRecord, conic_z_radius);
+
+        // color_rg (uint)
+        attributes[4].sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        attributes[4].pNext = nullptr;
+        attributes[4].location = 4;
+        attributes[4].binding = 0;
+        attributes[4].format = VK_FORMAT_R32_UINT;
+        attributes[4].offset = offsetof(SplatRecord, color_rg);
+
+        // color_ba (uint)
+        attributes[5].sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        attributes[5].pNext = nullptr;
+        attributes[5].location = 5;
+        attributes[5].binding = 0;
+        attributes[5].format = VK_FORMAT_R32_UINT;
+        attributes[5].offset = offsetof(SplatRecord, color_ba);
+
+        return attributes;
+    }
+};
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 struct CameraData
 {
     glm::mat4 projection;
     glm::mat4 view;
+
+    //xyz = world space camera position
+    glm::vec4 position;
+
+    //xy = viewport size in pixels, zw = focal length in pixels
+    glm::vec4 viewport;
+
+    //Per pixel counters of the overdraw view, only valid when overdraw_enabled is set
+    uint64_t overdraw_address;
+    uint32_t overdraw_enabled;
+    uint32_t padding;
 };
\ No newline at end of file
@@ -5,4 +5,60 @@
 struct PushConstantBlock
 {
     VkDeviceAddress scene_buffer_address;
+};
+
+//Push constants for the splat preprocess compute pass
+struct PreprocessPushConstantBlock
+{
+    VkDeviceAddress camera_data_address;
+    VkDeviceAddress gaussian_buffer_address;
+    VkDeviceAddress splat_record_address;
+    VkDeviceAddress color_cache_address;
+    uint32_t gaussian_count;
+};
+
+//Push constants for the view dependent color cache pass
+struct ColorCachePushConstantBlock
+{
+    VkDeviceAddress camera_data_address;
+    VkDeviceAddress gaussian_buffer_address;
+    VkDeviceAddress color_cache_address;
+    uint32_t gaussian_count;
+};
+
+//Push constants for the task/mesh splat path
+struct MeshPushConstantBlock
+{
+    VkDeviceAddress camera_data_address;
+    VkDeviceAddress splat_record_address;
+    uint32_t gaussian_count;
+};
+
+//Push constants shared by every kernel of the tile compute rasterizer
+struct TileRasterPushConstantBlock
+{
+    VkDeviceAddress camera_data_address;
+    VkDeviceAddress splat_record_address;
+    VkDeviceAddress sort_state_address;
+    VkDeviceAddress keys_in_address;
+    VkDeviceAddress values_in_address;
+    VkDeviceAddress keys_out_address;
+    VkDeviceAddress values_out_address;
+    VkDeviceAddress histogram_address;
+    VkDeviceAddress tile_range_address;
+    uint32_t gaussian_count;
+    uint32_t key_capacity;
+    uint32_t tile_count_x;
+    uint32_t tile_count_y;
+    uint32_t tile_bits;
+    uint32_t radix_shift;
+};
+
+//Push constants for the overdraw heatmap resolve
+struct OverdrawPushConstantBlock
+{
+    VkDeviceAddress counts_address;
+    uint32_t width;
+    uint32_t height;
+    uint32_t max_overdraw;
 };
\ No newline at end of file
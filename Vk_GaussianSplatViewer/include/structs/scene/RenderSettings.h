@@ -0,0 +1,36 @@
+#pragma once
+
+#include "enums/DebugView.h"
+#include "enums/RenderMode.h"
+
+//Renderer options that can be changed at runtime from the UI
+struct RenderSettings
+{
+    RenderMode render_mode = RenderMode::HardwareRaster;
+
+    //Hardware raster only: expand splats with task/mesh shaders when the device supports them
+    bool use_mesh_shaders = true;
+
+    //Spherical harmonics degree used for view dependent color (0 = diffuse only, 3 = full)
+    uint32_t sh_degree = 3;
+
+    //Reuse the per-splat SH colors until the camera moved further than the threshold (world units)
+    bool cache_view_colors = true;
+    float color_cache_threshold = 0.05f;
+
+    //Run sort, cull and SH work on the async compute queue when the device has a separate compute family
+    bool use_async_compute = true;
+
+    //Drop splats outside the guard band before rasterization. Off keeps every splat in front of the near plane
+    bool frustum_culling = true;
+
+    //Replace splat colors with a debug quantity
+    DebugView debug_view = DebugView::None;
+
+    //Overdraw view: fragments per pixel at the top of the heat ramp
+    uint32_t overdraw_scale = 64;
+
+    //Write a binary .gsvcache of every PLY loaded from now on into the per user cache directory, so later loads map it
+    //instead of parsing. Off by default since it costs a second decode and as much disk space as the scene
+    bool write_splat_cache = false;
+};
@@ -16,7 +16,8 @@ namespace vulkanapp
         DeviceManager(EngineContext& engine_context);
         ~DeviceManager();
         
-        bool device_init();
+        //Headless skips the surface and all presentation requirements, so any ICD (lavapipe included) qualifies
+        bool device_init(bool headless = false);
         bool init_queues();
         void cleanup();
         
@@ -29,9 +30,40 @@ namespace vulkanapp
         VkQueue compute_queue;
         VkQueue graphics_queue;
         VkQueue present_queue;
+        VkQueue transfer_queue;
 
         VmaAllocator vma_allocator;
 
+        //Long lived splat buffers and transient compute scratch get their own blocks, so scratch that is
+        //reallocated with the scene or the window size does not fragment the splat memory
+        VmaPool splat_pool = VK_NULL_HANDLE;
+        VmaPool scratch_pool = VK_NULL_HANDLE;
+
+        bool headless = false;
+
+        uint32_t graphics_queue_family = 0;
+        uint32_t compute_queue_family = 0;
+        uint32_t transfer_queue_family = 0;
+
+        //Were VK_EXT_mesh_shader and its task/mesh features enabled on the device?
+        bool mesh_shader_supported = false;
+
+        //Was VK_EXT_shader_object enabled? Materials use the VkPipeline backend otherwise
+        bool shader_object_supported = false;
+
+        //Does the device expose a compute queue family separate from graphics?
+        bool async_compute_supported = false;
+
+        //Was VK_EXT_external_memory_host enabled, and how must imported host pointers be aligned?
+        bool external_memory_host_supported = false;
+        VkDeviceSize min_imported_host_pointer_alignment = 0;
+
+        //Was pipelineStatisticsQuery enabled? Only the UI statistics depend on it
+        bool pipeline_statistics_query_supported = false;
+
+        //Was VK_EXT_memory_budget enabled? VMA only queries real budgets with it
+        bool memory_budget_supported = false;
+
         EngineContext& engine_context;
         
     public:
@@ -42,9 +74,34 @@ namespace vulkanapp
         [[nodiscard]] VkQueue get_graphics_queue() const { return graphics_queue; }
         [[nodiscard]] VkQueue get_present_queue() const { return present_queue; }
         [[nodiscard]] VkQueue get_compute_queue() const { return compute_queue; }
+        [[nodiscard]] VkQueue get_transfer_queue() const { return transfer_queue; }
         [[nodiscard]] VmaAllocator get_allocator() const { return vma_allocator; }
+        [[nodiscard]] bool is_headless() const { return headless; }
+        [[nodiscard]] bool is_mesh_shader_supported() const { return mesh_shader_supported; }
+        [[nodiscard]] bool is_async_compute_supported() const { return async_compute_supported; }
+        [[nodiscard]] bool is_shader_object_supported() const { return shader_object_supported; }
+        [[nodiscard]] bool is_external_memory_host_supported() const { return external_memory_host_supported; }
+        [[nodiscard]] VkDeviceSize get_min_imported_host_pointer_alignment() const { return min_imported_host_pointer_alignment; }
+        [[nodiscard]] bool is_pipeline_statistics_query_supported() const { return pipeline_statistics_query_supported; }
+        [[nodiscard]] bool is_memory_budget_supported() const { return memory_budget_supported; }
+        [[nodiscard]] uint32_t get_graphics_queue_family() const { return graphics_queue_family; }
+        [[nodiscard]] uint32_t get_compute_queue_family() const { return compute_queue_family; }
+        [[nodiscard]] uint32_t get_transfer_queue_family() const { return transfer_queue_family; }
+
+        //Valid bits of timestamps written on queues of this family, 0 if timestamps are not supported there
+        [[nodiscard]] uint32_t get_timestamp_valid_bits(uint32_t queue_family) const;
+
+        //Families a long lived buffer must be shared with (CONCURRENT): graphics, async compute and the upload queue.
+        //Empty when only one family is in use
+        [[nodiscard]] std::vector<uint32_t> get_shared_queue_families() const;
 
         void set_vma_allocator(VmaAllocator allocator) { vma_allocator = allocator; }
+
+        //Null when the pools could not be created, allocations then go to VMA's default pools
+        [[nodiscard]] VmaPool get_splat_pool() const { return splat_pool; }
+        [[nodiscard]] VmaPool get_scratch_pool() const { return scratch_pool; }
+
+        void set_memory_pools(VmaPool p_splat_pool, VmaPool p_scratch_pool) { splat_pool = p_splat_pool; scratch_pool = p_scratch_pool; }
     };
 }
 
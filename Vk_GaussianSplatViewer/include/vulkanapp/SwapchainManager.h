@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <VkBootstrap.h>
+#include <vma/vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 #include <vector>
 
@@ -21,6 +22,9 @@ namespace vulkanapp
     {
         VkImage image;
         VkImageView image_view;
+
+        //Only set for offscreen images, swapchain images belong to the swapchain
+        VmaAllocation allocation = VK_NULL_HANDLE;
     };
 
     class SwapchainManager
@@ -32,6 +36,9 @@ namespace vulkanapp
 
         void initialize(VkPhysicalDevice physical_device, VkDevice device, VkSurfaceKHR surface, uint32_t p_max_image_count, uint32_t window_width, uint32_t window_height);
 
+        //Headless: no surface or VkSwapchainKHR, the passes draw into image_count VMA images that can be copied out
+        void initialize_offscreen(VkDevice device, VmaAllocator allocator, uint32_t image_count, VkExtent2D extent, VkFormat format);
+
         bool create_swapchain(uint32_t window_width, uint32_t window_height);
 
         bool recreate_swapchain(uint32_t window_width, uint32_t window_height);
@@ -45,6 +52,9 @@ namespace vulkanapp
         [[nodiscard]] const std::vector<SwapchainImage>& get_images() const { return m_images; }
         [[nodiscard]] uint32_t get_image_count() const { return static_cast<uint32_t>(m_images.size()); }
 
+        //Are the images offscreen targets? Nothing is acquired or presented then
+        [[nodiscard]] bool is_offscreen() const { return m_allocator != VK_NULL_HANDLE; }
+
 
     private:
         [[nodiscard]] VkSurfaceFormatKHR select_surface_format(const std::vector<VkSurfaceFormatKHR>& available_formats) const;
@@ -58,6 +68,8 @@ namespace vulkanapp
 
         bool create_image_views();
 
+        bool create_offscreen_images(uint32_t image_count);
+
         void destroy_image_views();
 
         void destroy_swapchain();
@@ -74,6 +86,9 @@ namespace vulkanapp
         VkFormat m_image_format = VK_FORMAT_UNDEFINED;
         VkExtent2D m_extent = {0, 0};
 
+        //Owner of the offscreen images, null for a real swapchain
+        VmaAllocator m_allocator = VK_NULL_HANDLE;
+
         uint32_t max_image_count;
 
         EngineContext& engine_context;
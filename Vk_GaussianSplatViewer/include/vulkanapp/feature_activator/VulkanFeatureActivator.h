@@ -13,5 +13,7 @@ namespace vulkanapp
         static VkPhysicalDeviceDescriptorIndexingFeatures create_physical_device_descriptor_indexing_features();
         static VkPhysicalDeviceSynchronization2Features create_synchronization2_features();
         static VkPhysicalDeviceVertexInputDynamicStateFeaturesEXT create_vertex_input_dynamic_state_features();
+        static VkPhysicalDeviceMeshShaderFeaturesEXT create_mesh_shader_features();
+        static VkPhysicalDeviceTimelineSemaphoreFeatures create_timeline_semaphore_features();
     };
 }
\ No newline at end of file
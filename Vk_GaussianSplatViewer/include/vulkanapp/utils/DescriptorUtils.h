@@ -84,6 +84,23 @@ namespace utils
             return write_descriptor_set;
         }
 
+        static VkWriteDescriptorSet write_descriptor_set(
+                VkDescriptorSet dst_set,
+                VkDescriptorType type,
+                uint32_t binding,
+                VkDescriptorImageInfo* image_info,
+                uint32_t descriptor_count = 1)
+        {
+            VkWriteDescriptorSet write_descriptor_set{};
+            write_descriptor_set.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write_descriptor_set.dstSet = dst_set;
+            write_descriptor_set.descriptorType = type;
+            write_descriptor_set.dstBinding = binding;
+            write_descriptor_set.pImageInfo = image_info;
+            write_descriptor_set.descriptorCount = descriptor_count;
+            return write_descriptor_set;
+        }
+
         static VkDescriptorPoolCreateInfo descriptor_pool_create_info(
                 const std::vector<VkDescriptorPoolSize>& pool_sizes,
                 uint32_t max_sets)
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+
+#include "enums/MemoryCategory.h"
+
+namespace utils
+{
+    //One memory heap against the budget VK_EXT_memory_budget reports for this process
+    struct HeapBudget
+    {
+        uint32_t heap_index = 0;
+        bool device_local = false;
+
+        //Bytes used by this process (all allocators, including memory VMA does not own) and the OS provided budget
+        VkDeviceSize usage = 0;
+        VkDeviceSize budget = 0;
+
+        //VMA blocks in this heap and the part of them handed out as allocations
+        VkDeviceSize block_bytes = 0;
+        VkDeviceSize allocation_bytes = 0;
+    };
+
+    //Live bytes per MemoryCategory. The category is stored in the allocation's user data when it is created,
+    //so freeing only needs the allocation. Counters are process wide like the allocator, updates are lock free
+    class MemoryTracker
+    {
+    public:
+        //Tags a new allocation and names it after its category for VMA stats dumps
+        static void track(VmaAllocator allocator, VmaAllocation allocation, MemoryCategory category);
+
+        //Before the allocation is freed. Untracked allocations are ignored
+        static void release(VmaAllocator allocator, VmaAllocation allocation);
+
+        [[nodiscard]] static VkDeviceSize get_category_bytes(MemoryCategory category);
+        [[nodiscard]] static uint32_t get_category_allocations(MemoryCategory category);
+        [[nodiscard]] static const char* get_category_name(MemoryCategory category);
+
+        [[nodiscard]] static std::vector<HeapBudget> get_heap_budgets(VmaAllocator allocator);
+
+        //Can a device local heap take size more bytes and stay below memory_budget_limit of its budget?
+        //out_available receives the most any single device local heap can still take
+        [[nodiscard]] static bool fits_device_local_budget(VmaAllocator allocator, VkDeviceSize size, VkDeviceSize* out_available = nullptr);
+
+        //Prints a warning when a device local heap crosses memory_budget_warning of its budget, once per crossing
+        static void check_budget(VmaAllocator allocator);
+    };
+}
@@ -1,7 +1,12 @@
 #pragma once
+#include <functional>
 #include <vector>
 
 #include "VkBootstrapDispatch.h"
+#include "enums/MemoryCategory.h"
+#include "renderer/FrameScheduler.h"
+#include "renderer/UploadManager.h"
+#include "structs/UploadReport.h"
 #include "structs/Vk_Image.h"
 #include "vulkanapp/DeviceManager.h"
 
@@ -22,29 +27,76 @@ namespace utils
     public: 
         static void create_vma_allocator(vulkanapp::DeviceManager& device_manager);
 
+        //Splat pool: device local memory, host visible too when all of VRAM is (resizable BAR, UMA).
+        //Scratch pool: plain device local memory for transient compute buffers
+        static void create_memory_pools(vulkanapp::DeviceManager& device_manager);
+
+        //More than one queue family makes the buffer VK_SHARING_MODE_CONCURRENT between them.
+        //The allocation is counted under category by the MemoryTracker until destroy_buffer.
+        //With a pool the memory type is the pool's, memory_usage is ignored
         static void create_buffer(vkb::DispatchTable dispatch_table, VmaAllocator allocator, VkDeviceSize size, VkBufferUsageFlags usage,
-                                    VmaMemoryUsage memory_usage, VmaAllocationCreateFlags vmaAllocationFlags, GPU_Buffer& out_buffer);
+                                    VmaMemoryUsage memory_usage, VmaAllocationCreateFlags vmaAllocationFlags, MemoryCategory category,
+                                    GPU_Buffer& out_buffer, const std::vector<uint32_t>& queue_families = {}, VmaPool pool = VK_NULL_HANDLE);
+
+        //Exclusive buffer bound to [offset, offset + size) of memory's allocation. It owns no memory of its own:
+        //destroy it before memory is freed. offset must be a multiple of get_buffer_alignment for usage
+        static void create_aliasing_buffer(const vkb::DispatchTable& dispatch_table, VmaAllocator allocator, const GPU_Buffer& memory,
+                                           VkDeviceSize offset, VkDeviceSize size, VkBufferUsageFlags usage, GPU_Buffer& out_buffer);
+
+        //Memory offset alignment buffers with usage require on this device
+        static VkDeviceSize get_buffer_alignment(const vkb::DispatchTable& dispatch_table, VkBufferUsageFlags usage);
+
+        //Compacts pool by moving the given buffers and keeps their contents (a GPU copy on the transfer queue).
+        //Allocations of the pool that are not in buffers stay where they are. Waits for the device to be idle first,
+        //the moved buffers get new handles and device addresses. The buffers must be shared with the transfer family and have
+        //TRANSFER_SRC and TRANSFER_DST usage, others are left in place
+        static void defragment_pool(EngineContext& engine_context, VmaPool pool, const std::vector<GPU_Buffer*>& buffers);
 
         static VkResult map_persistent_data(VmaAllocator vmaAllocator, VmaAllocation allocation, const VmaAllocationInfo& allocationInfo, const void* data, VkDeviceSize bufferSize, size_t offset_in_buffer = 0);
 
         static VkDeviceAddress get_buffer_device_address(const vkb::DispatchTable& disp, VkBuffer buffer);
 
-        static void copy_buffer(vkb::DispatchTable disp, VkQueue queue, VkCommandPool command_pool, VkBuffer srcBuffer, VkBuffer dst_buffer, VkDeviceSize size);
+        //Device local buffer that is also mapped when the device has host visible VRAM (resizable BAR, UMA).
+        //VMA falls back to plain device local memory otherwise; allocation_info.pMappedData tells which one it got
+        static void create_device_buffer_prefer_mapped(EngineContext& engine_context, VkDeviceSize size, VkBufferUsageFlags usage,
+                                                       MemoryCategory category, GPU_Buffer& out_buffer);
+
+        //Copies data into a buffer from create_device_buffer_prefer_mapped: memcpy when it is mapped, the staging ring otherwise.
+        //Returns the transfer point to wait on (value 0 for the direct path)
+        static core::renderer::TimelinePoint write_device_buffer(EngineContext& engine_context, const GPU_Buffer& buffer,
+                                                                 const void* data, VkDeviceSize size, UploadReport* report = nullptr);
+
+        //Same for the size bytes at offset, the rest of the buffer is left alone
+        static core::renderer::TimelinePoint write_device_buffer_range(EngineContext& engine_context, const GPU_Buffer& buffer, VkDeviceSize offset,
+                                                                       const void* data, VkDeviceSize size, UploadReport* report = nullptr);
+
+        //Same, but lets writer produce the data in place: in one call straight into VRAM when the buffer is mapped, otherwise
+        //chunk by chunk into the staging ring. Chunks end on multiples of granularity
+        static core::renderer::TimelinePoint write_device_buffer_range(EngineContext& engine_context, const GPU_Buffer& buffer, VkDeviceSize offset,
+                                                                       VkDeviceSize size, VkDeviceSize granularity,
+                                                                       const core::renderer::UploadManager::ChunkWriter& writer,
+                                                                       UploadReport* report = nullptr);
 
+        //Wraps host memory in a transfer source buffer without copying it (VK_EXT_external_memory_host).
+        //host_pointer and size must be multiples of the device's import alignment, and the memory must outlive every copy that reads it
+        static bool import_host_memory(EngineContext& engine_context, void* host_pointer, VkDeviceSize size,
+                                       VkBuffer& out_buffer, VkDeviceMemory& out_memory);
+
+        //Device local buffers filled directly when mapped, otherwise through the upload manager on the transfer queue.
+        //The returned point must be waited on before the buffer is read; the source vector can be freed right away
         template <class V>
-        static void create_vertex_buffer_with_staging(EngineContext& engine_context, const std::vector<V>& vertices,
-                                                      VkCommandPool command_pool, GPU_Buffer& out_vertex_buffer);
+        static core::renderer::TimelinePoint create_vertex_buffer_with_staging(EngineContext& engine_context, const std::vector<V>& vertices,
+                                                                               GPU_Buffer& out_vertex_buffer, UploadReport* report = nullptr);
         template <class V>
-        static void create_index_buffer_with_staging(EngineContext& engine_context,
-                                                     const std::vector<uint32_t>& indices,
-                                                     VkCommandPool command_pool, GPU_Buffer& out_index_buffer);
+        static core::renderer::TimelinePoint create_index_buffer_with_staging(EngineContext& engine_context,
+                                                                              const std::vector<uint32_t>& indices,
+                                                                              GPU_Buffer& out_index_buffer);
 
         template<typename V>
-        static void create_vertex_and_index_buffers(EngineContext& engine_context,
-                                                   const std::vector<V>& vertices,
-                                                   const std::vector<uint32_t>& indices,
-                                                   VkCommandPool command_pool,
-                                                   GPU_Buffer& out_vertex_buffer, GPU_Buffer& out_index_buffer);
+        static core::renderer::TimelinePoint create_vertex_and_index_buffers(EngineContext& engine_context,
+                                                                             const std::vector<V>& vertices,
+                                                                             const std::vector<uint32_t>& indices,
+                                                                             GPU_Buffer& out_vertex_buffer, GPU_Buffer& out_index_buffer);
 
         template<typename T>
         static void map_ubo(const EngineContext& engine_context, GPU_Buffer buffer, T ubo_data)
@@ -62,5 +114,28 @@ namespace utils
         static void allocate_buffer_with_random_access(const vkb::DispatchTable& dispatch_table, VmaAllocator allocator, VkDeviceSize size, GPU_Buffer& buffer);
 
         static void destroy_buffer(VmaAllocator allocator, GPU_Buffer& buffer);
+
+        //Image counterpart of destroy_buffer for images created through VMA, the view is destroyed as well
+        static void destroy_image(const vkb::DispatchTable& disp, VmaAllocator allocator, Vk_Image& image);
+
+        //Records a synchronization2 barrier covering the whole buffer
+        static void buffer_memory_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer, VkBuffer buffer,
+                                          VkPipelineStageFlags2 src_stage_mask, VkPipelineStageFlags2 dst_stage_mask,
+                                          VkAccessFlags2 src_access_mask, VkAccessFlags2 dst_access_mask);
+
+        //Release half of a queue family ownership transfer, recorded on the source queue
+        static void queue_release_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer, VkBuffer buffer,
+                                          VkPipelineStageFlags2 src_stage_mask, VkAccessFlags2 src_access_mask,
+                                          uint32_t src_queue_family, uint32_t dst_queue_family);
+
+        //Acquire half of a queue family ownership transfer, recorded on the destination queue
+        static void queue_acquire_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer, VkBuffer buffer,
+                                          VkPipelineStageFlags2 dst_stage_mask, VkAccessFlags2 dst_access_mask,
+                                          uint32_t src_queue_family, uint32_t dst_queue_family);
+
+        //Records a global synchronization2 memory barrier (used between chained compute dispatches)
+        static void memory_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer,
+                                   VkPipelineStageFlags2 src_stage_mask, VkPipelineStageFlags2 dst_stage_mask,
+                                   VkAccessFlags2 src_access_mask, VkAccessFlags2 dst_access_mask);
     };
 }
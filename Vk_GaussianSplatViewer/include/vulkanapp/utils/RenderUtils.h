@@ -2,6 +2,7 @@
 #include <vector>
 #include <vma/vk_mem_alloc.h>
 #include <vulkan/vulkan_core.h>
+#include "enums/MemoryCategory.h"
 #include "structs/Vk_Image.h"
 
 struct EngineContext;
@@ -12,7 +13,10 @@ namespace utils
     class RenderUtils
     {
     public:
-        static bool create_command_pool(const EngineContext& engine_context, VkCommandPool& out_command_pool);
+        static bool create_command_pool(const EngineContext& engine_context, VkCommandPool& out_command_pool,
+                                        VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        static bool create_command_pool(const EngineContext& engine_context, VkCommandPool& out_command_pool,
+                                        VkCommandPoolCreateFlags flags, uint32_t queue_family_index);
 
         static bool allocate_command_buffers(const EngineContext& render_context, VkCommandPool command_pool, std::vector<VkCommandBuffer>& command_buffers);
 
@@ -22,6 +26,10 @@ namespace utils
 
         static bool create_depth_stencil_image(const EngineContext& engine_context, VkExtent2D extents, VmaAllocator allocator, Vk_Image& depth_image);
 
+        //Device local image that compute shaders write through imageStore. It can also be used as a blit source
+        static bool create_storage_image(const EngineContext& engine_context, VkExtent2D extents, VkFormat format, VmaAllocator allocator,
+                                         MemoryCategory category, Vk_Image& storage_image);
+
         static VkRenderingInfoKHR rendering_info(VkRect2D render_area = {},
                                       uint32_t color_attachment_count = 0,
                                       const VkRenderingAttachmentInfoKHR *pColorAttachments = VK_NULL_HANDLE,
@@ -0,0 +1,21 @@
+#ifndef COMMON_CAMERA_GLSL
+#define COMMON_CAMERA_GLSL
+
+//One counter per pixel, row major. Written by the splat shaders while the overdraw view is active
+layout(buffer_reference, std430) buffer OverdrawCounts
+{
+	uint counts[];
+};
+
+//Mirrors structs/scene/CameraData.h
+layout(buffer_reference, std430) readonly buffer CameraData
+{
+	mat4 projection;
+	mat4 view;
+	vec4 position;	//xyz world space camera position
+	vec4 viewport;	//xy viewport size in pixels, zw focal length in pixels
+	OverdrawCounts overdraw_address;
+	uint overdraw_enabled;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef COMMON_GAUSSIAN_GLSL
+#define COMMON_GAUSSIAN_GLSL
+
+//Mirrors structs/geometry/GaussianSurface.h (248 bytes, tightly packed)
+struct GaussianSurface
+{
+	vec3 position;
+	vec3 normal;
+	vec3 f_dc;
+	float f_rest[45];
+	float opacity;
+	vec3 scale;
+	vec4 rotation;	//w, x, y, z
+};
+
+layout(buffer_reference, scalar) readonly buffer GaussianSurfaces
+{
+	GaussianSurface surfaces[];
+};
+
+//Mirrors structs/geometry/SplatRecord.h (32 bytes)
+struct SplatRecord
+{
+	vec2 center;		//screen position in pixels
+	float depth;		//view space depth, 0 when culled
+	uint conic_xy;		//packHalf2x16(conic.x, conic.y)
+	uint conic_z_radius;	//packHalf2x16(conic.z, radius)
+	uint color_rg;
+	uint color_ba;		//packHalf2x16(b, opacity)
+	uint splat_index;
+};
+
+layout(buffer_reference, scalar) buffer SplatRecords
+{
+	SplatRecord records[];
+};
+
+//Per splat view dependent color written by the color cache pass: packHalf2x16(r, g), packHalf2x16(b, opacity)
+layout(buffer_reference, scalar) buffer ColorCache
+{
+	uvec2 colors[];
+};
+
+const float SH_C0 = 0.28209479177387814;
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef COMMON_SH_GLSL
+#define COMMON_SH_GLSL
+
+#include "gaussian.glsl"
+
+const float SH_C1 = 0.4886025119029199;
+const float SH_C2[5] = float[](1.0925484305920792, -1.0925484305920792, 0.31539156525252005, -1.0925484305920792, 0.5462742152960396);
+const float SH_C3[7] = float[](-0.5900435899266435, 2.890611442640554, -0.4570457994644658, 0.3731763325901154,
+							   -0.4570457994644658, 1.445305721320277, -0.5900435899266435);
+
+//Coefficient k (1..15) of every channel. f_rest is stored channel major: R[0..14], G[15..29], B[30..44]
+vec3 sh_coefficient(GaussianSurfaces gaussians, uint index, uint k)
+{
+	return vec3(gaussians.surfaces[index].f_rest[k - 1u],
+				gaussians.surfaces[index].f_rest[15u + k - 1u],
+				gaussians.surfaces[index].f_rest[30u + k - 1u]);
+}
+
+//View dependent color for a normalized direction from the camera to the splat (model space).
+//Coefficients above the requested degree are never fetched
+vec3 evaluate_sh(GaussianSurfaces gaussians, uint index, uint degree, vec3 dir)
+{
+	vec3 result = SH_C0 * gaussians.surfaces[index].f_dc;
+
+	if (degree > 0u)
+	{
+		float x = dir.x;
+		float y = dir.y;
+		float z = dir.z;
+
+		result += SH_C1 * (-y * sh_coefficient(gaussians, index, 1u) +
+						    z * sh_coefficient(gaussians, index, 2u) -
+						    x * sh_coefficient(gaussians, index, 3u));
+
+		if (degree > 1u)
+		{
+			float xx = x * x, yy = y * y, zz = z * z;
+			float xy = x * y, yz = y * z, xz = x * z;
+
+			result += SH_C2[0] * xy * sh_coefficient(gaussians, index, 4u) +
+					  SH_C2[1] * yz * sh_coefficient(gaussians, index, 5u) +
+					  SH_C2[2] * (2.0 * zz - xx - yy) * sh_coefficient(gaussians, index, 6u) +
+					  SH_C2[3] * xz * sh_coefficient(gaussians, index, 7u) +
+					  SH_C2[4] * (xx - yy) * sh_coefficient(gaussians, index, 8u);
+
+			if (degree > 2u)
+			{
+				result += SH_C3[0] * y * (3.0 * xx - yy) * sh_coefficient(gaussians, index, 9u) +
+						  SH_C3[1] * xy * z * sh_coefficient(gaussians, index, 10u) +
+						  SH_C3[2] * y * (4.0 * zz - xx - yy) * sh_coefficient(gaussians, index, 11u) +
+						  SH_C3[3] * z * (2.0 * zz - 3.0 * xx - 3.0 * yy) * sh_coefficient(gaussians, index, 12u) +
+						  SH_C3[4] * x * (4.0 * zz - xx - yy) * sh_coefficient(gaussians, index, 13u) +
+						  SH_C3[5] * z * (xx - yy) * sh_coefficient(gaussians, index, 14u) +
+						  SH_C3[6] * x * (xx - 3.0 * yy) * sh_coefficient(gaussians, index, 15u);
+			}
+		}
+	}
+
+	return max(result + 0.5, vec3(0.0));
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef COMMON_TILE_RASTER_GLSL
+#define COMMON_TILE_RASTER_GLSL
+
+#include "camera.glsl"
+#include "gaussian.glsl"
+
+#define TILE_SIZE 16
+#define RADIX_BITS 8
+#define RADIX_BUCKETS 256
+#define SORT_WORKGROUP_SIZE 256
+#define SORT_ITEMS_PER_THREAD 16
+#define SORT_KEYS_PER_WORKGROUP (SORT_WORKGROUP_SIZE * SORT_ITEMS_PER_THREAD)
+
+//Guaranteed maxComputeWorkGroupCount per dimension. Larger dispatches are spread over y
+#define MAX_GROUPS_PER_DIMENSION 65535u
+
+//Counters and indirect dispatch arguments shared by the tile raster kernels
+layout(buffer_reference, std430) buffer SortState
+{
+	uint key_count;			//written by the duplicate pass, never above the capacity
+	uint sort_groups_x;		//indirect args for the radix kernels
+	uint sort_groups_y;
+	uint sort_groups_z;
+	uint key_groups_x;		//indirect args for the per key kernels
+	uint key_groups_y;
+	uint key_groups_z;
+	uint sort_group_count;
+};
+
+layout(buffer_reference, std430) buffer Uints
+{
+	uint values[];
+};
+
+layout(buffer_reference, std430) buffer TileRanges
+{
+	uvec2 ranges[];
+};
+
+//Mirrors TileRasterPushConstantBlock in structs/scene/PushConstantBlock.h
+layout(push_constant) uniform PushConstants
+{
+	CameraData camera_data_address;
+	SplatRecords splat_record_address;
+	SortState sort_state_address;
+	Uints keys_in_address;
+	Uints values_in_address;
+	Uints keys_out_address;
+	Uints values_out_address;
+	Uints histogram_address;
+	TileRanges tile_range_address;
+	uint gaussian_count;
+	uint key_capacity;
+	uint tile_count_x;
+	uint tile_count_y;
+	uint tile_bits;
+	uint radix_shift;
+} pc;
+
+//Workgroup index of a dispatch spread over x and y
+uint linear_group_id()
+{
+	return gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+}
+
+//Splits group_count into x and y counts that stay under the per dimension limit
+uvec2 spread_group_count(uint group_count)
+{
+	uint group_count_x = min(group_count, MAX_GROUPS_PER_DIMENSION);
+	return uvec2(group_count_x, (group_count + group_count_x - 1) / max(group_count_x, 1u));
+}
+
+#endif
@@ -0,0 +1,17 @@
+//Specialization constants shared by the splat compute shaders, see material::ShaderVariant.
+//Constant ids a shader does not reference are ignored, so every variant passes the same map
+
+//Spherical harmonics degree (0..3)
+layout(constant_id = 0) const uint SH_DEGREE = 3;
+
+//Guard band frustum test in the preprocess pass
+layout(constant_id = 1) const bool FRUSTUM_CULLING = true;
+
+//Color override, matches the DebugView enum
+layout(constant_id = 2) const uint DEBUG_VIEW = 0;
+
+const uint DEBUG_VIEW_NONE = 0u;
+const uint DEBUG_VIEW_DEPTH = 1u;
+const uint DEBUG_VIEW_RADIUS = 2u;
+const uint DEBUG_VIEW_OPACITY = 3u;
+const uint DEBUG_VIEW_OVERDRAW = 4u;	//drawn by the overdraw pass, the preprocess pass runs the None variant
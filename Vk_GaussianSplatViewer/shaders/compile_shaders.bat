@@ -48,11 +48,18 @@ for /R "%SHADER_DIR%" %%F in (*.glsl) do (
     echo !NAME! | findstr /i ".comp.glsl" >nul && set "STAGE=compute"
     echo !NAME! | findstr /i ".tesc.glsl" >nul && set "STAGE=tesscontrol"
     echo !NAME! | findstr /i ".tese.glsl" >nul && set "STAGE=tesseval"
+    echo !NAME! | findstr /i ".task.glsl" >nul && set "STAGE=task"
+    echo !NAME! | findstr /i ".mesh.glsl" >nul && set "STAGE=mesh"
+
+    :: Mesh and task shaders need SPIR-V 1.4+
+    set "TARGET_FLAG="
+    if "!STAGE!"=="task" set "TARGET_FLAG=--target-env=vulkan1.3"
+    if "!STAGE!"=="mesh" set "TARGET_FLAG=--target-env=vulkan1.3"
 
     :: Compile if stage detected
     if defined STAGE (
         echo Compiling !FILE! as !STAGE! to !OUT!...
-        "%GLSLC%" -fshader-stage=!STAGE! "!FILE!" -o "!OUT!" !INCLUDE_FLAG!
+        "%GLSLC%" -fshader-stage=!STAGE! !TARGET_FLAG! "!FILE!" -o "!OUT!" !INCLUDE_FLAG!
         if errorlevel 1 (
             echo [ERROR] Failed to compile !FILE!
         )
@@ -0,0 +1,43 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/camera.glsl"
+#include "../common/gaussian.glsl"
+#include "../common/sh.glsl"
+#include "../common/variant.glsl"
+
+//Must match splat_workgroup_size in Config.inl
+layout(local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+layout(push_constant) uniform PushConstants
+{
+	CameraData camera_data_address;
+	GaussianSurfaces gaussian_address;
+	ColorCache color_cache_address;
+	uint gaussian_count;
+} pc;
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= pc.gaussian_count)
+	{
+		return;
+	}
+
+	CameraData camera = pc.camera_data_address;
+	GaussianSurfaces gaussians = pc.gaussian_address;
+
+	//Same flip as the preprocess pass. SH are defined in the unflipped model frame
+	const mat3 flip = mat3(vec3(-1.0, 0.0, 0.0), vec3(0.0, -1.0, 0.0), vec3(0.0, 0.0, 1.0));
+	vec3 world_position = flip * gaussians.surfaces[index].position;
+	vec3 view_direction = normalize(flip * (world_position - camera.position.xyz));
+
+	vec3 color = evaluate_sh(gaussians, index, SH_DEGREE, view_direction);
+	float opacity = 1.0 / (1.0 + exp(-gaussians.surfaces[index].opacity));
+
+	//RGBA16F
+	pc.color_cache_address.colors[index] = uvec2(packHalf2x16(color.rg), packHalf2x16(vec2(color.b, opacity)));
+}
@@ -0,0 +1,74 @@
+#version 460
+#extension GL_EXT_mesh_shader : require
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/camera.glsl"
+#include "../common/gaussian.glsl"
+
+#define CLUSTER_SIZE 32
+
+layout(local_size_x = CLUSTER_SIZE, local_size_y = 1, local_size_z = 1) in;
+layout(triangles, max_vertices = CLUSTER_SIZE * 4, max_primitives = CLUSTER_SIZE * 2) out;
+
+layout(push_constant) uniform PushConstants
+{
+	CameraData camera_data_address;
+	SplatRecords splat_record_address;
+	uint gaussian_count;
+} pc;
+
+struct TaskPayload
+{
+	uint visible_count;
+	uint splat_indices[CLUSTER_SIZE];
+};
+
+taskPayloadSharedEXT TaskPayload payload;
+
+//Same interface as the point path so gaussian.frag is shared
+layout (location = 0) out vec4 fragColor[];
+layout (location = 1) flat out vec3 fragConic[];
+layout (location = 2) flat out vec2 fragCenter[];
+
+const vec2 corners[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+//Emits one screen aligned quad (4 vertices, 2 triangles) per splat that survived the task stage
+void main()
+{
+	uint local_id = gl_LocalInvocationID.x;
+
+	uint count = payload.visible_count;
+	SetMeshOutputsEXT(count * 4u, count * 2u);
+
+	if (local_id >= count)
+	{
+		return;
+	}
+
+	CameraData camera = pc.camera_data_address;
+	SplatRecord record = pc.splat_record_address.records[payload.splat_indices[local_id]];
+
+	vec2 conic_z_radius = unpackHalf2x16(record.conic_z_radius);
+	vec4 color = vec4(unpackHalf2x16(record.color_rg), unpackHalf2x16(record.color_ba));
+	vec3 conic = vec3(unpackHalf2x16(record.conic_xy), conic_z_radius.x);
+
+	vec4 clip_depth = camera.projection * vec4(0.0, 0.0, -record.depth, 1.0);
+	float depth = clip_depth.z / clip_depth.w;
+
+	for (uint corner = 0u; corner < 4u; ++corner)
+	{
+		uint vertex = local_id * 4u + corner;
+		vec2 pixel = record.center + corners[corner] * conic_z_radius.y;
+
+		gl_MeshVerticesEXT[vertex].gl_Position = vec4(pixel / camera.viewport.xy * 2.0 - 1.0, depth, 1.0);
+		fragColor[vertex] = color;
+		fragConic[vertex] = conic;
+		fragCenter[vertex] = record.center;
+	}
+
+	uint first_vertex = local_id * 4u;
+	gl_PrimitiveTriangleIndicesEXT[local_id * 2u] = uvec3(first_vertex, first_vertex + 1u, first_vertex + 2u);
+	gl_PrimitiveTriangleIndicesEXT[local_id * 2u + 1u] = uvec3(first_vertex + 2u, first_vertex + 1u, first_vertex + 3u);
+}
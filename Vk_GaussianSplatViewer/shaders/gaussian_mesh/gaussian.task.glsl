@@ -0,0 +1,73 @@
+#version 460
+#extension GL_EXT_mesh_shader : require
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/camera.glsl"
+#include "../common/gaussian.glsl"
+
+#define CLUSTER_SIZE 32
+
+layout(local_size_x = CLUSTER_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+layout(push_constant) uniform PushConstants
+{
+	CameraData camera_data_address;
+	SplatRecords splat_record_address;
+	uint gaussian_count;
+} pc;
+
+struct TaskPayload
+{
+	uint visible_count;
+	uint splat_indices[CLUSTER_SIZE];
+};
+
+taskPayloadSharedEXT TaskPayload payload;
+
+shared uint visible_count;
+
+//Smallest on-screen radius worth rasterizing
+const float min_radius_pixels = 0.5;
+
+//One workgroup per cluster of 32 splats; only the surviving splats are forwarded to the mesh stage
+void main()
+{
+	uint cluster = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+	uint index = cluster * CLUSTER_SIZE + gl_LocalInvocationID.x;
+
+	if (gl_LocalInvocationID.x == 0u)
+	{
+		visible_count = 0u;
+	}
+	barrier();
+
+	if (index < pc.gaussian_count)
+	{
+		SplatRecord record = pc.splat_record_address.records[index];
+		float radius = unpackHalf2x16(record.conic_z_radius).y;
+		vec2 viewport = pc.camera_data_address.viewport.xy;
+
+		//Frustum: the preprocess pass zeroes depth for culled splats, the quad must also overlap the viewport
+		bool visible = record.depth > 0.0 &&
+					   radius >= min_radius_pixels &&
+					   all(greaterThan(record.center + radius, vec2(0.0))) &&
+					   all(lessThan(record.center - radius, viewport));
+
+		if (visible)
+		{
+			uint slot = atomicAdd(visible_count, 1u);
+			payload.splat_indices[slot] = index;
+		}
+	}
+	barrier();
+
+	if (gl_LocalInvocationID.x == 0u)
+	{
+		payload.visible_count = visible_count;
+	}
+
+	//Whole cluster culled: no mesh workgroup is launched
+	EmitMeshTasksEXT(visible_count > 0u ? 1u : 0u, 1u, 1u);
+}
@@ -0,0 +1,46 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/camera.glsl"
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout(set = 0, binding = 0, rgba8) uniform writeonly image2D output_image;
+
+//Mirrors OverdrawPushConstantBlock in structs/scene/PushConstantBlock.h
+layout(push_constant) uniform PushConstants
+{
+	OverdrawCounts counts_address;
+	uint width;
+	uint height;
+	uint max_overdraw;
+} pc;
+
+vec3 heat_color(float t)
+{
+	t = clamp(t, 0.0, 1.0);
+	return clamp(vec3(2.0 * t - 0.5, 1.0 - abs(2.0 * t - 1.0), 1.5 - 2.0 * t), 0.0, 1.0);
+}
+
+//Maps the per pixel counters to a heat ramp. Log scaled so single digit overdraw is still told apart
+//from the hundreds a dense cluster reaches; max_overdraw and above are red
+void main()
+{
+	uvec2 pixel = gl_GlobalInvocationID.xy;
+	if (pixel.x >= pc.width || pixel.y >= pc.height)
+	{
+		return;
+	}
+
+	uint count = pc.counts_address.counts[pixel.y * pc.width + pixel.x];
+
+	vec3 color = vec3(0.0);
+	if (count > 0u)
+	{
+		color = heat_color(log2(float(count) + 1.0) / log2(float(max(pc.max_overdraw, 1u)) + 1.0));
+	}
+
+	imageStore(output_image, ivec2(pixel), vec4(color, 1.0));
+}
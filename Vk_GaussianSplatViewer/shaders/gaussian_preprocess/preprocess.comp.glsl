@@ -0,0 +1,170 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/camera.glsl"
+#include "../common/gaussian.glsl"
+#include "../common/variant.glsl"
+
+//Must match splat_workgroup_size in Config.inl
+layout(local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+layout(push_constant) uniform PushConstants
+{
+	CameraData camera_data_address;
+	GaussianSurfaces gaussian_address;
+	SplatRecords splat_record_address;
+	ColorCache color_cache_address;
+	uint gaussian_count;
+} pc;
+
+const float near_plane_cull = 0.2;
+const float frustum_guard_band = 1.3;
+
+void write_culled(uint index)
+{
+	SplatRecord record;
+	record.center = vec2(0.0);
+	record.depth = 0.0;
+	record.conic_xy = 0u;
+	record.conic_z_radius = 0u;
+	record.color_rg = 0u;
+	record.color_ba = 0u;
+	record.splat_index = index;
+
+	pc.splat_record_address.records[index] = record;
+}
+
+mat3 rotation_from_quaternion(vec4 q)
+{
+	q = normalize(q);
+	float r = q.x;
+	float x = q.y;
+	float y = q.z;
+	float z = q.w;
+
+	return mat3(
+		1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y + r * z), 2.0 * (x * z - r * y),
+		2.0 * (x * y - r * z), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z + r * x),
+		2.0 * (x * z + r * y), 2.0 * (y * z - r * x), 1.0 - 2.0 * (x * x + y * y));
+}
+
+//Blue -> green -> red ramp for t in [0, 1]
+vec3 heat_color(float t)
+{
+	t = clamp(t, 0.0, 1.0);
+	return clamp(vec3(2.0 * t - 0.5, 1.0 - abs(2.0 * t - 1.0), 1.5 - 2.0 * t), 0.0, 1.0);
+}
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= pc.gaussian_count)
+	{
+		return;
+	}
+
+	CameraData camera = pc.camera_data_address;
+	GaussianSurfaces gaussians = pc.gaussian_address;
+
+	//Fields are fetched individually so the SH coefficients are never loaded here
+	vec3 surface_position = gaussians.surfaces[index].position;
+	vec3 surface_scale = gaussians.surfaces[index].scale;
+	vec4 surface_rotation = gaussians.surfaces[index].rotation;
+
+	//Flipping for getting scene right (same convention as the raster path)
+	const mat3 flip = mat3(vec3(-1.0, 0.0, 0.0), vec3(0.0, -1.0, 0.0), vec3(0.0, 0.0, 1.0));
+	vec3 world_position = flip * surface_position;
+
+	vec4 view_position = camera.view * vec4(world_position, 1.0);
+	float depth = -view_position.z;
+	if (depth < near_plane_cull)
+	{
+		write_culled(index);
+		return;
+	}
+
+	vec4 clip_position = camera.projection * view_position;
+	vec3 ndc = clip_position.xyz / clip_position.w;
+	if (FRUSTUM_CULLING && any(greaterThan(abs(ndc.xy), vec2(frustum_guard_band))))
+	{
+		write_culled(index);
+		return;
+	}
+
+	//3D covariance from scale and rotation, moved into the flipped frame
+	mat3 scale_matrix = mat3(0.0);
+	scale_matrix[0][0] = exp(surface_scale.x);
+	scale_matrix[1][1] = exp(surface_scale.y);
+	scale_matrix[2][2] = exp(surface_scale.z);
+
+	mat3 m = rotation_from_quaternion(surface_rotation) * scale_matrix;
+	mat3 covariance_3d = flip * (m * transpose(m)) * flip;
+
+	//Project with the jacobian of the perspective divide (EWA splatting)
+	vec2 focal = camera.viewport.zw;
+	vec2 tan_fov = 0.5 * camera.viewport.xy / focal;
+	vec2 limit = frustum_guard_band * tan_fov;
+	vec2 t = clamp(view_position.xy / depth, -limit, limit) * depth;
+
+	//Screen y grows downwards (the projection has its y axis flipped)
+	mat3 jacobian = mat3(
+		focal.x / depth, 0.0, 0.0,
+		0.0, -focal.y / depth, 0.0,
+		focal.x * t.x / (depth * depth), -focal.y * t.y / (depth * depth), 0.0);
+
+	mat3 view_rotation = mat3(camera.view);
+	mat3 transform = jacobian * view_rotation;
+	mat3 covariance_2d = transform * covariance_3d * transpose(transform);
+
+	//Low pass filter so that every splat covers at least one pixel
+	float a = covariance_2d[0][0] + 0.3;
+	float b = covariance_2d[0][1];
+	float c = covariance_2d[1][1] + 0.3;
+
+	float determinant = a * c - b * b;
+	if (determinant <= 0.0)
+	{
+		write_culled(index);
+		return;
+	}
+
+	vec3 conic = vec3(c, -b, a) / determinant;
+
+	float mid = 0.5 * (a + c);
+	float lambda = mid + sqrt(max(0.1, mid * mid - determinant));
+	float radius = ceil(3.0 * sqrt(lambda));
+
+	//Color and opacity come from the color cache pass, already packed as half floats
+	uvec2 cached_color = pc.color_cache_address.colors[index];
+
+	//Specialized away in the default variant
+	if (DEBUG_VIEW != DEBUG_VIEW_NONE)
+	{
+		float opacity = unpackHalf2x16(cached_color.y).y;
+		vec4 debug_color = vec4(vec3(opacity), 1.0);
+
+		if (DEBUG_VIEW == DEBUG_VIEW_DEPTH)
+		{
+			debug_color = vec4(heat_color(1.0 - exp(-0.1 * depth)), opacity);
+		}
+		else if (DEBUG_VIEW == DEBUG_VIEW_RADIUS)
+		{
+			debug_color = vec4(heat_color(radius / 64.0), opacity);
+		}
+
+		cached_color = uvec2(packHalf2x16(debug_color.rg), packHalf2x16(debug_color.ba));
+	}
+
+	SplatRecord record;
+	record.center = (ndc.xy * 0.5 + 0.5) * camera.viewport.xy;
+	record.depth = depth;
+	record.conic_xy = packHalf2x16(conic.xy);
+	record.conic_z_radius = packHalf2x16(vec2(conic.z, radius));
+	record.color_rg = cached_color.x;
+	record.color_ba = cached_color.y;
+	record.splat_index = index;
+
+	pc.splat_record_address.records[index] = record;
+}
@@ -2,31 +2,45 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_EXT_buffer_reference : require
 #extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
 
-layout (location = 0) in vec3 fragColor;
+#include "../common/camera.glsl"
 
-layout (location = 0) out vec4 outColor;
+layout (location = 0) in vec4 fragColor;
+layout (location = 1) flat in vec3 fragConic;
+layout (location = 2) flat in vec2 fragCenter;
 
-layout(buffer_reference, std430) readonly buffer CameraData
-{
-    mat4 projection;
-    mat4 view;
-};
+layout (location = 0) out vec4 outColor;
 
+//Both the vertex and the mesh path push the camera first
 layout(push_constant) uniform PushConstants
 {
-    CameraData camera_data_adddress;
-//ModelTransform model_transform_address;
+	CameraData camera_data_address;
 } pc;
 
-
 void main () 
 {
-    const float radius = 0.25;
-    if (length(gl_PointCoord - vec2(0.5)) > radius)
-    {
-        discard;
-    }
-
-    outColor = vec4(fragColor, 1.0);
-}
\ No newline at end of file
+	//Overdraw view: every rasterized fragment counts, including the ones discarded below
+	CameraData camera = pc.camera_data_address;
+	if (camera.overdraw_enabled != 0u)
+	{
+		ivec2 pixel = ivec2(gl_FragCoord.xy);
+		atomicAdd(camera.overdraw_address.counts[pixel.y * int(camera.viewport.x) + pixel.x], 1u);
+	}
+
+	//Evaluate the projected gaussian at this pixel
+	vec2 d = fragCenter - gl_FragCoord.xy;
+	float power = -0.5 * (fragConic.x * d.x * d.x + fragConic.z * d.y * d.y) - fragConic.y * d.x * d.y;
+	if (power > 0.0)
+	{
+		discard;
+	}
+
+	float alpha = min(0.99, fragColor.a * exp(power));
+	if (alpha < 1.0 / 255.0)
+	{
+		discard;
+	}
+
+	outColor = vec4(fragColor.rgb, alpha);
+}
@@ -2,44 +2,48 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_EXT_buffer_reference : require
 #extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
 
-layout (location = 0) in vec3 in_position;
-layout (location = 1) in vec3 in_normal;
-layout (location = 2) in vec3 in_SH;
-layout (location = 3) in float in_opacity;
-layout (location = 4) in vec3 in_scale;
-layout (location = 5) in vec4 in_rotation;
+#include "../common/camera.glsl"
 
-layout (location = 0) out vec3 fragColor;
+//SplatRecord attributes written by the preprocess pass
+layout (location = 0) in vec2 in_center;
+layout (location = 1) in float in_depth;
+layout (location = 2) in uint in_conic_xy;
+layout (location = 3) in uint in_conic_z_radius;
+layout (location = 4) in uint in_color_rg;
+layout (location = 5) in uint in_color_ba;
 
-layout(buffer_reference, std430) readonly buffer CameraData
-{
-	mat4 projection;
-	mat4 view;
-};
-
-//layout(buffer_reference, scalar) buffer ModelTransform
-//{
-//	mat4 model_transform;
-//};
+layout (location = 0) out vec4 fragColor;
+layout (location = 1) flat out vec3 fragConic;
+layout (location = 2) flat out vec2 fragCenter;
 
 layout(push_constant) uniform PushConstants
 {
 	CameraData camera_data_adddress;
-	//ModelTransform model_transform_address;
 } pc;
 
 void main()
 {
-	CameraData matrices = CameraData(pc.camera_data_adddress);
-	//ModelTransform model_transform = ModelTransform(pc.model_transform_address);
+	CameraData camera = CameraData(pc.camera_data_adddress);
+
+	vec2 conic_z_radius = unpackHalf2x16(in_conic_z_radius);
+
+	//Culled splats are pushed outside of the clip volume
+	if (in_depth <= 0.0)
+	{
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		gl_PointSize = 1.0;
+		return;
+	}
 
-	vec4 position = vec4(in_position, 1.0);
-	//Flipping for getting scene right
-	position.xy *= -1.0;
+	vec2 ndc = in_center / camera.viewport.xy * 2.0 - 1.0;
+	vec4 clip_depth = camera.projection * vec4(0.0, 0.0, -in_depth, 1.0);
 
-	gl_Position = matrices.projection * matrices.view * position;
-	gl_PointSize = 2.0;
+	gl_Position = vec4(ndc, clip_depth.z / clip_depth.w, 1.0);
+	gl_PointSize = clamp(2.0 * conic_z_radius.y, 1.0, 256.0);
 
-	fragColor = in_SH * 0.28 + vec3(0.5, 0.5, 0.5);
-}
\ No newline at end of file
+	fragColor = vec4(unpackHalf2x16(in_color_rg), unpackHalf2x16(in_color_ba));
+	fragConic = vec3(unpackHalf2x16(in_conic_xy), conic_z_radius.x);
+	fragCenter = in_center;
+}
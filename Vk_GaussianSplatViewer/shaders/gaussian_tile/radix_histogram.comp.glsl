@@ -0,0 +1,43 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+layout(local_size_x = SORT_WORKGROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+shared uint local_histogram[RADIX_BUCKETS];
+
+//Counts the digits of one block of keys. Output is digit major so a single scan yields scatter offsets
+void main()
+{
+	uint local_id = gl_LocalInvocationID.x;
+	uint group_id = linear_group_id();
+
+	uint key_count = pc.sort_state_address.key_count;
+	uint group_count = pc.sort_state_address.sort_group_count;
+
+	//Padding groups of the last y row
+	if (group_id >= group_count)
+	{
+		return;
+	}
+
+	local_histogram[local_id] = 0u;
+	barrier();
+
+	uint block_start = group_id * SORT_KEYS_PER_WORKGROUP;
+	for (uint i = 0; i < SORT_ITEMS_PER_THREAD; ++i)
+	{
+		uint key_index = block_start + i * SORT_WORKGROUP_SIZE + local_id;
+		if (key_index < key_count)
+		{
+			uint digit = (pc.keys_in_address.values[key_index] >> pc.radix_shift) & (RADIX_BUCKETS - 1);
+			atomicAdd(local_histogram[digit], 1u);
+		}
+	}
+	barrier();
+
+	pc.histogram_address.values[local_id * group_count + group_id] = local_histogram[local_id];
+}
@@ -0,0 +1,50 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+#define SCAN_WORKGROUP_SIZE 1024
+
+layout(local_size_x = SCAN_WORKGROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+shared uint partial_sums[SCAN_WORKGROUP_SIZE];
+
+//Exclusive scan of the digit major histogram in a single workgroup.
+//Every thread owns a contiguous chunk, the chunk totals are scanned in shared memory
+void main()
+{
+	uint local_id = gl_LocalInvocationID.x;
+	uint entry_count = pc.sort_state_address.sort_group_count * RADIX_BUCKETS;
+	uint chunk_size = (entry_count + SCAN_WORKGROUP_SIZE - 1) / SCAN_WORKGROUP_SIZE;
+
+	uint chunk_start = local_id * chunk_size;
+	uint chunk_end = min(chunk_start + chunk_size, entry_count);
+
+	uint sum = 0u;
+	for (uint i = chunk_start; i < chunk_end; ++i)
+	{
+		sum += pc.histogram_address.values[i];
+	}
+
+	partial_sums[local_id] = sum;
+	barrier();
+
+	//Hillis-Steele inclusive scan of the chunk totals
+	for (uint offset = 1u; offset < SCAN_WORKGROUP_SIZE; offset <<= 1u)
+	{
+		uint value = local_id >= offset ? partial_sums[local_id - offset] : 0u;
+		barrier();
+		partial_sums[local_id] += value;
+		barrier();
+	}
+
+	uint running = partial_sums[local_id] - sum;
+	for (uint i = chunk_start; i < chunk_end; ++i)
+	{
+		uint count = pc.histogram_address.values[i];
+		pc.histogram_address.values[i] = running;
+		running += count;
+	}
+}
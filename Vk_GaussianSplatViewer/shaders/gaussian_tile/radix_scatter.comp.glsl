@@ -0,0 +1,101 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+layout(local_size_x = SORT_WORKGROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+shared uint digit_offsets[RADIX_BUCKETS];		//next free slot per digit for this block
+shared uint round_digit_start[RADIX_BUCKETS];	//first local position of every digit in the current round
+shared uint round_digit_count[RADIX_BUCKETS];
+shared uint scan_buffer[SORT_WORKGROUP_SIZE];
+shared uint local_digits[SORT_WORKGROUP_SIZE];
+
+//Stable 1-bit split used to rank keys by digit inside a round
+uint split_rank(uint local_id, uint rank, bool bit_set)
+{
+	scan_buffer[rank] = bit_set ? 0u : 1u;
+	barrier();
+
+	for (uint offset = 1u; offset < SORT_WORKGROUP_SIZE; offset <<= 1u)
+	{
+		uint value = local_id >= offset ? scan_buffer[local_id - offset] : 0u;
+		barrier();
+		scan_buffer[local_id] += value;
+		barrier();
+	}
+
+	uint zeros_before_rank = scan_buffer[rank] - (bit_set ? 0u : 1u);
+	uint total_zeros = scan_buffer[SORT_WORKGROUP_SIZE - 1];
+	barrier();
+
+	return bit_set ? total_zeros + (rank - zeros_before_rank) : zeros_before_rank;
+}
+
+void main()
+{
+	uint local_id = gl_LocalInvocationID.x;
+	uint group_id = linear_group_id();
+
+	uint key_count = pc.sort_state_address.key_count;
+	uint group_count = pc.sort_state_address.sort_group_count;
+
+	//Padding groups of the last y row
+	if (group_id >= group_count)
+	{
+		return;
+	}
+
+	digit_offsets[local_id] = pc.histogram_address.values[local_id * group_count + group_id];
+
+	uint block_start = group_id * SORT_KEYS_PER_WORKGROUP;
+	for (uint iteration = 0; iteration < SORT_ITEMS_PER_THREAD; ++iteration)
+	{
+		uint key_index = block_start + iteration * SORT_WORKGROUP_SIZE + local_id;
+		bool valid = key_index < key_count;
+
+		uint key = valid ? pc.keys_in_address.values[key_index] : 0xFFFFFFFFu;
+		uint value = valid ? pc.values_in_address.values[key_index] : 0u;
+
+		//Padding keys sort after every real key of the round
+		uint digit = valid ? (key >> pc.radix_shift) & (RADIX_BUCKETS - 1) : RADIX_BUCKETS;
+
+		round_digit_count[local_id] = 0u;
+		barrier();
+
+		//Rank inside the round with 9 stable splits (8 digit bits + padding flag)
+		uint rank = local_id;
+		for (uint bit = 0u; bit < RADIX_BITS + 1u; ++bit)
+		{
+			rank = split_rank(local_id, rank, ((digit >> bit) & 1u) != 0u);
+		}
+
+		local_digits[rank] = digit;
+		if (valid)
+		{
+			atomicAdd(round_digit_count[digit], 1u);
+		}
+		barrier();
+
+		//First slot of every digit inside the sorted round
+		uint sorted_digit = local_digits[local_id];
+		if (sorted_digit < RADIX_BUCKETS && (local_id == 0u || local_digits[local_id - 1] != sorted_digit))
+		{
+			round_digit_start[sorted_digit] = local_id;
+		}
+		barrier();
+
+		if (valid)
+		{
+			uint destination = digit_offsets[digit] + (rank - round_digit_start[digit]);
+			pc.keys_out_address.values[destination] = key;
+			pc.values_out_address.values[destination] = value;
+		}
+		barrier();
+
+		digit_offsets[local_id] += round_digit_count[local_id];
+		barrier();
+	}
+}
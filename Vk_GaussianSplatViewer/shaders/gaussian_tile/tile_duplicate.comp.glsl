@@ -0,0 +1,70 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+layout(local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+//Emits one (tile, depth) key per tile touched by every visible splat
+void main()
+{
+	uint index = linear_group_id() * gl_WorkGroupSize.x + gl_LocalInvocationID.x;
+	if (index >= pc.gaussian_count)
+	{
+		return;
+	}
+
+	SplatRecord record = pc.splat_record_address.records[index];
+	if (record.depth <= 0.0)
+	{
+		return;
+	}
+
+	float radius = unpackHalf2x16(record.conic_z_radius).y;
+
+	ivec2 tile_max = ivec2(pc.tile_count_x, pc.tile_count_y);
+	ivec2 rect_min = clamp(ivec2(floor((record.center - radius) / TILE_SIZE)), ivec2(0), tile_max);
+	ivec2 rect_max = clamp(ivec2(floor((record.center + radius) / TILE_SIZE)) + 1, ivec2(0), tile_max);
+
+	ivec2 rect_size = rect_max - rect_min;
+	uint tiles_touched = uint(rect_size.x * rect_size.y);
+	if (tiles_touched == 0u)
+	{
+		return;
+	}
+
+	//Only reserves keys that fit, so key_count never runs past what was written. The plain read is only a first guess:
+	//the count only grows, and the compare and swap returns the current value
+	uint offset = pc.sort_state_address.key_count;
+	for (;;)
+	{
+		if (offset + tiles_touched > pc.key_capacity)
+		{
+			//Out of key space for this frame, the splat is dropped
+			return;
+		}
+
+		uint previous = atomicCompSwap(pc.sort_state_address.key_count, offset, offset + tiles_touched);
+		if (previous == offset)
+		{
+			break;
+		}
+		offset = previous;
+	}
+
+	//Positive floats sort like their bit patterns; keep the most significant depth bits
+	uint depth_bits = floatBitsToUint(record.depth) >> pc.tile_bits;
+
+	for (int y = rect_min.y; y < rect_max.y; ++y)
+	{
+		for (int x = rect_min.x; x < rect_max.x; ++x)
+		{
+			uint tile = uint(y) * pc.tile_count_x + uint(x);
+			pc.keys_in_address.values[offset] = (tile << (32u - pc.tile_bits)) | depth_bits;
+			pc.values_in_address.values[offset] = index;
+			offset++;
+		}
+	}
+}
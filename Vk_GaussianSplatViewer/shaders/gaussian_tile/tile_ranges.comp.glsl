@@ -0,0 +1,32 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+layout(local_size_x = SORT_WORKGROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+//Finds the [start, end) range of every tile in the sorted key list
+void main()
+{
+	uint index = linear_group_id() * SORT_WORKGROUP_SIZE + gl_LocalInvocationID.x;
+	uint key_count = pc.sort_state_address.key_count;
+	if (index >= key_count)
+	{
+		return;
+	}
+
+	uint tile_shift = 32u - pc.tile_bits;
+	uint tile = pc.keys_in_address.values[index] >> tile_shift;
+
+	if (index == 0u || (pc.keys_in_address.values[index - 1] >> tile_shift) != tile)
+	{
+		pc.tile_range_address.ranges[tile].x = index;
+	}
+
+	if (index == key_count - 1u || (pc.keys_in_address.values[index + 1] >> tile_shift) != tile)
+	{
+		pc.tile_range_address.ranges[tile].y = index + 1u;
+	}
+}
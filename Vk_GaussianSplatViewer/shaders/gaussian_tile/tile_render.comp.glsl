@@ -0,0 +1,116 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+#define TILE_PIXELS (TILE_SIZE * TILE_SIZE)
+
+layout(local_size_x = TILE_SIZE, local_size_y = TILE_SIZE, local_size_z = 1) in;
+
+layout(set = 0, binding = 0, rgba8) uniform writeonly image2D output_image;
+
+shared vec2 batch_center[TILE_PIXELS];
+shared vec4 batch_conic_opacity[TILE_PIXELS];
+shared vec3 batch_color[TILE_PIXELS];
+shared uint finished_pixels;
+
+//One workgroup per tile; splats are streamed through shared memory and blended front to back
+void main()
+{
+	uint local_index = gl_LocalInvocationIndex;
+	uvec2 tile = gl_WorkGroupID.xy;
+	ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 image_size = imageSize(output_image);
+
+	bool inside = all(lessThan(pixel, image_size));
+	vec2 pixel_center = vec2(pixel) + 0.5;
+
+	uvec2 range = pc.tile_range_address.ranges[tile.y * pc.tile_count_x + tile.x];
+	uint splat_count = range.y > range.x ? range.y - range.x : 0u;
+
+	//Pixels outside the image count as finished from the start. Set by one thread instead of an atomic per pixel,
+	//which could run before the initialization since nothing orders the two without another barrier
+	if (local_index == 0u)
+	{
+		uvec2 inside_size = uvec2(clamp(image_size - ivec2(tile * TILE_SIZE), ivec2(0), ivec2(TILE_SIZE)));
+		finished_pixels = TILE_PIXELS - inside_size.x * inside_size.y;
+	}
+
+	float transmittance = 1.0;
+	vec3 color = vec3(0.0);
+	bool done = !inside;
+
+	//Splats evaluated for this pixel, stored for the overdraw view
+	uint evaluated_count = 0u;
+	barrier();
+
+	for (uint batch_start = 0u; batch_start < splat_count; batch_start += TILE_PIXELS)
+	{
+		//Early termination once every pixel of the tile is saturated
+		if (finished_pixels == TILE_PIXELS)
+		{
+			break;
+		}
+
+		uint fetch = batch_start + local_index;
+		if (fetch < splat_count)
+		{
+			uint splat_index = pc.values_in_address.values[range.x + fetch];
+			SplatRecord record = pc.splat_record_address.records[splat_index];
+
+			vec2 conic_z_radius = unpackHalf2x16(record.conic_z_radius);
+			vec2 color_ba = unpackHalf2x16(record.color_ba);
+
+			batch_center[local_index] = record.center;
+			batch_conic_opacity[local_index] = vec4(unpackHalf2x16(record.conic_xy), conic_z_radius.x, color_ba.y);
+			batch_color[local_index] = vec3(unpackHalf2x16(record.color_rg), color_ba.x);
+		}
+		barrier();
+
+		uint batch_size = min(TILE_PIXELS, splat_count - batch_start);
+		for (uint i = 0u; i < batch_size && !done; ++i)
+		{
+			++evaluated_count;
+
+			vec2 d = batch_center[i] - pixel_center;
+			vec4 conic_opacity = batch_conic_opacity[i];
+
+			float power = -0.5 * (conic_opacity.x * d.x * d.x + conic_opacity.z * d.y * d.y) - conic_opacity.y * d.x * d.y;
+			if (power > 0.0)
+			{
+				continue;
+			}
+
+			float alpha = min(0.99, conic_opacity.w * exp(power));
+			if (alpha < 1.0 / 255.0)
+			{
+				continue;
+			}
+
+			float next_transmittance = transmittance * (1.0 - alpha);
+			if (next_transmittance < 0.0001)
+			{
+				done = true;
+				atomicAdd(finished_pixels, 1u);
+				break;
+			}
+
+			color += batch_color[i] * alpha * transmittance;
+			transmittance = next_transmittance;
+		}
+		barrier();
+	}
+
+	if (inside)
+	{
+		imageStore(output_image, pixel, vec4(color, 1.0 - transmittance));
+
+		CameraData camera = pc.camera_data_address;
+		if (camera.overdraw_enabled != 0u)
+		{
+			camera.overdraw_address.counts[pixel.y * image_size.x + pixel.x] = evaluated_count;
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "../common/tile_raster.glsl"
+
+layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+
+//Turns the duplicated key count into indirect dispatch arguments
+void main()
+{
+	SortState state = pc.sort_state_address;
+
+	uint key_count = min(state.key_count, pc.key_capacity);
+	uint sort_groups = (key_count + SORT_KEYS_PER_WORKGROUP - 1) / SORT_KEYS_PER_WORKGROUP;
+
+	uvec2 sort_group_counts = spread_group_count(sort_groups);
+	uvec2 key_group_counts = spread_group_count((key_count + SORT_WORKGROUP_SIZE - 1) / SORT_WORKGROUP_SIZE);
+
+	state.key_count = key_count;
+	state.sort_groups_x = sort_group_counts.x;
+	state.sort_groups_y = sort_group_counts.y;
+	state.sort_groups_z = 1;
+	state.key_groups_x = key_group_counts.x;
+	state.key_groups_y = key_group_counts.y;
+	state.key_groups_z = 1;
+	state.sort_group_count = sort_groups;
+}
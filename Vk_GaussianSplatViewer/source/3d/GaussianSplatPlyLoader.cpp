@@ -6,23 +6,34 @@
 #include <vector>
 #include <tinyply.h>
 
+#include "core/CpuProfiler.h"
+
 using namespace tinyply;
 
 namespace splat_loader
 {
     namespace
     {
-        template<typename T>
-        inline void copy_property(
-            const std::shared_ptr<PlyData>& data,
-            T* dst,
-            size_t count)
+        inline const float* as_floats(const std::shared_ptr<PlyData>& data)
         {
-            std::memcpy(dst, data->buffer.get(), sizeof(T) * count);
+            return reinterpret_cast<const float*>(data->buffer.get());
         }
     }
 
     bool GaussianSplatPlyLoader::load(const std::string& file_path)
+    {
+        if (!open(file_path))
+        {
+            return false;
+        }
+
+        gaussians.resize(vertex_count);
+        decode(gaussians.data());
+
+        return true;
+    }
+
+    bool GaussianSplatPlyLoader::open(const std::string& file_path)
     {
         std::ifstream file(file_path, std::ios::binary);
         if (!file)
@@ -31,31 +42,28 @@ namespace splat_loader
             return false;
         }
 
+        GSV_CPU_ZONE("Read PLY");
+
         PlyFile ply_file;
         ply_file.parse_header(file);
 
         // --- Request properties ---
-        auto x  = ply_file.request_properties_from_element("vertex", { "x" });
-        auto y  = ply_file.request_properties_from_element("vertex", { "y" });
-        auto z  = ply_file.request_properties_from_element("vertex", { "z" });
-
-        auto nx = ply_file.request_properties_from_element("vertex", { "nx" });
-        auto ny = ply_file.request_properties_from_element("vertex", { "ny" });
-        auto nz = ply_file.request_properties_from_element("vertex", { "nz" });
+        const char* position_names[3] = { "x", "y", "z" };
+        const char* normal_names[3] = { "nx", "ny", "nz" };
 
-        auto opacity = ply_file.request_properties_from_element("vertex", { "opacity" });
+        for (int i = 0; i < 3; ++i)
+        {
+            position[i] = ply_file.request_properties_from_element("vertex", { position_names[i] });
+            normal[i] = ply_file.request_properties_from_element("vertex", { normal_names[i] });
+        }
 
-        auto scale_0 = ply_file.request_properties_from_element("vertex", { "scale_0" });
-        auto scale_1 = ply_file.request_properties_from_element("vertex", { "scale_1" });
-        auto scale_2 = ply_file.request_properties_from_element("vertex", { "scale_2" });
+        opacity = ply_file.request_properties_from_element("vertex", { "opacity" });
 
-        auto rot_0 = ply_file.request_properties_from_element("vertex", { "rot_0" });
-        auto rot_1 = ply_file.request_properties_from_element("vertex", { "rot_1" });
-        auto rot_2 = ply_file.request_properties_from_element("vertex", { "rot_2" });
-        auto rot_3 = ply_file.request_properties_from_element("vertex", { "rot_3" });
+        for (int i = 0; i < 3; ++i)
+            scale[i] = ply_file.request_properties_from_element("vertex", { "scale_" + std::to_string(i) });
 
-        std::shared_ptr<PlyData> f_dc[3];
-        std::shared_ptr<PlyData> f_rest[45];
+        for (int i = 0; i < 4; ++i)
+            rotation[i] = ply_file.request_properties_from_element("vertex", { "rot_" + std::to_string(i) });
 
         for (int i = 0; i < 3; ++i)
             f_dc[i] = ply_file.request_properties_from_element(
@@ -68,89 +76,64 @@ namespace splat_loader
         // Read data
         ply_file.read(file);
 
-        const size_t vertex_count = x->count;
-        gaussians.resize(vertex_count);
+        vertex_count = position[0]->count;
 
-        // --- Allocate SoA buffers ---
-        std::vector<float> xs(vertex_count), ys(vertex_count), zs(vertex_count);
-        std::vector<float> nxs(vertex_count), nys(vertex_count), nzs(vertex_count);
-        std::vector<float> opacity_arr(vertex_count);
+        return true;
+    }
+
+    void GaussianSplatPlyLoader::decode(GaussianSurface* destination) const
+    {
+        decode(destination, 0, vertex_count);
+    }
 
-        std::vector<float> scale[3];
-        std::vector<float> rotation[4];
-        std::vector<float> f_dc_arr[3];
-        std::vector<float> f_rest_arr[45];
+    void GaussianSplatPlyLoader::decode(GaussianSurface* destination, size_t first, size_t count) const
+    {
+        GSV_CPU_ZONE("Decode PLY");
 
-        for (int i = 0; i < 3; ++i)
-        {
-            scale[i].resize(vertex_count);
-            f_dc_arr[i].resize(vertex_count);
-        }
+        //Properties are decoded straight from the tinyply buffers, no intermediate SoA copies
+        const float* positions[3] = { as_floats(position[0]), as_floats(position[1]), as_floats(position[2]) };
+        const float* normals[3] = { as_floats(normal[0]), as_floats(normal[1]), as_floats(normal[2]) };
+        const float* opacities = as_floats(opacity);
 
-        for (auto & i : rotation)
-        {
-            i.resize(vertex_count);
-        }
+        const float* scales[3];
+        const float* rotations[4];
+        const float* f_dcs[3];
+        const float* f_rests[45];
 
-        for (auto & i : f_rest_arr)
+        for (int c = 0; c < 3; ++c)
         {
-            i.resize(vertex_count);
+            scales[c] = as_floats(scale[c]);
+            f_dcs[c] = as_floats(f_dc[c]);
         }
 
-        copy_property(x,  xs.data(), vertex_count);
-        copy_property(y,  ys.data(), vertex_count);
-        copy_property(z,  zs.data(), vertex_count);
-
-        copy_property(nx, nxs.data(), vertex_count);
-        copy_property(ny, nys.data(), vertex_count);
-        copy_property(nz, nzs.data(), vertex_count);
-
-        copy_property(opacity, opacity_arr.data(), vertex_count);
-
-        copy_property(scale_0, scale[0].data(), vertex_count);
-        copy_property(scale_1, scale[1].data(), vertex_count);
-        copy_property(scale_2, scale[2].data(), vertex_count);
-
-        copy_property(rot_0, rotation[0].data(), vertex_count);
-        copy_property(rot_1, rotation[1].data(), vertex_count);
-        copy_property(rot_2, rotation[2].data(), vertex_count);
-        copy_property(rot_3, rotation[3].data(), vertex_count);
+        for (int c = 0; c < 4; ++c)
+            rotations[c] = as_floats(rotation[c]);
 
-        for (int i = 0; i < 3; ++i)
-            copy_property(f_dc[i], f_dc_arr[i].data(), vertex_count);
-
-        for (int i = 0; i < 45; ++i)
-            copy_property(f_rest[i], f_rest_arr[i].data(), vertex_count);
+        for (int c = 0; c < 45; ++c)
+            f_rests[c] = as_floats(f_rest[c]);
 
-        GaussianSurface* out = gaussians.data();
-
-        for (size_t i = 0; i < vertex_count; ++i)
+        for (size_t i = first; i < first + count; ++i)
         {
-            auto& g = out[i];
-
-            g.position[0] = xs[i];
-            g.position[1] = ys[i];
-            g.position[2] = zs[i];
-
-            g.normal[0] = nxs[i];
-            g.normal[1] = nys[i];
-            g.normal[2] = nzs[i];
+            //Assembled on the stack and stored as a whole
+            GaussianSurface g;
 
             for (int c = 0; c < 3; ++c)
-                g.f_dc[c] = f_dc_arr[c][i];
+            {
+                g.position[c] = positions[c][i];
+                g.normal[c] = normals[c][i];
+                g.f_dc[c] = f_dcs[c][i];
+                g.scale[c] = scales[c][i];
+            }
 
             for (int c = 0; c < 45; ++c)
-                g.f_rest[c] = f_rest_arr[c][i];
+                g.f_rest[c] = f_rests[c][i];
 
-            g.opacity = opacity_arr[i];
-
-            for (int c = 0; c < 3; ++c)
-                g.scale[c] = scale[c][i];
+            g.opacity = opacities[i];
 
             for (int c = 0; c < 4; ++c)
-                g.rotation[c] = rotation[c][i];
-        }
+                g.rotation[c] = rotations[c][i];
 
-        return true;
+            destination[i - first] = g;
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,331 @@
+#include "3d/SplatCacheFile.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "core/CpuProfiler.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace splat_loader
+{
+    namespace
+    {
+        constexpr char cache_magic[8] = { 'G', 'S', 'V', 'S', 'P', 'L', 'A', 'T' };
+
+        uint64_t align_up(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        //FNV-1a, stable across runs and standard libraries unlike std::hash
+        uint64_t hash_path(const std::string& path)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (const char c : path)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+    }
+
+    SplatCacheFile::~SplatCacheFile()
+    {
+        close();
+    }
+
+    bool SplatCacheFile::open(const std::string& file_path)
+    {
+        GSV_CPU_ZONE("Map splat cache");
+
+        close();
+
+        std::error_code error;
+        const uint64_t file_size = std::filesystem::file_size(file_path, error);
+        if (error || file_size < sizeof(SplatCacheHeader))
+        {
+            std::cerr << "Invalid splat cache: " << file_path << std::endl;
+            return false;
+        }
+
+        if (!map_file(file_path, file_size, false))
+        {
+            return false;
+        }
+
+        SplatCacheHeader header{};
+        memcpy(&header, mapping, sizeof(header));
+
+        //Compared by division, a corrupt count could overflow the product
+        if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.version != cache_version ||
+            header.surface_size != sizeof(GaussianSurface) || header.data_offset > mapping_size ||
+            header.surface_count > (mapping_size - header.data_offset) / header.surface_size)
+        {
+            std::cerr << "Splat cache " << file_path << " is stale or corrupt" << std::endl;
+            close();
+            return false;
+        }
+
+        data_offset = header.data_offset;
+        surface_count = header.surface_count;
+
+        return true;
+    }
+
+    bool SplatCacheFile::write(const std::string& file_path, size_t surface_count, const std::function<void(GaussianSurface* destination)>& writer)
+    {
+        const uint64_t data_offset = align_up(sizeof(SplatCacheHeader), cache_alignment);
+        const uint64_t file_size = align_up(data_offset + sizeof(GaussianSurface) * surface_count, cache_alignment);
+
+        //Written under a temporary name and renamed once complete, so an interrupted write never leaves a cache
+        //that is newer than its source and passes the header check
+        const std::string temp_path = file_path + ".tmp";
+
+        const std::filesystem::path directory = std::filesystem::path(file_path).parent_path();
+        if (!directory.empty())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+            if (error)
+            {
+                std::cerr << "Failed to create splat cache directory " << directory.string() << ": " << error.message() << std::endl;
+                return false;
+            }
+        }
+
+        {
+            SplatCacheFile cache_file;
+            if (!cache_file.map_file(temp_path, file_size, true))
+            {
+                return false;
+            }
+
+            writer(reinterpret_cast<GaussianSurface*>(static_cast<char*>(cache_file.mapping) + data_offset));
+
+            //The header goes last and only after the surfaces reached the file
+            SplatCacheHeader header{};
+            memcpy(header.magic, cache_magic, sizeof(cache_magic));
+            header.version = cache_version;
+            header.surface_size = sizeof(GaussianSurface);
+            header.surface_count = surface_count;
+            header.data_offset = data_offset;
+
+            bool flushed = cache_file.flush();
+            memcpy(cache_file.mapping, &header, sizeof(header));
+            flushed = flushed && cache_file.flush();
+
+            if (!flushed)
+            {
+                std::cerr << "Failed to flush splat cache: " << file_path << std::endl;
+                cache_file.close();
+
+                std::error_code error;
+                std::filesystem::remove(temp_path, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temp_path, file_path, error);
+        if (error)
+        {
+            std::cerr << "Failed to move splat cache into place: " << file_path << std::endl;
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string SplatCacheFile::get_cache_path(const std::string& source_path)
+    {
+        std::error_code error;
+        std::filesystem::path absolute_path = std::filesystem::absolute(source_path, error);
+        if (error)
+        {
+            absolute_path = source_path;
+        }
+
+        std::ostringstream file_name;
+        file_name << absolute_path.stem().string() << '-' << std::hex << std::setw(16) << std::setfill('0')
+                  << hash_path(absolute_path.lexically_normal().string()) << cache_extension;
+
+        return (get_cache_directory() / file_name.str()).string();
+    }
+
+    std::filesystem::path SplatCacheFile::get_cache_directory()
+    {
+#ifdef _WIN32
+        const char* local_app_data = std::getenv("LOCALAPPDATA");
+        if (local_app_data != nullptr && *local_app_data != '\0')
+        {
+            return std::filesystem::path(local_app_data) / cache_directory_name;
+        }
+#else
+        const char* xdg_cache_home = std::getenv("XDG_CACHE_HOME");
+        if (xdg_cache_home != nullptr && *xdg_cache_home != '\0')
+        {
+            return std::filesystem::path(xdg_cache_home) / cache_directory_name;
+        }
+
+        const char* home = std::getenv("HOME");
+        if (home != nullptr && *home != '\0')
+        {
+            return std::filesystem::path(home) / ".cache" / cache_directory_name;
+        }
+#endif
+
+        std::error_code error;
+        return std::filesystem::temp_directory_path(error) / cache_directory_name;
+    }
+
+    bool SplatCacheFile::is_cache_file(const std::string& file_path)
+    {
+        return std::filesystem::path(file_path).extension() == cache_extension;
+    }
+
+    bool SplatCacheFile::is_up_to_date(const std::string& cache_path, const std::string& source_path)
+    {
+        std::error_code cache_error;
+        std::error_code source_error;
+        auto cache_time = std::filesystem::last_write_time(cache_path, cache_error);
+        auto source_time = std::filesystem::last_write_time(source_path, source_error);
+
+        return !cache_error && !source_error && cache_time >= source_time;
+    }
+
+    const GaussianSurface* SplatCacheFile::get_surfaces() const
+    {
+        return mapping != nullptr ? reinterpret_cast<const GaussianSurface*>(static_cast<const char*>(mapping) + data_offset) : nullptr;
+    }
+
+#ifdef _WIN32
+    bool SplatCacheFile::map_file(const std::string& file_path, uint64_t size, bool create)
+    {
+        file_handle = CreateFileA(file_path.c_str(), create ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            file_handle = nullptr;
+            std::cerr << "Failed to open splat cache: " << file_path << std::endl;
+            return false;
+        }
+
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, create ? PAGE_READWRITE : PAGE_WRITECOPY,
+                                            static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+        if (mapping_handle != nullptr)
+        {
+            mapping = MapViewOfFile(mapping_handle, create ? FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, static_cast<SIZE_T>(size));
+        }
+
+        if (mapping == nullptr)
+        {
+            std::cerr << "Failed to map splat cache: " << file_path << std::endl;
+            close();
+            return false;
+        }
+
+        mapping_size = size;
+        return true;
+    }
+
+    bool SplatCacheFile::flush() const
+    {
+        return FlushViewOfFile(mapping, static_cast<SIZE_T>(mapping_size)) && FlushFileBuffers(file_handle);
+    }
+
+    void SplatCacheFile::close()
+    {
+        if (mapping != nullptr)
+        {
+            UnmapViewOfFile(mapping);
+        }
+
+        if (mapping_handle != nullptr)
+        {
+            CloseHandle(mapping_handle);
+        }
+
+        if (file_handle != nullptr)
+        {
+            CloseHandle(file_handle);
+        }
+
+        mapping = nullptr;
+        mapping_handle = nullptr;
+        file_handle = nullptr;
+        mapping_size = 0;
+        data_offset = 0;
+        surface_count = 0;
+    }
+#else
+    bool SplatCacheFile::map_file(const std::string& file_path, uint64_t size, bool create)
+    {
+        file_descriptor = create ? ::open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(file_path.c_str(), O_RDONLY);
+        if (file_descriptor < 0)
+        {
+            std::cerr << "Failed to open splat cache: " << file_path << std::endl;
+            return false;
+        }
+
+        if (create && ftruncate(file_descriptor, static_cast<off_t>(size)) != 0)
+        {
+            std::cerr << "Failed to size splat cache: " << file_path << std::endl;
+            close();
+            return false;
+        }
+
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, create ? MAP_SHARED : MAP_PRIVATE, file_descriptor, 0);
+        if (address == MAP_FAILED)
+        {
+            std::cerr << "Failed to map splat cache: " << file_path << std::endl;
+            close();
+            return false;
+        }
+
+        mapping = address;
+        mapping_size = size;
+        return true;
+    }
+
+    bool SplatCacheFile::flush() const
+    {
+        return msync(mapping, mapping_size, MS_SYNC) == 0;
+    }
+
+    void SplatCacheFile::close()
+    {
+        if (mapping != nullptr)
+        {
+            munmap(mapping, mapping_size);
+        }
+
+        if (file_descriptor >= 0)
+        {
+            ::close(file_descriptor);
+        }
+
+        mapping = nullptr;
+        file_descriptor = -1;
+        mapping_size = 0;
+        data_offset = 0;
+        surface_count = 0;
+    }
+#endif
+}
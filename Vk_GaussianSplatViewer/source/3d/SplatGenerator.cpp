@@ -0,0 +1,476 @@
+#include "3d/SplatGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <glm/gtc/constants.hpp>
+
+#include "core/CpuProfiler.h"
+
+#include "3d/SplatCacheFile.h"
+
+namespace splat_loader
+{
+    namespace
+    {
+        //Zeroth order SH basis, converts between f_dc and linear color
+        constexpr float sh_c0 = 0.28209479177387814f;
+
+        //PLY property order, identical to the GaussianSurface layout
+        static_assert(sizeof(GaussianSurface) == 62 * sizeof(float), "GaussianSurface no longer matches the PLY vertex layout");
+
+        float logit(float value)
+        {
+            value = std::clamp(value, 0.001f, 0.999f);
+            return std::log(value / (1.0f - value));
+        }
+
+        //Rotation (w, x, y, z) turning +z onto normal
+        glm::vec4 get_rotation_to(const glm::vec3& normal)
+        {
+            const float cos_angle = normal.z;
+            if (cos_angle < -0.9999f)
+            {
+                return { 0.0f, 1.0f, 0.0f, 0.0f };
+            }
+
+            const glm::vec3 axis = glm::cross(glm::vec3(0.0f, 0.0f, 1.0f), normal);
+            return glm::normalize(glm::vec4(1.0f + cos_angle, axis));
+        }
+
+        bool parse_value_distribution(const char* text, ValueDistribution& out_distribution)
+        {
+            char type[16]{};
+            float a = 0.0f;
+            float b = 0.0f;
+
+            //constant:a, uniform:a,b or lognormal:median,sigma
+            const int fields = sscanf(text, "%15[a-z]:%f,%f", type, &a, &b);
+            if (fields >= 2 && strcmp(type, "constant") == 0)
+            {
+                out_distribution = { ValueDistribution::Type::Constant, a, a };
+                return true;
+            }
+            if (fields == 3 && strcmp(type, "uniform") == 0)
+            {
+                out_distribution = { ValueDistribution::Type::Uniform, a, b };
+                return true;
+            }
+            if (fields == 3 && strcmp(type, "lognormal") == 0)
+            {
+                out_distribution = { ValueDistribution::Type::LogNormal, a, b };
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    float ValueDistribution::sample(std::mt19937& rng) const
+    {
+        switch (type)
+        {
+        case Type::Constant:
+            return a;
+        case Type::Uniform:
+            return std::uniform_real_distribution<float>(a, b)(rng);
+        case Type::LogNormal:
+            return std::exp(std::normal_distribution<float>(std::log(a), b)(rng));
+        }
+
+        return a;
+    }
+
+    void SplatGenerator::generate(const SplatGeneratorParams& params, GaussianSurface* destination)
+    {
+        const std::vector<glm::vec3> cluster_centers = create_cluster_centers(params);
+        generate_chunks(params, cluster_centers, 0, (params.count + chunk_size - 1) / chunk_size, destination);
+    }
+
+    void SplatGenerator::generate(const SplatGeneratorParams& params, size_t first, size_t count, GaussianSurface* destination)
+    {
+        const std::vector<glm::vec3> cluster_centers = create_cluster_centers(params);
+        const size_t end = std::min(first + count, params.count);
+
+        std::vector<GaussianSurface> partial_chunk;
+
+        for (size_t surface = first; surface < end;)
+        {
+            const size_t chunk_index = surface / chunk_size;
+            const size_t chunk_start = chunk_index * chunk_size;
+            const size_t chunk_end = std::min(chunk_start + chunk_size, params.count);
+
+            if (surface == chunk_start && chunk_end <= end)
+            {
+                //Every chunk that ends inside the range, including the short last chunk of the scene
+                size_t chunk_count = (end - surface) / chunk_size;
+                if (end == params.count && (end - surface) % chunk_size != 0)
+                {
+                    chunk_count++;
+                }
+
+                generate_chunks(params, cluster_centers, chunk_index, chunk_count, destination + (surface - first));
+
+                surface = std::min(surface + chunk_count * chunk_size, params.count);
+                continue;
+            }
+
+            //The RNG stream of a chunk is sequential, so the surfaces before the range are generated too
+            const size_t range_end = std::min(chunk_end, end);
+            if (surface == chunk_start)
+            {
+                generate_chunk(params, cluster_centers, chunk_index, destination + (surface - first), range_end - chunk_start);
+            }
+            else
+            {
+                partial_chunk.resize(range_end - chunk_start);
+                generate_chunk(params, cluster_centers, chunk_index, partial_chunk.data(), partial_chunk.size());
+                memcpy(destination + (surface - first), partial_chunk.data() + (surface - chunk_start), sizeof(GaussianSurface) * (range_end - surface));
+            }
+
+            surface = range_end;
+        }
+    }
+
+    std::vector<GaussianSurface> SplatGenerator::generate(const SplatGeneratorParams& params)
+    {
+        std::vector<GaussianSurface> surfaces(params.count);
+        generate(params, surfaces.data());
+
+        return surfaces;
+    }
+
+    bool SplatGenerator::write_ply(const std::string& file_path, const SplatGeneratorParams& params)
+    {
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "Failed to write " << file_path << std::endl;
+            return false;
+        }
+
+        file << "ply\nformat binary_little_endian 1.0\n";
+        file << "comment gsv synthetic seed " << params.seed << "\n";
+        file << "element vertex " << params.count << "\n";
+
+        for (const char* name : { "x", "y", "z", "nx", "ny", "nz", "f_dc_0", "f_dc_1", "f_dc_2" })
+        {
+            file << "property float " << name << "\n";
+        }
+        for (int i = 0; i < 45; ++i)
+        {
+            file << "property float f_rest_" << i << "\n";
+        }
+        for (const char* name : { "opacity", "scale_0", "scale_1", "scale_2", "rot_0", "rot_1", "rot_2", "rot_3" })
+        {
+            file << "property float " << name << "\n";
+        }
+        file << "end_header\n";
+
+        //A few chunks per thread are generated while the previous batch is on its way to disk
+        const std::vector<glm::vec3> cluster_centers = create_cluster_centers(params);
+        const size_t total_chunks = (params.count + chunk_size - 1) / chunk_size;
+        const size_t batch_chunks = static_cast<size_t>(get_thread_count(params)) * 4;
+
+        std::vector<GaussianSurface> batch(std::min(batch_chunks * chunk_size, params.count));
+
+        for (size_t first_chunk = 0; first_chunk < total_chunks; first_chunk += batch_chunks)
+        {
+            const size_t chunk_count = std::min(batch_chunks, total_chunks - first_chunk);
+            const size_t surface_count = std::min(chunk_count * chunk_size, params.count - first_chunk * chunk_size);
+
+            generate_chunks(params, cluster_centers, first_chunk, chunk_count, batch.data());
+            file.write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(surface_count * sizeof(GaussianSurface)));
+        }
+
+        if (!file)
+        {
+            std::cerr << "Failed to write " << file_path << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SplatGenerator::write(const std::string& file_path, const SplatGeneratorParams& params)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        bool written;
+        if (SplatCacheFile::is_cache_file(file_path))
+        {
+            written = SplatCacheFile::write(file_path, params.count, [&params](GaussianSurface* destination)
+            {
+                generate(params, destination);
+            });
+        }
+        else
+        {
+            written = write_ply(file_path, params);
+        }
+
+        if (written)
+        {
+            const float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+            std::cout << "Generated " << params.count << " splats into " << file_path << " in " << seconds << " s\n";
+        }
+
+        return written;
+    }
+
+    bool SplatGenerator::parse_argument(const std::string& name, const char* value, SplatGeneratorParams& params)
+    {
+        if (name == "--count")
+        {
+            params.count = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+        }
+        else if (name == "--seed")
+        {
+            params.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else if (name == "--distribution")
+        {
+            const std::string distribution = value;
+            if (distribution == "uniform")
+            {
+                params.distribution = SplatDistribution::Uniform;
+            }
+            else if (distribution == "clustered")
+            {
+                params.distribution = SplatDistribution::Clustered;
+            }
+            else if (distribution == "surface")
+            {
+                params.distribution = SplatDistribution::Surface;
+            }
+            else
+            {
+                std::cerr << "Unknown splat distribution " << distribution << std::endl;
+                return false;
+            }
+        }
+        else if (name == "--extent")
+        {
+            params.extent = std::strtof(value, nullptr);
+        }
+        else if (name == "--clusters")
+        {
+            params.cluster_count = std::max(static_cast<uint32_t>(std::strtoul(value, nullptr, 10)), 1u);
+        }
+        else if (name == "--cluster-radius")
+        {
+            params.cluster_radius = std::strtof(value, nullptr);
+        }
+        else if (name == "--scale")
+        {
+            if (!parse_value_distribution(value, params.scale))
+            {
+                std::cerr << "Invalid scale distribution " << value << std::endl;
+                return false;
+            }
+        }
+        else if (name == "--opacity")
+        {
+            if (!parse_value_distribution(value, params.opacity))
+            {
+                std::cerr << "Invalid opacity distribution " << value << std::endl;
+                return false;
+            }
+        }
+        else if (name == "--sh-degree")
+        {
+            params.sh_degree = std::min(static_cast<uint32_t>(std::strtoul(value, nullptr, 10)), 3u);
+        }
+        else if (name == "--threads")
+        {
+            params.thread_count = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    const char* SplatGenerator::get_usage()
+    {
+        return "  --count N                       splats to generate (default 1000000)\n"
+               "  --seed N                        RNG seed (default 1)\n"
+               "  --distribution uniform|clustered|surface\n"
+               "  --extent E                      half size of the scene (default 2)\n"
+               "  --clusters N --cluster-radius R clustered layout, radius relative to the extent\n"
+               "  --scale constant:a|uniform:a,b|lognormal:median,sigma     world space splat size\n"
+               "  --opacity constant:a|uniform:a,b|lognormal:median,sigma\n"
+               "  --sh-degree 0-3                 highest filled SH band (default 3)\n"
+               "  --threads N                     generator threads (default all)\n";
+    }
+
+    std::vector<glm::vec3> SplatGenerator::create_cluster_centers(const SplatGeneratorParams& params)
+    {
+        if (params.distribution != SplatDistribution::Clustered)
+        {
+            return {};
+        }
+
+        //Separate stream from the chunks, so the centers do not depend on the count
+        std::seed_seq seed{ params.seed, 0xC1u };
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> position(-params.extent, params.extent);
+
+        std::vector<glm::vec3> centers(params.cluster_count);
+        for (auto& center : centers)
+        {
+            center = glm::vec3(position(rng), position(rng), position(rng));
+        }
+
+        return centers;
+    }
+
+    void SplatGenerator::generate_chunk(const SplatGeneratorParams& params, const std::vector<glm::vec3>& cluster_centers, size_t chunk_index,
+                                        GaussianSurface* destination, size_t count)
+    {
+        std::seed_seq seed{ params.seed, static_cast<uint32_t>(chunk_index), static_cast<uint32_t>(chunk_index >> 32) };
+        std::mt19937 rng(seed);
+
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float> signed_unit(-1.0f, 1.0f);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+
+        //Highest filled f_rest coefficient per channel: 3, 8 or 15 for degrees 1 to 3
+        const uint32_t sh_coefficients = (params.sh_degree + 1) * (params.sh_degree + 1) - 1;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            //Assembled on the stack and stored as a whole
+            GaussianSurface surface{};
+
+            glm::vec3 position(0.0f);
+            glm::vec3 surface_normal(0.0f, 0.0f, 1.0f);
+            glm::vec4 rotation(1.0f, 0.0f, 0.0f, 0.0f);
+            bool is_flat = false;
+
+            switch (params.distribution)
+            {
+            case SplatDistribution::Uniform:
+                position = glm::vec3(signed_unit(rng), signed_unit(rng), signed_unit(rng)) * params.extent;
+                break;
+
+            case SplatDistribution::Clustered:
+                {
+                    const size_t cluster = std::min(static_cast<size_t>(unit(rng) * static_cast<float>(cluster_centers.size())),
+                                                    cluster_centers.size() - 1);
+                    position = cluster_centers[cluster] + glm::vec3(normal(rng), normal(rng), normal(rng)) * params.cluster_radius * params.extent;
+                }
+                break;
+
+            case SplatDistribution::Surface:
+                //Two thirds on a sphere, the rest on the ground plane below it
+                if (unit(rng) < 0.667f)
+                {
+                    surface_normal = glm::normalize(glm::vec3(normal(rng), normal(rng), normal(rng)) + glm::vec3(0.0f, 0.0f, 1e-6f));
+                    position = surface_normal * params.extent * 0.5f;
+                }
+                else
+                {
+                    surface_normal = glm::vec3(0.0f, 1.0f, 0.0f);
+                    position = glm::vec3(signed_unit(rng) * params.extent, -params.extent * 0.5f, signed_unit(rng) * params.extent);
+                }
+                rotation = get_rotation_to(surface_normal);
+                is_flat = true;
+                break;
+            }
+
+            if (params.distribution != SplatDistribution::Surface)
+            {
+                const float angle = unit(rng) * glm::pi<float>();
+                const glm::vec3 axis = glm::normalize(glm::vec3(normal(rng), normal(rng), normal(rng)) + glm::vec3(1e-6f));
+                rotation = glm::vec4(std::cos(angle), axis * std::sin(angle));
+            }
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                surface.position[axis] = position[axis];
+                surface.normal[axis] = surface_normal[axis];
+
+                //Surface splats are thin along their local z, which the rotation turned onto the normal
+                float scale = std::max(params.scale.sample(rng), 1e-6f);
+                if (is_flat && axis == 2)
+                {
+                    scale *= 0.05f;
+                }
+                surface.scale[axis] = std::log(scale);
+
+                surface.f_dc[axis] = (unit(rng) - 0.5f) / sh_c0;
+            }
+
+            for (uint32_t k = 0; k < sh_coefficients; ++k)
+            {
+                //Higher bands carry less energy
+                const float band = std::floor(std::sqrt(static_cast<float>(k + 1)));
+                const float amplitude = 0.2f / band;
+
+                for (uint32_t channel = 0; channel < 3; ++channel)
+                {
+                    surface.f_rest[channel * 15 + k] = normal(rng) * amplitude;
+                }
+            }
+
+            surface.opacity = logit(params.opacity.sample(rng));
+
+            for (int c = 0; c < 4; ++c)
+            {
+                surface.rotation[c] = rotation[c];
+            }
+
+            destination[i] = surface;
+        }
+    }
+
+    void SplatGenerator::generate_chunks(const SplatGeneratorParams& params, const std::vector<glm::vec3>& cluster_centers, size_t first_chunk,
+                                         size_t chunk_count, GaussianSurface* destination)
+    {
+        std::atomic<size_t> next_chunk = 0;
+
+        auto worker = [&]
+        {
+            for (size_t local_chunk = next_chunk++; local_chunk < chunk_count; local_chunk = next_chunk++)
+            {
+                const size_t chunk_index = first_chunk + local_chunk;
+                const size_t first_surface = chunk_index * chunk_size;
+                const size_t count = std::min(chunk_size, params.count - first_surface);
+
+                GSV_CPU_ZONE("Generate chunk");
+                generate_chunk(params, cluster_centers, chunk_index, destination + local_chunk * chunk_size, count);
+            }
+        };
+
+        const uint32_t thread_count = static_cast<uint32_t>(std::min<size_t>(get_thread_count(params), chunk_count));
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < thread_count; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+
+        //The calling thread works too
+        worker();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    uint32_t SplatGenerator::get_thread_count(const SplatGeneratorParams& params)
+    {
+        return params.thread_count != 0 ? params.thread_count : std::max(std::thread::hardware_concurrency(), 1u);
+    }
+}
@@ -0,0 +1,267 @@
+#include "batch/BatchRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "camera/FirstPersonCamera.h"
+#include "core/CpuProfiler.h"
+#include "core/Engine.h"
+#include "renderer/RenderPass.h"
+#include "structs/EngineContext.h"
+#include "structs/FrameReadback.h"
+
+namespace batch
+{
+    BatchRenderer::BatchRenderer(BatchOptions options) : options(std::move(options))
+    {
+    }
+
+    bool BatchRenderer::parse_arguments(int argc, char** argv, BatchOptions& out_options)
+    {
+        std::vector<std::string> positional;
+
+        for (int i = 0; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const bool has_value = i + 1 < argc;
+
+            if (argument == "--format" && has_value)
+            {
+                const std::string format = argv[++i];
+                if (format != "png" && format != "exr")
+                {
+                    std::cerr << "Unknown image format " << format << std::endl;
+                    return false;
+                }
+                out_options.format = format == "exr" ? ImageFormat::EXR : ImageFormat::PNG;
+            }
+            else if (argument == "--width" && has_value)
+            {
+                out_options.width = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (argument == "--height" && has_value)
+            {
+                out_options.height = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (argument == "--frames-in-flight" && has_value)
+            {
+                out_options.frames_in_flight = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (argument == "--threads" && has_value)
+            {
+                out_options.encoder_threads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (argument == "--cpu-trace" && has_value)
+            {
+                out_options.cpu_trace_path = argv[++i];
+            }
+            else if (argument.starts_with("--"))
+            {
+                std::cerr << "Unknown or incomplete option " << argument << std::endl;
+                return false;
+            }
+            else
+            {
+                positional.push_back(argument);
+            }
+        }
+
+        if (positional.size() != 3 || out_options.width == 0 || out_options.height == 0 || out_options.frames_in_flight == 0)
+        {
+            return false;
+        }
+
+        out_options.scene_path = positional[0];
+        out_options.camera_path = positional[1];
+        out_options.output_directory = positional[2];
+
+        return true;
+    }
+
+    void BatchRenderer::print_usage()
+    {
+        std::cout << "Usage: Vk_GaussianSplatViewer --batch <scene.ply|.gsvcache> <poses.json|poses.csv> <output dir>\n"
+                     "                              [--format png|exr] [--width N] [--height N] [--frames-in-flight N] [--threads N]\n"
+                     "                              [--cpu-trace <trace.json>]\n";
+    }
+
+    int BatchRenderer::run()
+    {
+        if (!CameraPath::load(options.camera_path, poses))
+        {
+            return 1;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(options.output_directory, error);
+        if (error)
+        {
+            std::cerr << "Cannot create output directory " << options.output_directory << std::endl;
+            return 1;
+        }
+
+        core::Engine engine;
+        engine.init_headless(options.width, options.height, options.frames_in_flight);
+
+        EngineContext& engine_context = engine.get_engine_context();
+
+        //Same path as the load button in the UI
+        engine_context.ui_action_manager->queue_string_action(UIAction::ALLOCATE_SPLAT_MEMORY, options.scene_path);
+        engine_context.ui_action_manager->process_queued_actions();
+
+        if (engine_context.buffer_container->gaussian_count == 0)
+        {
+            std::cerr << "Failed to load scene " << options.scene_path << std::endl;
+            engine.cleanup();
+            return 1;
+        }
+
+        const uint32_t hardware_threads = std::max(std::thread::hardware_concurrency(), 2u);
+        start_encoders(options.encoder_threads != 0 ? options.encoder_threads : hardware_threads - 1);
+
+        auto* render_pass = engine_context.renderer->get_render_pass();
+        auto* camera = engine_context.renderer->get_camera();
+        render_pass->set_readback_callback([this](const FrameReadback& readback) { queue_frame(readback); });
+
+        std::cout << "Rendering " << poses.size() << " views of " << options.scene_path << " at " << options.width << "x" << options.height
+                  << " with " << encoders.size() << " encoder threads\n";
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (size_t i = 0; i < poses.size(); ++i)
+        {
+            CameraPath::apply(poses[i], *camera, options.width, options.height);
+
+            //Carried with the submitted frame, a frame that fails to submit cannot shift later images onto the wrong pose
+            render_pass->set_frame_tag(static_cast<int64_t>(i));
+            engine_context.renderer->renderer_update();
+        }
+
+        render_pass->flush_readbacks();
+        render_pass->set_frame_tag(-1);
+        auto render_end = std::chrono::high_resolution_clock::now();
+
+        stop_and_join_encoders();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        render_pass->set_readback_callback(nullptr);
+        camera->clear_pose_overrides();
+
+        const double render_seconds = std::chrono::duration<double>(render_end - start).count();
+        const double total_seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << "Wrote " << written_count << " images to " << options.output_directory << " in " << total_seconds << " s ("
+                  << (total_seconds > 0.0 ? written_count / total_seconds : 0.0) << " images/s, rendering alone "
+                  << (render_seconds > 0.0 ? poses.size() / render_seconds : 0.0) << " views/s)\n";
+
+        if (failed_count > 0)
+        {
+            std::cerr << failed_count << " images failed to write" << std::endl;
+        }
+
+        if (!options.cpu_trace_path.empty())
+        {
+            core::CpuProfiler::write_chrome_trace(options.cpu_trace_path);
+        }
+
+        engine.cleanup();
+
+        return failed_count == 0 ? 0 : 1;
+    }
+
+    void BatchRenderer::start_encoders(uint32_t thread_count)
+    {
+        thread_count = std::max(thread_count, 1u);
+
+        //Enough to keep every encoder busy; beyond that the render thread waits instead of piling up frames
+        max_queued_jobs = static_cast<size_t>(thread_count) * 2;
+        stop_encoders = false;
+
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            encoders.emplace_back(&BatchRenderer::encoder_loop, this);
+        }
+    }
+
+    void BatchRenderer::stop_and_join_encoders()
+    {
+        {
+            std::lock_guard lock(jobs_mutex);
+            stop_encoders = true;
+        }
+        jobs_available.notify_all();
+
+        for (auto& encoder : encoders)
+        {
+            encoder.join();
+        }
+        encoders.clear();
+    }
+
+    void BatchRenderer::encoder_loop()
+    {
+        core::CpuProfiler::set_thread_name("Encoder");
+
+        while (true)
+        {
+            EncodeJob job;
+            {
+                std::unique_lock lock(jobs_mutex);
+                jobs_available.wait(lock, [this] { return stop_encoders || !jobs.empty(); });
+
+                //Drain what is queued before stopping
+                if (jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            jobs_space.notify_one();
+
+            GSV_CPU_ZONE("Encode image");
+            const bool written = ImageWriter::write(job.file_path, options.format, job.pixels.data(), job.width, job.height);
+
+            std::lock_guard lock(jobs_mutex);
+            if (written)
+            {
+                written_count++;
+            }
+            else
+            {
+                failed_count++;
+            }
+        }
+    }
+
+    void BatchRenderer::queue_frame(const FrameReadback& readback)
+    {
+        //Untagged frames (warm up, ...) are not written out
+        if (readback.tag < 0 || static_cast<size_t>(readback.tag) >= poses.size())
+        {
+            return;
+        }
+
+        const CameraPose& pose = poses[static_cast<size_t>(readback.tag)];
+
+        EncodeJob job;
+        job.file_path = (std::filesystem::path(options.output_directory) / (pose.name + ImageWriter::get_extension(options.format))).string();
+        job.width = readback.extent.width;
+        job.height = readback.extent.height;
+        job.pixels.resize(static_cast<size_t>(readback.size));
+        memcpy(job.pixels.data(), readback.pixels, job.pixels.size());
+
+        {
+            GSV_CPU_ZONE("Wait encoder queue");
+            std::unique_lock lock(jobs_mutex);
+            jobs_space.wait(lock, [this] { return jobs.size() < max_queued_jobs; });
+            jobs.push_back(std::move(job));
+        }
+        jobs_available.notify_one();
+    }
+}
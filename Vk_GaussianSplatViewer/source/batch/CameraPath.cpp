@@ -0,0 +1,225 @@
+#include "batch/CameraPath.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+#include "camera/FirstPersonCamera.h"
+
+namespace batch
+{
+    bool CameraPath::load(const std::string& file_path, std::vector<CameraPose>& out_poses)
+    {
+        out_poses.clear();
+
+        std::string extension = std::filesystem::path(file_path).extension().string();
+        for (auto& c : extension)
+        {
+            c = static_cast<char>(tolower(c));
+        }
+
+        const bool loaded = extension == ".csv" ? load_csv(file_path, out_poses) : load_json(file_path, out_poses);
+        if (loaded && out_poses.empty())
+        {
+            std::cerr << "Camera path " << file_path << " contains no poses" << std::endl;
+            return false;
+        }
+
+        return loaded;
+    }
+
+    void CameraPath::apply(const CameraPose& pose, camera::FirstPersonCamera& camera, uint32_t width, uint32_t height)
+    {
+        camera.clear_pose_overrides();
+        camera.set_aspect_ratio(static_cast<float>(width) / static_cast<float>(height));
+        camera.set_fov(pose.fov);
+
+        if (pose.has_view_matrix)
+        {
+            camera.set_view_matrix(pose.view);
+        }
+        else
+        {
+            camera.set_position(pose.position);
+            camera.set_orientation(pose.yaw, pose.pitch);
+        }
+
+        if (pose.has_intrinsics)
+        {
+            camera.set_intrinsics(pose.fx, pose.fy, pose.cx, pose.cy, static_cast<float>(width), static_cast<float>(height));
+        }
+    }
+
+    bool CameraPath::load_json(const std::string& file_path, std::vector<CameraPose>& out_poses)
+    {
+        std::ifstream file(file_path);
+        if (!file)
+        {
+            std::cerr << "Failed to open camera path " << file_path << std::endl;
+            return false;
+        }
+
+        nlohmann::json document = nlohmann::json::parse(file, nullptr, false);
+        if (document.is_discarded())
+        {
+            std::cerr << "Camera path " << file_path << " is not valid JSON" << std::endl;
+            return false;
+        }
+
+        const nlohmann::json& frames = document.is_object() && document.contains("frames") ? document["frames"] : document;
+        if (!frames.is_array())
+        {
+            std::cerr << "Camera path " << file_path << " has no frame array" << std::endl;
+            return false;
+        }
+
+        for (const auto& frame : frames)
+        {
+            CameraPose pose;
+            pose.name = frame.value("name", get_default_name(out_poses.size()));
+            pose.yaw = frame.value("yaw", pose.yaw);
+            pose.pitch = frame.value("pitch", pose.pitch);
+            pose.fov = frame.value("fov", pose.fov);
+
+            if (frame.contains("position") && frame["position"].size() == 3)
+            {
+                const auto& position = frame["position"];
+                pose.position = glm::vec3(position[0].get<float>(), position[1].get<float>(), position[2].get<float>());
+            }
+
+            if (frame.contains("view") && frame["view"].size() == 16)
+            {
+                const auto& view = frame["view"];
+                for (int i = 0; i < 16; ++i)
+                {
+                    pose.view[i / 4][i % 4] = view[i].get<float>();
+                }
+                pose.has_view_matrix = true;
+            }
+
+            if (frame.contains("intrinsics"))
+            {
+                const auto& intrinsics = frame["intrinsics"];
+                pose.fx = intrinsics.value("fx", 0.0f);
+                pose.fy = intrinsics.value("fy", pose.fx);
+                pose.cx = intrinsics.value("cx", 0.0f);
+                pose.cy = intrinsics.value("cy", 0.0f);
+                pose.has_intrinsics = pose.fx > 0.0f && pose.fy > 0.0f;
+            }
+
+            out_poses.push_back(pose);
+        }
+
+        return true;
+    }
+
+    bool CameraPath::load_csv(const std::string& file_path, std::vector<CameraPose>& out_poses)
+    {
+        std::ifstream file(file_path);
+        if (!file)
+        {
+            std::cerr << "Failed to open camera path " << file_path << std::endl;
+            return false;
+        }
+
+        auto split = [](const std::string& line)
+        {
+            std::vector<std::string> fields;
+            std::stringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, ','))
+            {
+                //Trim spaces and a trailing \r from Windows line endings
+                const size_t first = field.find_first_not_of(" \t\r");
+                const size_t last = field.find_last_not_of(" \t\r");
+                fields.push_back(first == std::string::npos ? std::string() : field.substr(first, last - first + 1));
+            }
+            return fields;
+        };
+
+        std::unordered_map<std::string, size_t> columns;
+        std::string line;
+        size_t line_number = 0;
+
+        while (std::getline(file, line))
+        {
+            line_number++;
+            if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos)
+            {
+                continue;
+            }
+
+            const std::vector<std::string> fields = split(line);
+
+            if (columns.empty())
+            {
+                for (size_t i = 0; i < fields.size(); ++i)
+                {
+                    columns[fields[i]] = i;
+                }
+
+                if (!columns.contains("x") || !columns.contains("y") || !columns.contains("z"))
+                {
+                    std::cerr << "Camera path " << file_path << " needs x, y and z columns" << std::endl;
+                    return false;
+                }
+                continue;
+            }
+
+            auto get = [&](const char* column, float fallback, bool* present = nullptr)
+            {
+                const auto it = columns.find(column);
+                if (it == columns.end() || it->second >= fields.size() || fields[it->second].empty())
+                {
+                    return fallback;
+                }
+
+                if (present != nullptr)
+                {
+                    *present = true;
+                }
+                return std::strtof(fields[it->second].c_str(), nullptr);
+            };
+
+            CameraPose pose;
+            const auto name_column = columns.find("name");
+            pose.name = name_column != columns.end() && name_column->second < fields.size() && !fields[name_column->second].empty()
+                            ? fields[name_column->second]
+                            : get_default_name(out_poses.size());
+
+            pose.position = glm::vec3(get("x", 0.0f), get("y", 0.0f), get("z", 0.0f));
+            pose.yaw = get("yaw", pose.yaw);
+            pose.pitch = get("pitch", pose.pitch);
+            pose.fov = get("fov", pose.fov);
+
+            bool has_fx = false;
+            pose.fx = get("fx", 0.0f, &has_fx);
+            pose.fy = get("fy", pose.fx);
+            pose.cx = get("cx", 0.0f);
+            pose.cy = get("cy", 0.0f);
+            pose.has_intrinsics = has_fx && pose.fx > 0.0f && pose.fy > 0.0f;
+
+            if (fields.size() < columns.size())
+            {
+                std::cerr << "Camera path " << file_path << ": line " << line_number << " has missing columns" << std::endl;
+            }
+
+            out_poses.push_back(pose);
+        }
+
+        return true;
+    }
+
+    std::string CameraPath::get_default_name(size_t index)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "%05zu", index);
+        return name;
+    }
+}
@@ -0,0 +1,156 @@
+#include "batch/ImageWriter.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <glm/gtc/packing.hpp>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace batch
+{
+    namespace
+    {
+        //sRGB byte -> linear half float, the swapchain format stores sRGB encoded values
+        const std::array<uint16_t, 256>& get_srgb_to_half_table()
+        {
+            static const std::array<uint16_t, 256> table = []
+            {
+                std::array<uint16_t, 256> values{};
+                for (int i = 0; i < 256; ++i)
+                {
+                    const float srgb = static_cast<float>(i) / 255.0f;
+                    const float linear = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+                    values[i] = glm::packHalf1x16(linear);
+                }
+                return values;
+            }();
+
+            return table;
+        }
+
+        template <typename T>
+        void append_value(std::vector<uint8_t>& bytes, const T& value)
+        {
+            const auto* data = reinterpret_cast<const uint8_t*>(&value);
+            bytes.insert(bytes.end(), data, data + sizeof(T));
+        }
+    }
+
+    bool ImageWriter::write(const std::string& file_path, ImageFormat format, const uint8_t* rgba, uint32_t width, uint32_t height)
+    {
+        return format == ImageFormat::EXR ? write_exr(file_path, rgba, width, height) : write_png(file_path, rgba, width, height);
+    }
+
+    bool ImageWriter::write_png(const std::string& file_path, const uint8_t* rgba, uint32_t width, uint32_t height)
+    {
+        if (stbi_write_png(file_path.c_str(), static_cast<int>(width), static_cast<int>(height), 4, rgba, static_cast<int>(width * 4)) == 0)
+        {
+            std::cerr << "Failed to write " << file_path << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ImageWriter::write_exr(const std::string& file_path, const uint8_t* rgba, uint32_t width, uint32_t height)
+    {
+        //OpenEXR stores little endian values, like every platform this viewer runs on
+        std::vector<uint8_t> header;
+        append_value(header, static_cast<uint32_t>(20000630));
+        append_value(header, static_cast<uint32_t>(2));
+
+        //Channel list, sorted by name as the format requires: name, pixel type (1 = HALF), pLinear + reserved, x/y sampling
+        std::vector<uint8_t> channels;
+        for (const char* channel : { "A", "B", "G", "R" })
+        {
+            channels.insert(channels.end(), channel, channel + strlen(channel) + 1);
+            append_value(channels, static_cast<int32_t>(1));
+            append_value(channels, static_cast<uint32_t>(0));
+            append_value(channels, static_cast<int32_t>(1));
+            append_value(channels, static_cast<int32_t>(1));
+        }
+        channels.push_back(0);
+        append_attribute(header, "channels", "chlist", channels.data(), static_cast<uint32_t>(channels.size()));
+
+        const uint8_t compression = 0;
+        append_attribute(header, "compression", "compression", &compression, 1);
+
+        const int32_t window[4] = { 0, 0, static_cast<int32_t>(width) - 1, static_cast<int32_t>(height) - 1 };
+        append_attribute(header, "dataWindow", "box2i", window, sizeof(window));
+        append_attribute(header, "displayWindow", "box2i", window, sizeof(window));
+
+        const uint8_t line_order = 0;
+        append_attribute(header, "lineOrder", "lineOrder", &line_order, 1);
+
+        const float pixel_aspect_ratio = 1.0f;
+        append_attribute(header, "pixelAspectRatio", "float", &pixel_aspect_ratio, sizeof(float));
+
+        const float screen_window_center[2] = { 0.0f, 0.0f };
+        append_attribute(header, "screenWindowCenter", "v2f", screen_window_center, sizeof(screen_window_center));
+
+        const float screen_window_width = 1.0f;
+        append_attribute(header, "screenWindowWidth", "float", &screen_window_width, sizeof(float));
+        header.push_back(0);
+
+        //One uncompressed block per scanline: y, byte count, then every channel's row in channel list order
+        const uint32_t row_size = width * 4 * sizeof(uint16_t);
+        const uint64_t block_size = sizeof(int32_t) * 2 + row_size;
+        const uint64_t first_block = header.size() + sizeof(uint64_t) * height;
+
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            append_value(header, first_block + block_size * y);
+        }
+
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "Failed to write " << file_path << std::endl;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+        const auto& srgb_to_half = get_srgb_to_half_table();
+        std::vector<uint16_t> row(static_cast<size_t>(width) * 4);
+
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint8_t* source = rgba + static_cast<size_t>(y) * width * 4;
+
+            //A, B, G, R planes. Alpha is already linear
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                row[x] = glm::packHalf1x16(static_cast<float>(source[x * 4 + 3]) / 255.0f);
+                row[width + x] = srgb_to_half[source[x * 4 + 2]];
+                row[width * 2 + x] = srgb_to_half[source[x * 4 + 1]];
+                row[width * 3 + x] = srgb_to_half[source[x * 4]];
+            }
+
+            const int32_t block_header[2] = { static_cast<int32_t>(y), static_cast<int32_t>(row_size) };
+            file.write(reinterpret_cast<const char*>(block_header), sizeof(block_header));
+            file.write(reinterpret_cast<const char*>(row.data()), row_size);
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    const char* ImageWriter::get_extension(ImageFormat format)
+    {
+        return format == ImageFormat::EXR ? ".exr" : ".png";
+    }
+
+    void ImageWriter::append_attribute(std::vector<uint8_t>& header, const char* name, const char* type, const void* data, uint32_t size)
+    {
+        header.insert(header.end(), name, name + strlen(name) + 1);
+        header.insert(header.end(), type, type + strlen(type) + 1);
+        append_value(header, size);
+
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        header.insert(header.end(), bytes, bytes + size);
+    }
+}
@@ -0,0 +1,14 @@
+#include "bench/Benchmark.h"
+
+int main(int argc, char** argv)
+{
+    bench::BenchOptions options;
+    if (!bench::Benchmark::parse_arguments(argc - 1, argv + 1, options))
+    {
+        bench::Benchmark::print_usage();
+        return 1;
+    }
+
+    bench::Benchmark benchmark(options);
+    return benchmark.run();
+}
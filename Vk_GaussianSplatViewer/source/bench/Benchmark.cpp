@@ -0,0 +1,380 @@
+#include "bench/Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "camera/FirstPersonCamera.h"
+#include "core/CpuProfiler.h"
+#include "core/Engine.h"
+#include "renderer/RenderPass.h"
+#include "structs/EngineContext.h"
+
+//Generated at build time with GSV_GIT_COMMIT
+#include "bench/GitCommit.h"
+
+namespace bench
+{
+    namespace
+    {
+        bool parse_list(const char* text, std::vector<uint32_t>& out_values)
+        {
+            out_values.clear();
+
+            std::stringstream stream(text);
+            std::string item;
+            while (std::getline(stream, item, ','))
+            {
+                if (!item.empty())
+                {
+                    out_values.push_back(static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10)));
+                }
+            }
+
+            return !out_values.empty();
+        }
+
+        bool parse_vec3(const char* text, glm::vec3& out_value)
+        {
+            return sscanf(text, "%f,%f,%f", &out_value.x, &out_value.y, &out_value.z) == 3;
+        }
+    }
+
+    Benchmark::Benchmark(BenchOptions options) : options(std::move(options))
+    {
+        spline = CameraSpline::create_orbit(this->options.orbit_center, this->options.orbit_radius);
+    }
+
+    bool Benchmark::parse_arguments(int argc, char** argv, BenchOptions& out_options)
+    {
+        for (int i = 0; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (value == nullptr)
+            {
+                std::cerr << "Missing value for " << argument << std::endl;
+                return false;
+            }
+            i++;
+
+            if (argument == "--scene")
+            {
+                out_options.scene_path = value;
+            }
+            else if (argument == "--synthetic")
+            {
+                out_options.synthetic.count = static_cast<size_t>(std::strtoull(value, nullptr, 10));
+            }
+            else if (argument == "--width")
+            {
+                out_options.width = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (argument == "--height")
+            {
+                out_options.height = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (argument == "--frames-in-flight")
+            {
+                out_options.frames_in_flight = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (argument == "--warmup")
+            {
+                out_options.warmup_frames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (argument == "--frames")
+            {
+                out_options.frames = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            }
+            else if (argument == "--center")
+            {
+                if (!parse_vec3(value, out_options.orbit_center))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--radius")
+            {
+                out_options.orbit_radius = std::strtof(value, nullptr);
+            }
+            else if (argument == "--render-mode")
+            {
+                if (strcmp(value, "raster") != 0 && strcmp(value, "tile") != 0)
+                {
+                    return false;
+                }
+                out_options.render_mode = strcmp(value, "tile") == 0 ? RenderMode::TileCompute : RenderMode::HardwareRaster;
+            }
+            else if (argument == "--pipelines")
+            {
+                out_options.mesh_shader_modes.clear();
+                if (strstr(value, "vertex") != nullptr)
+                {
+                    out_options.mesh_shader_modes.push_back(false);
+                }
+                if (strstr(value, "mesh") != nullptr)
+                {
+                    out_options.mesh_shader_modes.push_back(true);
+                }
+                if (out_options.mesh_shader_modes.empty())
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--sh")
+            {
+                if (!parse_list(value, out_options.sh_degrees))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--output")
+            {
+                out_options.output_path = value;
+            }
+            else if (argument == "--cpu-trace")
+            {
+                out_options.cpu_trace_path = value;
+            }
+            else if (!splat_loader::SplatGenerator::parse_argument(argument, value, out_options.synthetic))
+            {
+                std::cerr << "Unknown option " << argument << std::endl;
+                return false;
+            }
+        }
+
+        //The gaussian count is a 32 bit value on the GPU
+        return out_options.width > 0 && out_options.height > 0 && out_options.frames > 0 && out_options.frames_in_flight > 0 &&
+               (!out_options.scene_path.empty() || (out_options.synthetic.count > 0 && out_options.synthetic.count <= UINT32_MAX));
+    }
+
+    void Benchmark::print_usage()
+    {
+        std::cout << "Usage: gsv_bench [--scene file.ply|.gsvcache | --synthetic N] [--width N] [--height N]\n"
+                     "                 [--frames N] [--warmup N] [--frames-in-flight N] [--center x,y,z] [--radius R]\n"
+                     "                 [--render-mode raster|tile] [--pipelines vertex,mesh] [--sh 0,1,2,3] [--output report.json]\n"
+                     "                 [--cpu-trace trace.json]\n"
+                     "Synthetic scene options:\n"
+                  << splat_loader::SplatGenerator::get_usage()
+                  << "Runs without a window, e.g. on lavapipe: VK_DRIVER_FILES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json gsv_bench\n";
+    }
+
+    int Benchmark::run()
+    {
+        core::Engine engine;
+        engine.init_headless(options.width, options.height, options.frames_in_flight);
+
+        EngineContext& engine_context = engine.get_engine_context();
+
+        if (!load_scene(engine_context))
+        {
+            engine.cleanup();
+            return 1;
+        }
+
+        engine_context.ui_action_manager->queue_int_action(UIAction::SET_RENDER_MODE, static_cast<int>(options.render_mode));
+
+        std::vector<RunResult> results;
+        for (bool mesh_shaders : options.mesh_shader_modes)
+        {
+            if (mesh_shaders && !engine_context.device_manager->is_mesh_shader_supported())
+            {
+                std::cerr << "Mesh shaders not supported, skipping mesh runs" << std::endl;
+                continue;
+            }
+
+            for (uint32_t sh_degree : options.sh_degrees)
+            {
+                results.push_back(run_configuration(engine_context, mesh_shaders, sh_degree));
+            }
+        }
+
+        if (!options.cpu_trace_path.empty())
+        {
+            core::CpuProfiler::write_chrome_trace(options.cpu_trace_path);
+        }
+
+        const std::string report = create_report(engine_context, results).dump(2);
+
+        if (options.output_path.empty())
+        {
+            std::cout << report << std::endl;
+        }
+        else
+        {
+            std::ofstream file(options.output_path, std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Failed to write " << options.output_path << std::endl;
+                engine.cleanup();
+                return 1;
+            }
+
+            file << report << std::endl;
+            std::cout << "Benchmark report written to " << options.output_path << "\n";
+        }
+
+        engine.cleanup();
+
+        return 0;
+    }
+
+    bool Benchmark::load_scene(EngineContext& engine_context) const
+    {
+        if (options.scene_path.empty())
+        {
+            create_synthetic_scene(engine_context, options.synthetic);
+        }
+        else
+        {
+            engine_context.ui_action_manager->queue_string_action(UIAction::ALLOCATE_SPLAT_MEMORY, options.scene_path);
+            engine_context.ui_action_manager->process_queued_actions();
+        }
+
+        if (engine_context.buffer_container->gaussian_count == 0)
+        {
+            std::cerr << "Failed to load scene " << options.scene_path << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    void Benchmark::create_synthetic_scene(EngineContext& engine_context, const splat_loader::SplatGeneratorParams& params)
+    {
+        engine_context.dispatch_table.deviceWaitIdle();
+
+        //Generated straight into the gaussian buffer when it is host visible, otherwise into the staging ring chunks
+        engine_context.buffer_container->allocate_gaussian_surface_buffer(params.count, [&params](GaussianSurface* destination, size_t first, size_t count)
+        {
+            splat_loader::SplatGenerator::generate(params, first, count, destination);
+        });
+    }
+
+    Benchmark::RunResult Benchmark::run_configuration(EngineContext& engine_context, bool mesh_shaders, uint32_t sh_degree) const
+    {
+        using clock = std::chrono::high_resolution_clock;
+
+        RunResult result;
+        result.mesh_shaders = mesh_shaders;
+        result.sh_degree = sh_degree;
+
+        auto* ui_action_manager = engine_context.ui_action_manager.get();
+        ui_action_manager->queue_bool_action(UIAction::TOGGLE_MESH_SHADERS, mesh_shaders);
+        ui_action_manager->queue_int_action(UIAction::SET_SH_DEGREE, static_cast<int>(sh_degree));
+        ui_action_manager->process_queued_actions();
+
+        auto* renderer = engine_context.renderer.get();
+        auto* render_pass = renderer->get_render_pass();
+        auto* camera = renderer->get_camera();
+
+        //Builds the shader variants and fills the caches, also runs the start of the path so the first measured frames are not special
+        for (uint32_t frame = 0; frame < options.warmup_frames; ++frame)
+        {
+            spline.apply(*camera, frame, options.frames);
+            renderer->renderer_update();
+        }
+
+        for (auto* stats : { &result.cpu_ms, &result.frame_ms, &result.gpu_ms, &result.gpu_compute_ms, &result.gpu_graphics_ms })
+        {
+            stats->reserve(options.frames);
+        }
+
+        auto previous_start = clock::now();
+
+        for (uint32_t frame = 0; frame < options.frames; ++frame)
+        {
+            auto frame_start = clock::now();
+
+            spline.apply(*camera, frame, options.frames);
+            renderer->renderer_update();
+
+            auto frame_end = clock::now();
+
+            //Time blocked on the frame slot is the GPU being the bottleneck, not CPU work
+            const float update_ms = std::chrono::duration<float, std::milli>(frame_end - frame_start).count();
+            result.cpu_ms.add(std::max(update_ms - render_pass->get_slot_wait_ms(), 0.0f));
+
+            if (frame > 0)
+            {
+                result.frame_ms.add(std::chrono::duration<float, std::milli>(frame_start - previous_start).count());
+            }
+            previous_start = frame_start;
+
+            //Read back when the slot was reused, so these belong to the frame frames_in_flight submissions earlier
+            if (render_pass->has_queue_timestamps())
+            {
+                const float compute_ms = render_pass->get_compute_queue_ms();
+                const float graphics_ms = render_pass->get_graphics_queue_ms();
+
+                result.gpu_compute_ms.add(compute_ms);
+                result.gpu_graphics_ms.add(graphics_ms);
+                result.gpu_ms.add(render_pass->is_async_compute_active() ? std::max(compute_ms, graphics_ms) : compute_ms + graphics_ms);
+            }
+        }
+
+        render_pass->flush_readbacks();
+
+        const FrameStats::Summary frame_summary = result.frame_ms.summarize();
+        std::cerr << (mesh_shaders ? "mesh" : "vertex") << " SH " << sh_degree << ": frame mean " << frame_summary.mean << " ms, p99 "
+                  << frame_summary.p99 << " ms\n";
+
+        return result;
+    }
+
+    nlohmann::json Benchmark::create_report(EngineContext& engine_context, const std::vector<RunResult>& results) const
+    {
+        const auto physical_device = engine_context.device_manager->get_physical_device();
+
+        nlohmann::json report;
+        report["commit"] = GSV_GIT_COMMIT;
+        report["device"] = physical_device.properties.deviceName;
+        report["driver_version"] = physical_device.properties.driverVersion;
+        report["scene"] = options.scene_path.empty() ? "synthetic" : options.scene_path;
+        if (options.scene_path.empty())
+        {
+            const char* distributions[] = { "uniform", "clustered", "surface" };
+            report["synthetic"] = {
+                { "seed", options.synthetic.seed },
+                { "distribution", distributions[static_cast<int>(options.synthetic.distribution)] },
+                { "sh_degree", options.synthetic.sh_degree }
+            };
+        }
+        report["gaussian_count"] = engine_context.buffer_container->gaussian_count;
+        report["width"] = options.width;
+        report["height"] = options.height;
+        report["frames_in_flight"] = options.frames_in_flight;
+        report["warmup_frames"] = options.warmup_frames;
+        report["frames"] = options.frames;
+        report["render_mode"] = options.render_mode == RenderMode::TileCompute ? "tile" : "raster";
+
+        nlohmann::json runs = nlohmann::json::array();
+        for (const auto& result : results)
+        {
+            nlohmann::json run;
+            run["pipeline"] = result.mesh_shaders ? "mesh" : "vertex";
+            run["sh_degree"] = result.sh_degree;
+            run["cpu_ms"] = result.cpu_ms.to_json();
+            run["frame_ms"] = result.frame_ms.to_json();
+
+            if (!result.gpu_ms.empty())
+            {
+                run["gpu_ms"] = result.gpu_ms.to_json();
+                run["gpu_compute_ms"] = result.gpu_compute_ms.to_json();
+                run["gpu_graphics_ms"] = result.gpu_graphics_ms.to_json();
+            }
+
+            runs.push_back(run);
+        }
+        report["runs"] = runs;
+
+        return report;
+    }
+}
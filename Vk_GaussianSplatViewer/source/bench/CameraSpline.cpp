@@ -0,0 +1,91 @@
+#include "bench/CameraSpline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "camera/FirstPersonCamera.h"
+
+namespace bench
+{
+    namespace
+    {
+        glm::vec3 catmull_rom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t)
+        {
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+
+            return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+        }
+    }
+
+    CameraSpline::CameraSpline(std::vector<ControlPoint> control_points) : control_points(std::move(control_points))
+    {
+    }
+
+    CameraSpline CameraSpline::create_orbit(const glm::vec3& center, float radius, uint32_t control_point_count)
+    {
+        std::vector<ControlPoint> points;
+        control_point_count = std::max(control_point_count, 4u);
+
+        for (uint32_t i = 0; i < control_point_count; ++i)
+        {
+            const float angle = glm::two_pi<float>() * static_cast<float>(i) / static_cast<float>(control_point_count);
+            const bool is_odd = i % 2 == 1;
+
+            const float point_radius = radius * (is_odd ? 0.6f : 1.0f);
+            const float height = radius * (is_odd ? 0.25f : -0.1f);
+
+            ControlPoint point;
+            point.position = center + glm::vec3(std::cos(angle) * point_radius, height, std::sin(angle) * point_radius);
+            point.target = center;
+            points.push_back(point);
+        }
+
+        return CameraSpline(std::move(points));
+    }
+
+    CameraSpline::ControlPoint CameraSpline::evaluate(float t) const
+    {
+        if (control_points.empty())
+        {
+            return {};
+        }
+
+        const auto count = static_cast<int>(control_points.size());
+        const float segment_position = (t - std::floor(t)) * static_cast<float>(count);
+        const int segment = std::min(static_cast<int>(segment_position), count - 1);
+        const float local_t = segment_position - static_cast<float>(segment);
+
+        auto point = [&](int offset) -> const ControlPoint&
+        {
+            return control_points[(segment + offset + count) % count];
+        };
+
+        ControlPoint result;
+        result.position = catmull_rom(point(-1).position, point(0).position, point(1).position, point(2).position, local_t);
+        result.target = catmull_rom(point(-1).target, point(0).target, point(1).target, point(2).target, local_t);
+
+        return result;
+    }
+
+    void CameraSpline::apply(camera::FirstPersonCamera& camera, uint32_t frame, uint32_t frame_count) const
+    {
+        const ControlPoint sample = evaluate(static_cast<float>(frame) / static_cast<float>(std::max(frame_count, 1u)));
+        glm::vec3 direction = sample.target - sample.position;
+
+        if (glm::length(direction) < 1e-6f)
+        {
+            direction = glm::vec3(0.0f, 0.0f, -1.0f);
+        }
+        direction = glm::normalize(direction);
+
+        //Inverse of FirstPersonCamera::update_camera_vectors
+        const float yaw = glm::degrees(std::atan2(direction.z, direction.x));
+        const float pitch = glm::degrees(std::asin(glm::clamp(direction.y, -1.0f, 1.0f)));
+
+        camera.clear_pose_overrides();
+        camera.set_position(sample.position);
+        camera.set_orientation(yaw, glm::clamp(pitch, -89.0f, 89.0f));
+    }
+}
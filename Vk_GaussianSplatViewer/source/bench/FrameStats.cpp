@@ -0,0 +1,51 @@
+#include "bench/FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace bench
+{
+    FrameStats::Summary FrameStats::summarize() const
+    {
+        Summary summary;
+        if (samples.empty())
+        {
+            return summary;
+        }
+
+        std::vector<float> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        summary.count = sorted.size();
+        summary.mean = static_cast<float>(std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size()));
+        summary.p50 = get_percentile(sorted, 50.0f);
+        summary.p95 = get_percentile(sorted, 95.0f);
+        summary.p99 = get_percentile(sorted, 99.0f);
+        summary.min = sorted.front();
+        summary.max = sorted.back();
+
+        return summary;
+    }
+
+    nlohmann::json FrameStats::to_json() const
+    {
+        const Summary summary = summarize();
+
+        return {
+            { "mean", summary.mean },
+            { "p50", summary.p50 },
+            { "p95", summary.p95 },
+            { "p99", summary.p99 },
+            { "min", summary.min },
+            { "max", summary.max },
+            { "samples", summary.count }
+        };
+    }
+
+    float FrameStats::get_percentile(const std::vector<float>& sorted, float percentile)
+    {
+        const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0f * static_cast<float>(sorted.size())));
+        return sorted[std::clamp(rank, static_cast<size_t>(1), sorted.size()) - 1];
+    }
+}
@@ -27,12 +27,25 @@ namespace camera
     }
 
     glm::mat4 FirstPersonCamera::get_view_matrix() const {
+        if (has_view_override) {
+            return view_override;
+        }
+
         return glm::lookAt(position, position + front, up);
     }
 
     glm::mat4 FirstPersonCamera::get_projection_matrix() const {
         glm::mat4 proj = glm::perspective(glm::radians(fov), aspect_ratio, near_plane, far_plane);
         proj[1][1] *= -1; // Flip Y for Vulkan
+
+        // Same depth mapping, scale and principal point taken from the intrinsics (image y grows downwards like Vulkan NDC)
+        if (has_intrinsics) {
+            proj[0][0] = 2.0f * focal_and_center.x / image_size.x;
+            proj[1][1] = -2.0f * focal_and_center.y / image_size.y;
+            proj[2][0] = 1.0f - 2.0f * focal_and_center.z / image_size.x;
+            proj[2][1] = 1.0f - 2.0f * focal_and_center.w / image_size.y;
+        }
+
         return proj;
     }
 
@@ -106,6 +119,31 @@ namespace camera
         fov = field_of_view;
     }
 
+    void FirstPersonCamera::set_orientation(float yaw_degrees, float pitch_degrees) {
+        yaw = yaw_degrees;
+        pitch = pitch_degrees;
+        update_camera_vectors();
+    }
+
+    void FirstPersonCamera::set_view_matrix(const glm::mat4& view) {
+        view_override = view;
+        has_view_override = true;
+
+        // The color cache and culling still need the camera position
+        position = glm::vec3(glm::inverse(view)[3]);
+    }
+
+    void FirstPersonCamera::set_intrinsics(float fx, float fy, float cx, float cy, float width, float height) {
+        focal_and_center = glm::vec4(fx, fy, cx, cy);
+        image_size = glm::vec2(width, height);
+        has_intrinsics = true;
+    }
+
+    void FirstPersonCamera::clear_pose_overrides() {
+        has_view_override = false;
+        has_intrinsics = false;
+    }
+
     glm::vec3 FirstPersonCamera::get_position() const {
         return position;
     }
@@ -0,0 +1,237 @@
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "config/Config.inl"
+
+namespace core
+{
+    namespace
+    {
+        static_assert((cpu_profiler_events_per_thread & (cpu_profiler_events_per_thread - 1)) == 0,
+                      "cpu_profiler_events_per_thread must be a power of two");
+
+        //Fields are relaxed atomics so a flush reading a slot the owner is overwriting is not a data race.
+        //Such slots are detected through the write count and dropped
+        struct ZoneEvent
+        {
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<int64_t> start_ns{ 0 };
+            std::atomic<int64_t> end_ns{ 0 };
+        };
+
+        struct ThreadBuffer
+        {
+            uint32_t thread_id = 0;
+            std::string thread_name;
+            std::unique_ptr<ZoneEvent[]> events = std::make_unique<ZoneEvent[]>(cpu_profiler_events_per_thread);
+
+            //Only the owning thread writes it, published with release after the event
+            std::atomic<uint64_t> write_count{ 0 };
+
+            //Cleared when the owning thread exits, the next new thread takes the buffer over
+            bool in_use = true;
+        };
+
+        struct CopiedEvent
+        {
+            const char* name;
+            int64_t start_ns;
+            int64_t end_ns;
+        };
+
+        //Buffers outlive their threads so short lived workers (loaders, encoders) still show up in later traces.
+        //Threads started later reuse them, so worker pools spawned per call do not grow the registry
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        };
+
+        Registry& get_registry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        struct ThreadBufferOwner
+        {
+            ThreadBuffer* buffer = nullptr;
+
+            ~ThreadBufferOwner()
+            {
+                if (buffer != nullptr)
+                {
+                    std::lock_guard lock(get_registry().mutex);
+                    buffer->in_use = false;
+                }
+            }
+        };
+
+        thread_local ThreadBufferOwner thread_buffer;
+
+        ThreadBuffer& get_thread_buffer()
+        {
+            if (thread_buffer.buffer == nullptr)
+            {
+                Registry& registry = get_registry();
+                std::lock_guard lock(registry.mutex);
+
+                auto free_buffer = std::find_if(registry.buffers.begin(), registry.buffers.end(), [](const auto& buffer) { return !buffer->in_use; });
+                if (free_buffer != registry.buffers.end())
+                {
+                    thread_buffer.buffer = free_buffer->get();
+                }
+                else
+                {
+                    registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+                    thread_buffer.buffer = registry.buffers.back().get();
+                    thread_buffer.buffer->thread_id = static_cast<uint32_t>(registry.buffers.size() - 1);
+                }
+
+                thread_buffer.buffer->in_use = true;
+                thread_buffer.buffer->thread_name = "Thread " + std::to_string(thread_buffer.buffer->thread_id);
+            }
+
+            return *thread_buffer.buffer;
+        }
+
+        //Names are literals or thread names we set, only quotes and backslashes need escaping
+        void write_json_string(std::ostream& out, const char* text)
+        {
+            out << '"';
+            for (const char* c = text; *c != '\0'; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    out << '\\';
+                }
+                out << *c;
+            }
+            out << '"';
+        }
+    }
+
+    void CpuProfiler::set_thread_name(const std::string& name)
+    {
+        ThreadBuffer& buffer = get_thread_buffer();
+
+        std::lock_guard lock(get_registry().mutex);
+        buffer.thread_name = name;
+    }
+
+    void CpuProfiler::record(const char* name, int64_t start_ns, int64_t end_ns)
+    {
+        ThreadBuffer& buffer = get_thread_buffer();
+
+        const uint64_t index = buffer.write_count.load(std::memory_order_relaxed);
+        ZoneEvent& event = buffer.events[index & (cpu_profiler_events_per_thread - 1)];
+
+        //A flush that sees any field of this event also sees write_count >= index, see write_chrome_trace
+        std::atomic_thread_fence(std::memory_order_release);
+
+        event.name.store(name, std::memory_order_relaxed);
+        event.start_ns.store(start_ns, std::memory_order_relaxed);
+        event.end_ns.store(end_ns, std::memory_order_relaxed);
+
+        buffer.write_count.store(index + 1, std::memory_order_release);
+    }
+
+    int64_t CpuProfiler::now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool CpuProfiler::write_chrome_trace(const std::string& file_path)
+    {
+        std::ofstream file(file_path, std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "Failed to write CPU trace " << file_path << std::endl;
+            return false;
+        }
+
+        Registry& registry = get_registry();
+        std::lock_guard lock(registry.mutex);
+
+        std::vector<std::vector<CopiedEvent>> thread_events(registry.buffers.size());
+        int64_t first_ns = INT64_MAX;
+        size_t event_count = 0;
+
+        for (size_t t = 0; t < registry.buffers.size(); ++t)
+        {
+            const ThreadBuffer& buffer = *registry.buffers[t];
+
+            const uint64_t end = buffer.write_count.load(std::memory_order_acquire);
+            const uint64_t begin = end > cpu_profiler_events_per_thread ? end - cpu_profiler_events_per_thread : 0;
+
+            std::vector<CopiedEvent>& events = thread_events[t];
+            events.reserve(end - begin);
+
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                const ZoneEvent& event = buffer.events[i & (cpu_profiler_events_per_thread - 1)];
+                events.push_back({ event.name.load(std::memory_order_relaxed), event.start_ns.load(std::memory_order_relaxed),
+                                   event.end_ns.load(std::memory_order_relaxed) });
+            }
+
+            //Slots the owner wrapped around to while they were copied hold mixed events. The one being written
+            //(index end_after_copy) counts as overwritten too
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t end_after_copy = buffer.write_count.load(std::memory_order_relaxed);
+            if (end_after_copy + 1 > cpu_profiler_events_per_thread)
+            {
+                const uint64_t overwritten = std::min(end_after_copy + 1 - cpu_profiler_events_per_thread, end);
+                if (overwritten > begin)
+                {
+                    events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(overwritten - begin));
+                }
+            }
+
+            for (const auto& event : events)
+            {
+                first_ns = std::min(first_ns, event.start_ns);
+            }
+            event_count += events.size();
+        }
+
+        //Complete ("X") events in microseconds, relative to the oldest retained event
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first_entry = true;
+        for (size_t t = 0; t < registry.buffers.size(); ++t)
+        {
+            const ThreadBuffer& buffer = *registry.buffers[t];
+
+            file << (first_entry ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.thread_id
+                 << ",\"args\":{\"name\":";
+            write_json_string(file, buffer.thread_name.c_str());
+            file << "}}";
+            first_entry = false;
+
+            for (const auto& event : thread_events[t])
+            {
+                file << ",\n{\"name\":";
+                write_json_string(file, event.name);
+                file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.thread_id
+                     << ",\"ts\":" << static_cast<double>(event.start_ns - first_ns) / 1000.0
+                     << ",\"dur\":" << static_cast<double>(event.end_ns - event.start_ns) / 1000.0 << "}";
+            }
+        }
+
+        file << "\n]}\n";
+
+        std::cout << "CPU trace with " << event_count << " zones written to " << file_path << std::endl;
+
+        return true;
+    }
+}
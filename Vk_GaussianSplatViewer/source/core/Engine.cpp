@@ -1,7 +1,10 @@
 ﻿#include "core/Engine.h"
 #include <chrono>
 
+#include <iostream>
+
 #include "3d/ModelUtils.h"
+#include "core/CpuProfiler.h"
 #include "vulkanapp/VulkanCleanupQueue.h"
 #include "config/Config.inl"
 #include "renderer/Renderer.h"
@@ -17,9 +20,15 @@ void core::Engine::create_window() const
     engine_context->window_manager->create_window_sdl3(window_create_params, true);
 }
 
-void core::Engine::create_renderer() const
+void core::Engine::create_renderer(const VkExtent2D* offscreen_extent, uint32_t max_frames_in_flight) const
 {
-    engine_context->renderer = std::make_unique<renderer::Renderer>(*engine_context);
+    engine_context->renderer = std::make_unique<renderer::Renderer>(*engine_context, max_frames_in_flight);
+
+    if (offscreen_extent)
+    {
+        engine_context->renderer->set_headless(*offscreen_extent);
+    }
+
     engine_context->renderer->renderer_init();
 }
 
@@ -31,6 +40,17 @@ void core::Engine::create_ui_and_input() const
     // Initialize input manager
     engine_context->input_manager = std::make_unique<input::InputManager>();
     engine_context->input_manager->set_camera_mouse_button(SDL_BUTTON_RIGHT);
+
+    engine_context->ui_action_manager->register_action(UIAction::EXPORT_CPU_TRACE, []()
+    {
+        if (!CpuProfiler::is_compiled_in())
+        {
+            std::cout << "CPU profiler zones are compiled out, configure with GSV_CPU_PROFILER=ON" << std::endl;
+            return;
+        }
+
+        CpuProfiler::write_chrome_trace(cpu_trace_file);
+    });
 }
 
 void core::Engine::create_buffer_container() const
@@ -41,11 +61,16 @@ void core::Engine::create_buffer_container() const
 void core::Engine::create_cleanup() const
 {
     engine_context->renderer->cleanup_init();
-    vulkanapp::VulkanCleanupQueue::push_cleanup_function(CLEANUP_FUNCTION(engine_context->window_manager->destroy_window_sdl3()));
+
+    if (engine_context->window_manager)
+    {
+        vulkanapp::VulkanCleanupQueue::push_cleanup_function(CLEANUP_FUNCTION(engine_context->window_manager->destroy_window_sdl3()));
+    }
 }
 
 void core::Engine::init()
 {
+    CpuProfiler::set_thread_name("Main");
     engine_context = std::make_unique<EngineContext>();
     
     create_window();
@@ -55,6 +80,20 @@ void core::Engine::init()
     create_cleanup();
 }
 
+void core::Engine::init_headless(uint32_t width, uint32_t height, uint32_t max_frames_in_flight)
+{
+    CpuProfiler::set_thread_name("Main");
+    engine_context = std::make_unique<EngineContext>();
+
+    //UI actions still drive the render settings, there is just no UI queuing them
+    create_ui_and_input();
+    create_buffer_container();
+
+    VkExtent2D offscreen_extent = { width, height };
+    create_renderer(&offscreen_extent, max_frames_in_flight);
+    create_cleanup();
+}
+
 void core::Engine::process_input(bool& is_running, camera::FirstPersonCamera* camera, double delta_time) const
 {
     engine_context->input_manager->process_input(is_running, camera, delta_time);
@@ -74,6 +113,8 @@ void core::Engine::run() const
 
     while (is_running)
     {
+        GSV_CPU_ZONE("Frame");
+
         auto current_time = std::chrono::high_resolution_clock::now();
         std::chrono::duration<float> elapsed = current_time - previous_time;
         double delta_time = elapsed.count();
@@ -1,9 +1,46 @@
 #include "3d/ModelUtils.h"
+#include "3d/SplatGenerator.h"
+#include "batch/BatchRenderer.h"
 #include "core/Engine.h"
+#include <cstring>
 #include <iostream>
 
-int main()
+int main(int argc, char** argv)
 {
+    //Offline rendering of a camera path, no window
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0)
+    {
+        batch::BatchOptions options;
+        if (!batch::BatchRenderer::parse_arguments(argc - 2, argv + 2, options))
+        {
+            batch::BatchRenderer::print_usage();
+            return 1;
+        }
+
+        batch::BatchRenderer batch_renderer(options);
+        return batch_renderer.run();
+    }
+
+    //Synthetic scene for benchmarks: --generate <out.ply|out.gsvcache> [generator options]
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0)
+    {
+        splat_loader::SplatGeneratorParams params;
+        bool valid = argc > 2 && argc % 2 == 1;
+
+        for (int i = 3; valid && i + 1 < argc; i += 2)
+        {
+            valid = splat_loader::SplatGenerator::parse_argument(argv[i], argv[i + 1], params);
+        }
+
+        if (!valid || params.count == 0)
+        {
+            std::cout << "Usage: Vk_GaussianSplatViewer --generate <out.ply|out.gsvcache> [options]\n" << splat_loader::SplatGenerator::get_usage();
+            return 1;
+        }
+
+        return splat_loader::SplatGenerator::write(argv[2], params) ? 0 : 1;
+    }
+
     core::Engine engine;
     engine.init();
 
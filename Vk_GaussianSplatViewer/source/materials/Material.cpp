@@ -22,6 +22,11 @@ namespace material
         this->shader_object = std::move(shader_object);
     }
 
+    void Material::add_pipeline_object(std::unique_ptr<PipelineObject> pipeline_object)
+    {
+        this->pipeline_object = std::move(pipeline_object);
+    }
+
     void Material::add_pipeline_layout(VkPipelineLayout pipeline_layout)
     {
         this->pipeline_layout = pipeline_layout;
@@ -32,6 +37,17 @@ namespace material
         this->descriptor_set = descriptor_set;
     }
 
+    void Material::bind(VkCommandBuffer command_buffer) const
+    {
+        if (pipeline_object)
+        {
+            pipeline_object->bind(engine_context.dispatch_table, command_buffer);
+            return;
+        }
+
+        shader_object->bind_material_shader(engine_context.dispatch_table, command_buffer);
+    }
+
     void Material::cleanup()
     {
         if (pipeline_layout != VK_NULL_HANDLE)
@@ -44,5 +60,10 @@ namespace material
         {
             shader_object->destroy_shaders(engine_context.dispatch_table);
         }
+
+        if (pipeline_object)
+        {
+            pipeline_object->destroy(engine_context.dispatch_table);
+        }
     }
 }
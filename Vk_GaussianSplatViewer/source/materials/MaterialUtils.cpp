@@ -1,8 +1,10 @@
 ﻿#include "materials/MaterialUtils.h"
 #include "materials/Material.h"
+#include "materials/PipelineCache.h"
 #include "../../include/structs/scene/PushConstantBlock.h"
 #include "vulkanapp/utils/DescriptorUtils.h"
 #include "vulkanapp/utils/FileUtils.h"
+#include "vulkanapp/utils/RenderUtils.h"
 #include "structs/EngineContext.h"
 
 namespace material
@@ -21,11 +23,6 @@ namespace material
         utils::FileUtils::loadShader(vertex_shader_path, shaderCodes[0], shaderCodeSizes[0]);
         utils::FileUtils::loadShader(fragment_shader_path, shaderCodes[1], shaderCodeSizes[1]);
 
-        auto shader_object = std::make_unique<ShaderObject>();
-        shader_object->create_shaders(engine_context.dispatch_table, shaderCodes[0], shaderCodeSizes[0], shaderCodes[1], shaderCodeSizes[1],
-            nullptr, 0,
-            &push_constant_range, 1);
-
         VkPipelineLayout pipeline_layout;
 
         //Create the pipeline layout
@@ -34,9 +31,195 @@ namespace material
 
         //Create material
         auto material = make_shared<Material>(name, engine_context);
-        material->add_shader_object(std::move(shader_object));
         material->add_pipeline_layout(pipeline_layout);
 
+        if (use_shader_objects())
+        {
+            auto shader_object = std::make_unique<ShaderObject>();
+            shader_object->create_shaders(engine_context.dispatch_table, shaderCodes[0], shaderCodeSizes[0], shaderCodes[1], shaderCodeSizes[1],
+                nullptr, 0,
+                &push_constant_range, 1,
+                engine_context.shader_binary_cache.get());
+
+            material->add_shader_object(std::move(shader_object));
+        }
+        else
+        {
+            //Splats are drawn as points
+            auto pipeline_object = std::make_unique<PipelineObject>();
+            pipeline_object->create_graphics_pipeline(engine_context.dispatch_table, get_pipeline_cache(), pipeline_layout,
+                shaderCodes[0], shaderCodeSizes[0],
+                shaderCodes[1], shaderCodeSizes[1],
+                get_graphics_state(VK_POLYGON_MODE_POINT));
+
+            material->add_pipeline_object(std::move(pipeline_object));
+        }
+
+        for (auto* shader_code : shaderCodes)
+        {
+            delete[] shader_code;
+        }
+
+        return material;
+    }
+
+    std::shared_ptr<Material> MaterialUtils::create_compute_material(const std::string& name, const std::string& compute_shader_path,
+                                                                     uint32_t push_constant_size,
+                                                                     const VkDescriptorSetLayout* set_layouts,
+                                                                     uint32_t set_layout_count,
+                                                                     const VkSpecializationInfo* specialization_info) const
+    {
+        VkPushConstantRange push_constant_range{};
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset = 0;
+        push_constant_range.size = push_constant_size;
+
+        size_t shader_code_size = 0;
+        char* shader_code = nullptr;
+
+        utils::FileUtils::loadShader(compute_shader_path, shader_code, shader_code_size);
+
+        VkPipelineLayout pipeline_layout;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = utils::DescriptorUtils::pipeline_layout_create_info(set_layouts, set_layout_count, &push_constant_range, 1);
+        engine_context.dispatch_table.createPipelineLayout(&pipelineLayoutInfo, VK_NULL_HANDLE, &pipeline_layout);
+
+        auto material = make_shared<Material>(name, engine_context);
+        material->add_pipeline_layout(pipeline_layout);
+
+        if (use_shader_objects())
+        {
+            auto shader_object = std::make_unique<ShaderObject>();
+            shader_object->create_compute_shader(engine_context.dispatch_table, shader_code, shader_code_size,
+                set_layouts, set_layout_count,
+                &push_constant_range, 1,
+                specialization_info,
+                engine_context.shader_binary_cache.get());
+
+            material->add_shader_object(std::move(shader_object));
+        }
+        else
+        {
+            auto pipeline_object = std::make_unique<PipelineObject>();
+            pipeline_object->create_compute_pipeline(engine_context.dispatch_table, get_pipeline_cache(), pipeline_layout,
+                shader_code, shader_code_size,
+                specialization_info);
+
+            material->add_pipeline_object(std::move(pipeline_object));
+        }
+
+        delete[] shader_code;
+
+        return material;
+    }
+
+    std::shared_ptr<Material> MaterialUtils::get_compute_variant(const std::string& name, const std::string& compute_shader_path,
+                                                                 uint32_t push_constant_size, const ShaderVariant& variant)
+    {
+        std::string variant_name = name + "_" + variant.get_key();
+
+        auto found = variants.find(variant_name);
+        if (found != variants.end())
+        {
+            return found->second;
+        }
+
+        SpecializationData specialization_data(variant);
+        auto material = create_compute_material(variant_name, compute_shader_path, push_constant_size,
+                                                nullptr, 0,
+                                                specialization_data.get_info());
+
+        variants.emplace(variant_name, material);
+
+        return material;
+    }
+
+    void MaterialUtils::cleanup_variants()
+    {
+        for (auto& [variant_name, material] : variants)
+        {
+            material->cleanup();
+        }
+
+        variants.clear();
+    }
+
+    std::shared_ptr<Material> MaterialUtils::create_mesh_material(const std::string& name, const std::string& task_shader_path,
+                                                                  const std::string& mesh_shader_path, uint32_t push_constant_size) const
+    {
+        VkPushConstantRange push_constant_range{};
+        push_constant_range.stageFlags = VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        push_constant_range.offset = 0;
+        push_constant_range.size = push_constant_size;
+
+        size_t shaderCodeSizes[3]{};
+        char* shaderCodes[3]{};
+
+        //The fragment shader is shared with the vertex path
+        utils::FileUtils::loadShader(task_shader_path, shaderCodes[0], shaderCodeSizes[0]);
+        utils::FileUtils::loadShader(mesh_shader_path, shaderCodes[1], shaderCodeSizes[1]);
+        utils::FileUtils::loadShader(fragment_shader_path, shaderCodes[2], shaderCodeSizes[2]);
+
+        VkPipelineLayout pipeline_layout;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = utils::DescriptorUtils::pipeline_layout_create_info(nullptr,  0, &push_constant_range, 1);
+        engine_context.dispatch_table.createPipelineLayout(&pipelineLayoutInfo, VK_NULL_HANDLE, &pipeline_layout);
+
+        auto material = make_shared<Material>(name, engine_context);
+        material->add_pipeline_layout(pipeline_layout);
+
+        if (use_shader_objects())
+        {
+            auto shader_object = std::make_unique<ShaderObject>();
+            shader_object->create_mesh_shaders(engine_context.dispatch_table,
+                shaderCodes[0], shaderCodeSizes[0],
+                shaderCodes[1], shaderCodeSizes[1],
+                shaderCodes[2], shaderCodeSizes[2],
+                nullptr, 0,
+                &push_constant_range, 1,
+                engine_context.shader_binary_cache.get());
+
+            material->add_shader_object(std::move(shader_object));
+        }
+        else
+        {
+            //Quads instead of points
+            auto pipeline_object = std::make_unique<PipelineObject>();
+            pipeline_object->create_mesh_pipeline(engine_context.dispatch_table, get_pipeline_cache(), pipeline_layout,
+                shaderCodes[0], shaderCodeSizes[0],
+                shaderCodes[1], shaderCodeSizes[1],
+                shaderCodes[2], shaderCodeSizes[2],
+                get_graphics_state(VK_POLYGON_MODE_FILL));
+
+            material->add_pipeline_object(std::move(pipeline_object));
+        }
+
+        for (auto* shader_code : shaderCodes)
+        {
+            delete[] shader_code;
+        }
+
         return material;
     }
+
+    bool MaterialUtils::use_shader_objects() const
+    {
+        return engine_context.device_manager->is_shader_object_supported();
+    }
+
+    VkPipelineCache MaterialUtils::get_pipeline_cache() const
+    {
+        return engine_context.pipeline_cache ? engine_context.pipeline_cache->get_pipeline_cache() : VK_NULL_HANDLE;
+    }
+
+    PipelineObject::GraphicsState MaterialUtils::get_graphics_state(VkPolygonMode polygon_mode) const
+    {
+        //Same attachments Subpass::begin_rendering uses: the swapchain image and a combined depth/stencil image
+        PipelineObject::GraphicsState state{};
+        state.color_format = engine_context.swapchain_manager->get_image_format();
+        state.polygon_mode = polygon_mode;
+        utils::RenderUtils::get_supported_depth_stencil_format(engine_context.device_manager->get_physical_device(), &state.depth_stencil_format);
+
+        return state;
+    }
 }
@@ -0,0 +1,121 @@
+#include "materials/PipelineCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "structs/EngineContext.h"
+
+namespace material
+{
+    PipelineCache::PipelineCache(EngineContext& engine_context, std::string file_path) :
+        engine_context(engine_context), file_path(std::move(file_path))
+    {
+    }
+
+    bool PipelineCache::init()
+    {
+        std::vector<char> cache_data;
+
+        std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+        if (file)
+        {
+            cache_data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(cache_data.data(), static_cast<std::streamsize>(cache_data.size()));
+        }
+
+        //Drivers are required to reject foreign blobs, but not all of them do it gracefully
+        VkPhysicalDeviceProperties properties{};
+        engine_context.instance_dispatch_table.getPhysicalDeviceProperties(engine_context.device_manager->get_physical_device().physical_device,
+                                                                           &properties);
+
+        VkPipelineCacheHeaderVersionOne header{};
+        if (cache_data.size() >= sizeof(header))
+        {
+            memcpy(&header, cache_data.data(), sizeof(header));
+        }
+
+        if (cache_data.size() < sizeof(header) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+            memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            cache_data.clear();
+        }
+
+        VkPipelineCacheCreateInfo cache_info{};
+        cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cache_info.initialDataSize = cache_data.size();
+        cache_info.pInitialData = cache_data.empty() ? nullptr : cache_data.data();
+
+        if (engine_context.dispatch_table.createPipelineCache(&cache_info, nullptr, &pipeline_cache) != VK_SUCCESS)
+        {
+            std::cerr << "Failed to create pipeline cache" << std::endl;
+            return false;
+        }
+
+        loaded_size = cache_data.size();
+
+        return true;
+    }
+
+    void PipelineCache::cleanup()
+    {
+        if (pipeline_cache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        save();
+
+        engine_context.dispatch_table.destroyPipelineCache(pipeline_cache, nullptr);
+        pipeline_cache = VK_NULL_HANDLE;
+    }
+
+    void PipelineCache::save() const
+    {
+        size_t data_size = 0;
+        if (engine_context.dispatch_table.getPipelineCacheData(pipeline_cache, &data_size, nullptr) != VK_SUCCESS || data_size == 0)
+        {
+            return;
+        }
+
+        std::vector<char> cache_data(data_size);
+        if (engine_context.dispatch_table.getPipelineCacheData(pipeline_cache, &data_size, cache_data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        //Written under a temporary name and renamed once complete, so a failed write never replaces the previous cache
+        const std::string temp_path = file_path + ".tmp";
+        std::error_code error;
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Failed to write pipeline cache " << file_path << std::endl;
+                return;
+            }
+
+            file.write(cache_data.data(), static_cast<std::streamsize>(data_size));
+
+            file.close();
+            if (!file)
+            {
+                std::cerr << "Failed to write pipeline cache " << file_path << std::endl;
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp_path, file_path, error);
+        if (error)
+        {
+            std::cerr << "Failed to move pipeline cache into place: " << file_path << std::endl;
+            std::filesystem::remove(temp_path, error);
+        }
+    }
+}
@@ -0,0 +1,214 @@
+#include "materials/PipelineObject.h"
+
+#include <iostream>
+#include <vector>
+
+namespace material
+{
+    bool PipelineObject::create_graphics_pipeline(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                                  const char* vertex_code, size_t vertex_code_size,
+                                                  const char* fragment_code, size_t fragment_code_size,
+                                                  const GraphicsState& state)
+    {
+        VkPipelineShaderStageCreateInfo stages[2]{};
+
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = create_shader_module(disp, vertex_code, vertex_code_size);
+        stages[0].pName = "main";
+
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = create_shader_module(disp, fragment_code, fragment_code_size);
+        stages[1].pName = "main";
+
+        const bool created = create_graphics(disp, pipeline_cache, pipeline_layout, stages, 2, state, true);
+
+        for (auto& stage : stages)
+        {
+            disp.destroyShaderModule(stage.module, nullptr);
+        }
+
+        return created;
+    }
+
+    bool PipelineObject::create_mesh_pipeline(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                              const char* task_code, size_t task_code_size,
+                                              const char* mesh_code, size_t mesh_code_size,
+                                              const char* fragment_code, size_t fragment_code_size,
+                                              const GraphicsState& state)
+    {
+        VkPipelineShaderStageCreateInfo stages[3]{};
+
+        const VkShaderStageFlagBits stage_bits[3] = { VK_SHADER_STAGE_TASK_BIT_EXT, VK_SHADER_STAGE_MESH_BIT_EXT, VK_SHADER_STAGE_FRAGMENT_BIT };
+        const char* codes[3] = { task_code, mesh_code, fragment_code };
+        const size_t code_sizes[3] = { task_code_size, mesh_code_size, fragment_code_size };
+
+        for (int i = 0; i < 3; ++i)
+        {
+            stages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stages[i].stage = stage_bits[i];
+            stages[i].module = create_shader_module(disp, codes[i], code_sizes[i]);
+            stages[i].pName = "main";
+        }
+
+        const bool created = create_graphics(disp, pipeline_cache, pipeline_layout, stages, 3, state, false);
+
+        for (auto& stage : stages)
+        {
+            disp.destroyShaderModule(stage.module, nullptr);
+        }
+
+        return created;
+    }
+
+    bool PipelineObject::create_compute_pipeline(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                                 const char* compute_code, size_t compute_code_size,
+                                                 const VkSpecializationInfo* specialization_info)
+    {
+        VkComputePipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipeline_info.stage.module = create_shader_module(disp, compute_code, compute_code_size);
+        pipeline_info.stage.pName = "main";
+        pipeline_info.stage.pSpecializationInfo = specialization_info;
+        pipeline_info.layout = pipeline_layout;
+
+        bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+        VkResult result = disp.createComputePipelines(pipeline_cache, 1, &pipeline_info, nullptr, &pipeline);
+
+        disp.destroyShaderModule(pipeline_info.stage.module, nullptr);
+
+        if (result != VK_SUCCESS)
+        {
+            std::cerr << "vkCreateComputePipelines failed\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    void PipelineObject::bind(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer) const
+    {
+        disp.cmdBindPipeline(cmd_buffer, bind_point, pipeline);
+    }
+
+    void PipelineObject::destroy(const vkb::DispatchTable& disp)
+    {
+        if (pipeline != VK_NULL_HANDLE)
+        {
+            disp.destroyPipeline(pipeline, nullptr);
+            pipeline = VK_NULL_HANDLE;
+        }
+    }
+
+    VkShaderModule PipelineObject::create_shader_module(const vkb::DispatchTable& disp, const char* code, size_t code_size)
+    {
+        VkShaderModuleCreateInfo module_info{};
+        module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        module_info.codeSize = code_size;
+        module_info.pCode = reinterpret_cast<const uint32_t*>(code);
+
+        VkShaderModule shader_module = VK_NULL_HANDLE;
+        if (disp.createShaderModule(&module_info, nullptr, &shader_module) != VK_SUCCESS)
+        {
+            std::cerr << "vkCreateShaderModule failed\n";
+        }
+
+        return shader_module;
+    }
+
+    bool PipelineObject::create_graphics(const vkb::DispatchTable& disp, VkPipelineCache pipeline_cache, VkPipelineLayout pipeline_layout,
+                                         const VkPipelineShaderStageCreateInfo* stages, uint32_t stage_count, const GraphicsState& state,
+                                         bool has_vertex_input)
+    {
+        //Everything ShaderObject::set_initial_state sets through core (1.3) dynamic state
+        std::vector<VkDynamicState> dynamic_states =
+        {
+            VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT,
+            VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT,
+            VK_DYNAMIC_STATE_CULL_MODE,
+            VK_DYNAMIC_STATE_FRONT_FACE,
+            VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+            VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+            VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+            VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE,
+            VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE,
+            VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE
+        };
+
+        //Input assembly state is not allowed to be dynamic in mesh pipelines
+        if (has_vertex_input)
+        {
+            dynamic_states.push_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY);
+            dynamic_states.push_back(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE);
+            dynamic_states.push_back(VK_DYNAMIC_STATE_VERTEX_INPUT_EXT);
+        }
+
+        VkPipelineDynamicStateCreateInfo dynamic_state{};
+        dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic_state.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
+        dynamic_state.pDynamicStates = dynamic_states.data();
+
+        //Topology is dynamic, only its class (points) is fixed here
+        VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+        input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+
+        VkPipelineViewportStateCreateInfo viewport_state{};
+        viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+
+        VkPipelineRasterizationStateCreateInfo rasterization{};
+        rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization.polygonMode = state.polygon_mode;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample{};
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+        depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depth_stencil.maxDepthBounds = 1.0f;
+
+        //No blending, RGBA writes
+        VkPipelineColorBlendAttachmentState blend_attachment{};
+        blend_attachment.colorWriteMask = 0xF;
+
+        VkPipelineColorBlendStateCreateInfo color_blend{};
+        color_blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        color_blend.attachmentCount = 1;
+        color_blend.pAttachments = &blend_attachment;
+
+        VkPipelineRenderingCreateInfo rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        rendering_info.colorAttachmentCount = 1;
+        rendering_info.pColorAttachmentFormats = &state.color_format;
+        rendering_info.depthAttachmentFormat = state.depth_stencil_format;
+        rendering_info.stencilAttachmentFormat = state.depth_stencil_format;
+
+        VkGraphicsPipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipeline_info.pNext = &rendering_info;
+        pipeline_info.stageCount = stage_count;
+        pipeline_info.pStages = stages;
+        pipeline_info.pInputAssemblyState = has_vertex_input ? &input_assembly : nullptr;
+        pipeline_info.pViewportState = &viewport_state;
+        pipeline_info.pRasterizationState = &rasterization;
+        pipeline_info.pMultisampleState = &multisample;
+        pipeline_info.pDepthStencilState = &depth_stencil;
+        pipeline_info.pColorBlendState = &color_blend;
+        pipeline_info.pDynamicState = &dynamic_state;
+        pipeline_info.layout = pipeline_layout;
+
+        bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        if (disp.createGraphicsPipelines(pipeline_cache, 1, &pipeline_info, nullptr, &pipeline) != VK_SUCCESS)
+        {
+            std::cerr << "vkCreateGraphicsPipelines failed\n";
+            return false;
+        }
+
+        return true;
+    }
+}
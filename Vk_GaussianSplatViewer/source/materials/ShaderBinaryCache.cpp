@@ -0,0 +1,311 @@
+#include "materials/ShaderBinaryCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "structs/EngineContext.h"
+
+namespace material
+{
+    namespace
+    {
+        constexpr char cache_magic[8] = { 'G', 'S', 'V', 'S', 'H', 'B', 'I', 'N' };
+        constexpr uint32_t cache_version = 1;
+
+        //FNV-1a
+        void hash_bytes(uint64_t& hash, const void* data, size_t size)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ull;
+            }
+        }
+
+        template <typename T>
+        void hash_value(uint64_t& hash, const T& value)
+        {
+            hash_bytes(hash, &value, sizeof(value));
+        }
+
+        size_t align_16(size_t value)
+        {
+            return (value + 15) & ~static_cast<size_t>(15);
+        }
+
+        size_t get_binaries_offset(uint32_t count)
+        {
+            return align_16(sizeof(ShaderBinaryCacheHeader) + sizeof(uint64_t) * count);
+        }
+    }
+
+    ShaderBinaryCache::ShaderBinaryCache(EngineContext& engine_context, std::string cache_directory, bool enabled) :
+        engine_context(engine_context), cache_directory(std::move(cache_directory)), enabled(enabled)
+    {
+        VkPhysicalDeviceShaderObjectPropertiesEXT shader_object_properties{};
+        shader_object_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_PROPERTIES_EXT;
+
+        VkPhysicalDeviceIDProperties id_properties{};
+        id_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+        id_properties.pNext = &shader_object_properties;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &id_properties;
+        engine_context.instance_dispatch_table.getPhysicalDeviceProperties2(engine_context.device_manager->get_physical_device().physical_device,
+                                                                            &properties2);
+
+        memcpy(device_uuid, id_properties.deviceUUID, VK_UUID_SIZE);
+        memcpy(shader_binary_uuid, shader_object_properties.shaderBinaryUUID, VK_UUID_SIZE);
+        driver_version = properties2.properties.driverVersion;
+        shader_binary_version = shader_object_properties.shaderBinaryVersion;
+
+        if (this->enabled)
+        {
+            std::error_code error;
+            std::filesystem::create_directories(this->cache_directory, error);
+            if (error)
+            {
+                std::cerr << "Shader binary cache disabled, cannot create " << this->cache_directory << std::endl;
+                this->enabled = false;
+            }
+        }
+    }
+
+    VkResult ShaderBinaryCache::create_shaders(uint32_t count, const VkShaderCreateInfoEXT* create_infos, VkShaderEXT* out_shaders)
+    {
+        auto create_start = std::chrono::high_resolution_clock::now();
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        const uint64_t source_hash = enabled ? hash_create_infos(count, create_infos) : 0;
+        const std::string path = enabled ? get_entry_path(source_hash) : std::string();
+
+        if (enabled)
+        {
+            std::vector<BinaryBlock> file_data;
+            std::vector<VkShaderCreateInfoEXT> binary_infos;
+
+            if (load(path, source_hash, count, create_infos, file_data, binary_infos))
+            {
+                std::fill_n(out_shaders, count, VK_NULL_HANDLE);
+
+                if (dispatch_table.createShadersEXT(count, binary_infos.data(), nullptr, out_shaders) == VK_SUCCESS)
+                {
+                    hit_count++;
+                    creation_ms += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - create_start).count();
+                    return VK_SUCCESS;
+                }
+
+                //VK_INCOMPATIBLE_SHADER_BINARY_EXT: the driver rejects the binary although the UUIDs matched, so rebuild it
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    if (out_shaders[i] != VK_NULL_HANDLE)
+                    {
+                        dispatch_table.destroyShaderEXT(out_shaders[i], nullptr);
+                    }
+                }
+            }
+        }
+
+        VkResult result = dispatch_table.createShadersEXT(count, create_infos, nullptr, out_shaders);
+        miss_count++;
+
+        if (result == VK_SUCCESS && enabled)
+        {
+            store(path, source_hash, count, out_shaders);
+        }
+
+        creation_ms += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - create_start).count();
+
+        return result;
+    }
+
+    uint64_t ShaderBinaryCache::hash_create_infos(uint32_t count, const VkShaderCreateInfoEXT* create_infos)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+
+        //Everything that changes the compiled binary: code, stages, flags, interface layout and specialization
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const VkShaderCreateInfoEXT& info = create_infos[i];
+
+            hash_value(hash, info.stage);
+            hash_value(hash, info.nextStage);
+            hash_value(hash, info.flags);
+            hash_value(hash, info.codeSize);
+            hash_bytes(hash, info.pCode, info.codeSize);
+            hash_bytes(hash, info.pName, strlen(info.pName));
+            hash_value(hash, info.setLayoutCount);
+
+            for (uint32_t r = 0; r < info.pushConstantRangeCount; ++r)
+            {
+                hash_value(hash, info.pPushConstantRanges[r]);
+            }
+
+            if (info.pSpecializationInfo != nullptr)
+            {
+                const VkSpecializationInfo& specialization = *info.pSpecializationInfo;
+                hash_bytes(hash, specialization.pMapEntries, sizeof(VkSpecializationMapEntry) * specialization.mapEntryCount);
+                hash_bytes(hash, specialization.pData, specialization.dataSize);
+            }
+        }
+
+        return hash;
+    }
+
+    std::string ShaderBinaryCache::get_entry_path(uint64_t source_hash) const
+    {
+        char file_name[32];
+        snprintf(file_name, sizeof(file_name), "%016llx.bin", static_cast<unsigned long long>(source_hash));
+
+        return (std::filesystem::path(cache_directory) / file_name).string();
+    }
+
+    bool ShaderBinaryCache::load(const std::string& path, uint64_t source_hash, uint32_t count, const VkShaderCreateInfoEXT* create_infos,
+                                 std::vector<BinaryBlock>& file_data, std::vector<VkShaderCreateInfoEXT>& binary_infos) const
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+
+        const auto file_size = static_cast<size_t>(file.tellg());
+        if (file_size < get_binaries_offset(count))
+        {
+            return false;
+        }
+
+        file_data.resize((file_size + sizeof(BinaryBlock) - 1) / sizeof(BinaryBlock));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(file_data.data()), static_cast<std::streamsize>(file_size));
+        if (!file)
+        {
+            return false;
+        }
+
+        const auto* bytes = reinterpret_cast<const uint8_t*>(file_data.data());
+
+        ShaderBinaryCacheHeader header{};
+        memcpy(&header, bytes, sizeof(header));
+
+        if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.version != cache_version ||
+            header.shader_count != count || header.source_hash != source_hash ||
+            memcmp(header.device_uuid, device_uuid, VK_UUID_SIZE) != 0 ||
+            memcmp(header.shader_binary_uuid, shader_binary_uuid, VK_UUID_SIZE) != 0 ||
+            header.driver_version != driver_version || header.shader_binary_version != shader_binary_version)
+        {
+            return false;
+        }
+
+        std::vector<uint64_t> binary_sizes(count);
+        memcpy(binary_sizes.data(), bytes + sizeof(header), sizeof(uint64_t) * count);
+
+        binary_infos.clear();
+        size_t offset = get_binaries_offset(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (offset + binary_sizes[i] > file_size)
+            {
+                return false;
+            }
+
+            //Same interface as the SPIR-V it was built from, only the code is swapped
+            VkShaderCreateInfoEXT binary_info = create_infos[i];
+            binary_info.codeType = VK_SHADER_CODE_TYPE_BINARY_EXT;
+            binary_info.codeSize = binary_sizes[i];
+            binary_info.pCode = bytes + offset;
+            binary_infos.push_back(binary_info);
+
+            offset = align_16(offset + binary_sizes[i]);
+        }
+
+        return true;
+    }
+
+    void ShaderBinaryCache::store(const std::string& path, uint64_t source_hash, uint32_t count, const VkShaderEXT* shaders) const
+    {
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        std::vector<std::vector<uint8_t>> binaries(count);
+        std::vector<uint64_t> binary_sizes(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            size_t binary_size = 0;
+            if (dispatch_table.getShaderBinaryDataEXT(shaders[i], &binary_size, nullptr) != VK_SUCCESS || binary_size == 0)
+            {
+                return;
+            }
+
+            binaries[i].resize(binary_size);
+            if (dispatch_table.getShaderBinaryDataEXT(shaders[i], &binary_size, binaries[i].data()) != VK_SUCCESS)
+            {
+                return;
+            }
+
+            binary_sizes[i] = binary_size;
+        }
+
+        ShaderBinaryCacheHeader header{};
+        memcpy(header.magic, cache_magic, sizeof(cache_magic));
+        header.version = cache_version;
+        header.shader_count = count;
+        memcpy(header.device_uuid, device_uuid, VK_UUID_SIZE);
+        memcpy(header.shader_binary_uuid, shader_binary_uuid, VK_UUID_SIZE);
+        header.driver_version = driver_version;
+        header.shader_binary_version = shader_binary_version;
+        header.source_hash = source_hash;
+
+        //Written under a temporary name and renamed once complete, so a failed or interrupted write never replaces
+        //a good entry with a truncated one
+        const std::string temp_path = path + ".tmp";
+        std::error_code error;
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Failed to write shader binary cache entry " << path << std::endl;
+                return;
+            }
+
+            const char padding[16]{};
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(binary_sizes.data()), static_cast<std::streamsize>(sizeof(uint64_t) * count));
+
+            size_t offset = sizeof(header) + sizeof(uint64_t) * count;
+            for (const auto& binary : binaries)
+            {
+                file.write(padding, static_cast<std::streamsize>(align_16(offset) - offset));
+                offset = align_16(offset);
+
+                file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+                offset += binary.size();
+            }
+
+            file.close();
+            if (!file)
+            {
+                std::cerr << "Failed to write shader binary cache entry " << path << std::endl;
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp_path, path, error);
+        if (error)
+        {
+            std::cerr << "Failed to move shader binary cache entry into place: " << path << std::endl;
+            std::filesystem::remove(temp_path, error);
+        }
+    }
+}
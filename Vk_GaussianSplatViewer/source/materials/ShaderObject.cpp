@@ -1,4 +1,5 @@
 #include "materials/ShaderObject.h"
+#include "materials/ShaderBinaryCache.h"
 
 #include "../../include/structs/geometry/Vertex.h"
 #include "vulkanapp/SwapchainManager.h"
@@ -47,7 +48,19 @@ void material::ShaderObject::Shader::destroy(const vkb::DispatchTable& disp)
     }
 }
 
-void material::ShaderObject::build_linked_shaders(const vkb::DispatchTable& disp, ShaderObject::Shader* vert, ShaderObject::Shader* frag)
+VkResult material::ShaderObject::create_shader_objects(const vkb::DispatchTable& disp, ShaderBinaryCache* binary_cache, uint32_t count,
+                                                       const VkShaderCreateInfoEXT* create_infos, VkShaderEXT* shaders)
+{
+    if (binary_cache != nullptr)
+    {
+        return binary_cache->create_shaders(count, create_infos, shaders);
+    }
+
+    return disp.createShadersEXT(count, create_infos, nullptr, shaders);
+}
+
+void material::ShaderObject::build_linked_shaders(const vkb::DispatchTable& disp, ShaderObject::Shader* vert, ShaderObject::Shader* frag,
+                                                  ShaderBinaryCache* binary_cache)
 {
     VkShaderCreateInfoEXT shader_create_infos[2];
 
@@ -67,10 +80,9 @@ void material::ShaderObject::build_linked_shaders(const vkb::DispatchTable& disp
     VkShaderEXT shaderEXTs[2];
 
     // Create the shader objects
-    VkResult result = disp.createShadersEXT(
+    VkResult result = create_shader_objects(disp, binary_cache,
                                          2,
                                          shader_create_infos,
-                                         nullptr,
                                          shaderEXTs);
 
     if (result != VK_SUCCESS)
@@ -84,7 +96,8 @@ void material::ShaderObject::build_linked_shaders(const vkb::DispatchTable& disp
 
 void material::ShaderObject::create_shaders(const vkb::DispatchTable& disp, char* vertexShader, size_t vertShaderSize, char* fragmentShader, size_t fragShaderSize,
 	const VkDescriptorSetLayout* pSetLayouts, uint32_t setLayoutCount,
-	const VkPushConstantRange* pPushConstantRange, uint32_t pPushConstantCount)
+	const VkPushConstantRange* pPushConstantRange, uint32_t pPushConstantCount,
+	ShaderBinaryCache* binary_cache)
 {
 	vert_shader = std::make_unique<Shader>(VK_SHADER_STAGE_VERTEX_BIT,
 	                                      VK_SHADER_STAGE_FRAGMENT_BIT,
@@ -97,7 +110,81 @@ void material::ShaderObject::create_shaders(const vkb::DispatchTable& disp, char
                                     fragmentShader,
                                     fragShaderSize, pSetLayouts, setLayoutCount, pPushConstantRange, pPushConstantCount);
 
-    build_linked_shaders(disp, vert_shader.get(), frag_shader.get());
+    build_linked_shaders(disp, vert_shader.get(), frag_shader.get(), binary_cache);
+}
+
+void material::ShaderObject::create_compute_shader(const vkb::DispatchTable& disp, char* computeShader, size_t compShaderSize,
+	const VkDescriptorSetLayout* pSetLayouts, uint32_t setLayoutCount,
+	const VkPushConstantRange* pPushConstantRange, uint32_t pPushConstantCount,
+	const VkSpecializationInfo* pSpecializationInfo,
+	ShaderBinaryCache* binary_cache)
+{
+    comp_shader = std::make_unique<Shader>(VK_SHADER_STAGE_COMPUTE_BIT,
+                                    0,
+                                    "ComputeShader",
+                                    computeShader,
+                                    compShaderSize, pSetLayouts, setLayoutCount, pPushConstantRange, pPushConstantCount);
+    comp_shader->set_specialization_info(pSpecializationInfo);
+
+    VkShaderCreateInfoEXT shader_create_info = comp_shader->get_create_info();
+    VkShaderEXT shaderEXT;
+
+    if (create_shader_objects(disp, binary_cache, 1, &shader_create_info, &shaderEXT) != VK_SUCCESS)
+    {
+        std::cerr << ("vkCreateShadersEXT failed for compute shader\n");
+        return;
+    }
+
+    comp_shader->set_shader(shaderEXT);
+}
+
+void material::ShaderObject::create_mesh_shaders(const vkb::DispatchTable& disp, char* taskShader, size_t taskShaderSize,
+	char* meshShader, size_t meshShaderSize, char* fragmentShader, size_t fragShaderSize,
+	const VkDescriptorSetLayout* pSetLayouts, uint32_t setLayoutCount,
+	const VkPushConstantRange* pPushConstantRange, uint32_t pPushConstantCount,
+	ShaderBinaryCache* binary_cache)
+{
+    task_shader = std::make_unique<Shader>(VK_SHADER_STAGE_TASK_BIT_EXT,
+                                    VK_SHADER_STAGE_MESH_BIT_EXT,
+                                    "TaskShader",
+                                    taskShader,
+                                    taskShaderSize, pSetLayouts, setLayoutCount, pPushConstantRange, pPushConstantCount);
+
+    mesh_shader = std::make_unique<Shader>(VK_SHADER_STAGE_MESH_BIT_EXT,
+                                    VK_SHADER_STAGE_FRAGMENT_BIT,
+                                    "MeshShader",
+                                    meshShader,
+                                    meshShaderSize, pSetLayouts, setLayoutCount, pPushConstantRange, pPushConstantCount);
+
+    frag_shader = std::make_unique<Shader>(VK_SHADER_STAGE_FRAGMENT_BIT,
+                                    0,
+                                    "MeshShader",
+                                    fragmentShader,
+                                    fragShaderSize, pSetLayouts, setLayoutCount, pPushConstantRange, pPushConstantCount);
+
+    VkShaderCreateInfoEXT shader_create_infos[3] =
+    {
+        task_shader->get_create_info(),
+        mesh_shader->get_create_info(),
+        frag_shader->get_create_info()
+    };
+
+    for (auto &shader_create : shader_create_infos)
+    {
+        shader_create.flags |= VK_SHADER_CREATE_LINK_STAGE_BIT_EXT;
+    }
+
+    VkShaderEXT shaderEXTs[3];
+
+    if (create_shader_objects(disp, binary_cache, 3, shader_create_infos, shaderEXTs) != VK_SUCCESS)
+    {
+        std::cerr << ("vkCreateShadersEXT failed for mesh shaders\n");
+        return;
+    }
+
+    task_shader->set_shader(shaderEXTs[0]);
+    mesh_shader->set_shader(shaderEXTs[1]);
+    frag_shader->set_shader(shaderEXTs[2]);
 }
 
 void material::ShaderObject::destroy_shaders(const vkb::DispatchTable& disp)
@@ -110,6 +197,18 @@ void material::ShaderObject::destroy_shaders(const vkb::DispatchTable& disp)
     {
         frag_shader->destroy(disp);
     }
+    if (comp_shader)
+    {
+        comp_shader->destroy(disp);
+    }
+    if (task_shader)
+    {
+        task_shader->destroy(disp);
+    }
+    if (mesh_shader)
+    {
+        mesh_shader->destroy(disp);
+    }
 }
 
 void material::ShaderObject::bind_shader(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer, const ShaderObject::Shader* shader)
@@ -119,6 +218,31 @@ void material::ShaderObject::bind_shader(const vkb::DispatchTable& disp, VkComma
 
 void material::ShaderObject::bind_material_shader(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer) const
 {
+    if (comp_shader)
+    {
+        bind_shader(disp, cmd_buffer, comp_shader.get());
+        return;
+    }
+
+    if (mesh_shader)
+    {
+        const VkShaderStageFlagBits vertex_stage = VK_SHADER_STAGE_VERTEX_BIT;
+        const VkShaderEXT null_shader = VK_NULL_HANDLE;
+        disp.cmdBindShadersEXT(cmd_buffer, 1, &vertex_stage, &null_shader);
+
+        bind_shader(disp, cmd_buffer, task_shader.get());
+        bind_shader(disp, cmd_buffer, mesh_shader.get());
+        bind_shader(disp, cmd_buffer, frag_shader.get());
+        return;
+    }
+
     bind_shader(disp, cmd_buffer, vert_shader.get());
     bind_shader(disp, cmd_buffer, frag_shader.get());
 }
+
+void material::ShaderObject::unbind_mesh_stages(const vkb::DispatchTable& disp, VkCommandBuffer cmd_buffer)
+{
+    const VkShaderStageFlagBits stages[2] = { VK_SHADER_STAGE_TASK_BIT_EXT, VK_SHADER_STAGE_MESH_BIT_EXT };
+    const VkShaderEXT null_shaders[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+    disp.cmdBindShadersEXT(cmd_buffer, 2, stages, null_shaders);
+}
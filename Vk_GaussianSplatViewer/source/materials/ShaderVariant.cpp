@@ -0,0 +1,30 @@
+#include "materials/ShaderVariant.h"
+
+namespace material
+{
+    std::string ShaderVariant::get_key() const
+    {
+        return "sh" + std::to_string(sh_degree) +
+               (frustum_culling ? "_cull" : "_nocull") +
+               "_debug" + std::to_string(static_cast<uint32_t>(debug_view));
+    }
+
+    SpecializationData::SpecializationData(const ShaderVariant& variant)
+    {
+        values[0] = variant.sh_degree;
+        values[1] = variant.frustum_culling ? VK_TRUE : VK_FALSE;
+        values[2] = static_cast<uint32_t>(variant.debug_view);
+
+        for (uint32_t i = 0; i < map_entries.size(); ++i)
+        {
+            map_entries[i].constantID = i;
+            map_entries[i].offset = i * sizeof(uint32_t);
+            map_entries[i].size = sizeof(uint32_t);
+        }
+
+        specialization_info.mapEntryCount = static_cast<uint32_t>(map_entries.size());
+        specialization_info.pMapEntries = map_entries.data();
+        specialization_info.dataSize = sizeof(values);
+        specialization_info.pData = values.data();
+    }
+}
@@ -1,5 +1,6 @@
 #include "platform/input/InputManager.h"
 #include "camera/FirstPersonCamera.h"
+#include "core/CpuProfiler.h"
 #include <imgui_impl_sdl3.h>
 #include <SDL3/SDL_scancode.h>
 
@@ -39,6 +40,8 @@ namespace input
 
     void InputManager::process_input(bool& is_running, camera::FirstPersonCamera* camera, double delta_time)
     {
+        GSV_CPU_ZONE("Process input");
+
         SDL_Event event;
         const ImGuiIO& io = ImGui::GetIO();
 
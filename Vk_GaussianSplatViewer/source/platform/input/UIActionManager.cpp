@@ -1,4 +1,5 @@
 #include "platform/input/UIActionManager.h"
+#include "core/CpuProfiler.h"
 
 namespace ui
 {
@@ -87,6 +88,8 @@ namespace ui
 
     void UIActionManager::process_queued_actions()
     {
+        GSV_CPU_ZONE("UI actions");
+
         while (!action_queue.empty())
         {
             execute_queued_action(action_queue.front());
@@ -0,0 +1,194 @@
+#include "renderer/FrameScheduler.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "core/CpuProfiler.h"
+#include "structs/EngineContext.h"
+
+namespace core::renderer
+{
+    FrameScheduler::FrameScheduler(EngineContext& engine_context, uint32_t max_frames_in_flight) : engine_context(engine_context)
+    {
+        frame_points.assign(max_frames_in_flight, {});
+    }
+
+    bool FrameScheduler::init()
+    {
+        VkSemaphoreTypeCreateInfo type_info{};
+        type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        type_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphore_info{};
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_info.pNext = &type_info;
+
+        for (auto& timeline_semaphore : timeline_semaphores)
+        {
+            if (engine_context.dispatch_table.createSemaphore(&semaphore_info, nullptr, &timeline_semaphore) != VK_SUCCESS)
+            {
+                std::cout << "failed to create timeline semaphore\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void FrameScheduler::cleanup()
+    {
+        for (auto& timeline_semaphore : timeline_semaphores)
+        {
+            if (timeline_semaphore != VK_NULL_HANDLE)
+            {
+                engine_context.dispatch_table.destroySemaphore(timeline_semaphore, nullptr);
+                timeline_semaphore = VK_NULL_HANDLE;
+            }
+        }
+
+        for (auto& pending : pending_submissions)
+        {
+            pending.clear();
+        }
+    }
+
+    void FrameScheduler::wait_for_frame_slot(uint32_t frame)
+    {
+        wait_for(frame_points[frame]);
+    }
+
+    void FrameScheduler::wait_for(TimelinePoint point) const
+    {
+        if (point.value == 0)
+        {
+            return;
+        }
+
+        GSV_CPU_ZONE("Timeline wait");
+
+        VkSemaphore timeline_semaphore = get_timeline_semaphore(point.lane);
+
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &timeline_semaphore;
+        wait_info.pValues = &point.value;
+
+        engine_context.dispatch_table.waitSemaphores(&wait_info, UINT64_MAX);
+    }
+
+    TimelinePoint FrameScheduler::submit(QueueLane lane, VkQueue queue, const std::vector<VkCommandBuffer>& command_buffers,
+                                         const std::vector<VkSemaphoreSubmitInfo>& wait_semaphores,
+                                         const std::vector<VkSemaphoreSubmitInfo>& binary_signal_semaphores,
+                                         const std::string& label)
+    {
+        const auto lane_index = static_cast<size_t>(lane);
+        uint64_t signal_value = last_submitted_values[lane_index] + 1;
+
+        std::vector<VkCommandBufferSubmitInfo> command_buffer_infos;
+        command_buffer_infos.reserve(command_buffers.size());
+        for (VkCommandBuffer command_buffer : command_buffers)
+        {
+            VkCommandBufferSubmitInfo command_buffer_info{};
+            command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            command_buffer_info.commandBuffer = command_buffer;
+            command_buffer_infos.push_back(command_buffer_info);
+        }
+
+        std::vector<VkSemaphoreSubmitInfo> signal_semaphores = binary_signal_semaphores;
+
+        VkSemaphoreSubmitInfo timeline_signal{};
+        timeline_signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        timeline_signal.semaphore = timeline_semaphores[lane_index];
+        timeline_signal.value = signal_value;
+        timeline_signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        signal_semaphores.push_back(timeline_signal);
+
+        VkSubmitInfo2 submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submit_info.waitSemaphoreInfoCount = static_cast<uint32_t>(wait_semaphores.size());
+        submit_info.pWaitSemaphoreInfos = wait_semaphores.data();
+        submit_info.commandBufferInfoCount = static_cast<uint32_t>(command_buffer_infos.size());
+        submit_info.pCommandBufferInfos = command_buffer_infos.data();
+        submit_info.signalSemaphoreInfoCount = static_cast<uint32_t>(signal_semaphores.size());
+        submit_info.pSignalSemaphoreInfos = signal_semaphores.data();
+
+        VkResult result;
+        {
+            GSV_CPU_ZONE("Queue submit");
+            result = engine_context.dispatch_table.queueSubmit2(queue, 1, &submit_info, VK_NULL_HANDLE);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            std::cout << "failed to submit " << label << " command buffer\n";
+            return get_last_submitted(lane);
+        }
+
+        last_submitted_values[lane_index] = signal_value;
+        pending_submissions[lane_index].push_back({label, signal_value, std::chrono::high_resolution_clock::now()});
+
+        return { lane, signal_value };
+    }
+
+    TimelinePoint FrameScheduler::submit_frame(uint32_t frame, VkQueue queue, VkCommandBuffer command_buffer,
+                                               const std::vector<VkSemaphoreSubmitInfo>& wait_semaphores,
+                                               const std::vector<VkSemaphoreSubmitInfo>& binary_signal_semaphores)
+    {
+        TimelinePoint point = submit(QueueLane::Graphics, queue, { command_buffer }, wait_semaphores, binary_signal_semaphores, "graphics");
+        frame_points[frame] = point;
+
+        return point;
+    }
+
+    VkSemaphoreSubmitInfo FrameScheduler::make_wait_info(TimelinePoint point, VkPipelineStageFlags2 stage_mask) const
+    {
+        VkSemaphoreSubmitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        wait_info.semaphore = get_timeline_semaphore(point.lane);
+        wait_info.value = point.value;
+        wait_info.stageMask = stage_mask;
+
+        return wait_info;
+    }
+
+    void FrameScheduler::poll()
+    {
+        auto now = std::chrono::high_resolution_clock::now();
+
+        for (size_t lane_index = 0; lane_index < lane_count; ++lane_index)
+        {
+            auto& pending = pending_submissions[lane_index];
+            if (pending.empty())
+            {
+                continue;
+            }
+
+            uint64_t completed_value = get_completed_value(static_cast<QueueLane>(lane_index));
+
+            //Values of a lane are submitted in increasing order, so finished work is always at the front.
+            //Latency resolution is bounded by how often this is polled
+            while (!pending.empty() && pending.front().value <= completed_value)
+            {
+                const PendingSubmission& submission = pending.front();
+                float latency_ms = std::chrono::duration<float, std::milli>(now - submission.submit_time).count();
+
+                SubmissionLatency& latency = latencies[submission.label];
+                latency.count++;
+                latency.last_ms = latency_ms;
+                latency.average_ms += (latency_ms - latency.average_ms) / static_cast<float>(std::min<uint64_t>(latency.count, 60));
+
+                pending.pop_front();
+            }
+        }
+    }
+
+    uint64_t FrameScheduler::get_completed_value(QueueLane lane) const
+    {
+        uint64_t value = 0;
+        engine_context.dispatch_table.getSemaphoreCounterValue(get_timeline_semaphore(lane), &value);
+
+        return value;
+    }
+}
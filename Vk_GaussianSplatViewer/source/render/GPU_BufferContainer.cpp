@@ -1,50 +1,319 @@
 #include "renderer/GPU_BufferContainer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include "3d/SplatCacheFile.h"
+#include "camera/FirstPersonCamera.h"
+#include "config/Config.inl"
+#include "renderer/UploadManager.h"
+#include "structs/EngineContext.h"
+#include "structs/geometry/SplatRecord.h"
 #include "structs/scene/CameraData.h"
+#include "vulkanapp/utils/MemoryTracker.h"
 #include "vulkanapp/utils/MemoryUtils.h"
+#include "vulkanapp/utils/Vk_Utils.h"
 
 namespace core::renderer
 {
-    GPU_BufferContainer::GPU_BufferContainer(EngineContext& engine_context) : engine_context(engine_context)
+    GPU_BufferContainer::GPU_BufferContainer(EngineContext& engine_context) :
+        gaussian_buffer(engine_context, sizeof(GaussianSurface), [this](VkDeviceSize size, GPU_Buffer& out_buffer) { create_gaussian_memory(size, out_buffer); }),
+        engine_context(engine_context)
     {
     }
 
-    void GPU_BufferContainer::allocate_camera_buffer(const camera::FirstPersonCamera& first_person_camera)
+    void GPU_BufferContainer::allocate_camera_buffer(const camera::FirstPersonCamera& first_person_camera, uint32_t frame_count)
     {
+        this->frame_count = frame_count;
+
+        frame_uniforms = std::make_unique<UniformRing>(engine_context);
+        frame_uniforms->init(frame_count, frame_uniform_slot_size);
+
+        //Valid data for anything recorded before the first frame update
         CameraData ubo{};
 
         ubo.projection = first_person_camera.get_projection_matrix();
         ubo.view = first_person_camera.get_view_matrix();
 
-        utils::MemoryUtils::allocate_buffer_with_mapped_access(
-            engine_context.dispatch_table,
-            engine_context.device_manager->get_allocator(),
-            sizeof(CameraData),
-            camera_data_buffer
-        );
+        frame_uniforms->begin_frame(0);
+        camera_data_address = frame_uniforms->write(ubo);
+    }
 
-        memcpy(camera_data_buffer.allocation_info.pMappedData, &ubo, sizeof(CameraData));
+    void GPU_BufferContainer::allocate_gaussian_surface_buffer(const std::vector<GaussianSurface>& gaussians)
+    {
+        allocate_gaussian_surface_buffer(gaussians.size(), [&gaussians](GaussianSurface* destination, size_t first, size_t count)
+        {
+            memcpy(destination, gaussians.data() + first, sizeof(GaussianSurface) * count);
+        });
+    }
 
-        vmaFlushAllocation(
-            engine_context.device_manager->get_allocator(),
-            camera_data_buffer .allocation,
-            0,
-            VK_WHOLE_SIZE
-        );
+    void GPU_BufferContainer::allocate_gaussian_surface_buffer(size_t count, const SurfaceDecoder& decoder)
+    {
+        gaussian_buffer.reset(count);
+        append_surfaces(count, decoder);
+        finish_surface_change(true);
     }
 
-    void GPU_BufferContainer::allocate_gaussian_surface_buffer(const std::vector<GaussianSurface>& gaussians)
+    void GPU_BufferContainer::allocate_gaussian_surface_buffer(std::shared_ptr<splat_loader::SplatCacheFile> cache_file)
+    {
+        gaussian_buffer.reset(cache_file->get_surface_count());
+        append_surfaces(cache_file);
+        finish_surface_change(true);
+    }
+
+    void GPU_BufferContainer::append_gaussian_surfaces(size_t count, const SurfaceDecoder& decoder)
+    {
+        append_surfaces(count, decoder);
+        finish_surface_change(false);
+    }
+
+    void GPU_BufferContainer::append_gaussian_surfaces(std::shared_ptr<splat_loader::SplatCacheFile> cache_file)
+    {
+        append_surfaces(cache_file);
+        finish_surface_change(false);
+    }
+
+    void GPU_BufferContainer::update_gaussian_surfaces(size_t first, const GaussianSurface* surfaces, size_t count)
+    {
+        gaussian_buffer.update(first, surfaces, count);
+
+        scene_version++;
+    }
+
+    void GPU_BufferContainer::append_surfaces(size_t count, const SurfaceDecoder& decoder)
+    {
+        //The first frame that reads the new splats waits for a staged copy on the GPU
+        if (!gaussian_buffer.append(count, [&decoder](void* destination, size_t first, size_t decode_count)
+        {
+            decoder(static_cast<GaussianSurface*>(destination), first, decode_count);
+        }, &last_gaussian_upload))
+        {
+            std::cerr << "Failed to add " << count << " gaussians, the scene is unchanged" << std::endl;
+            return;
+        }
+
+        std::cout << "Uploaded " << count << " gaussians " << (last_gaussian_upload.path == UploadPath::Direct ? "directly to VRAM" : "through the staging ring")
+                  << " at " << last_gaussian_upload.megabytes_per_second << " MB/s" << std::endl;
+    }
+
+    void GPU_BufferContainer::append_surfaces(const std::shared_ptr<splat_loader::SplatCacheFile>& cache_file)
+    {
+        auto import_start = std::chrono::high_resolution_clock::now();
+
+        const size_t count = cache_file->get_surface_count();
+        const VkDeviceSize size = sizeof(GaussianSurface) * count;
+
+        size_t first = 0;
+        if (!gaussian_buffer.append_uninitialized(count, first))
+        {
+            std::cerr << "Failed to add " << count << " cached gaussians, the scene is unchanged" << std::endl;
+            return;
+        }
+
+        const GPU_Buffer& destination = gaussian_buffer.get_buffer();
+        const VkDeviceSize destination_offset = sizeof(GaussianSurface) * first;
+
+        //The whole page aligned mapping is imported, the surfaces are copied from their offset inside it
+        VkBuffer imported_buffer = VK_NULL_HANDLE;
+        VkDeviceMemory imported_memory = VK_NULL_HANDLE;
+        TimelinePoint point{ QueueLane::Transfer, 0 };
+
+        if (count != 0 && utils::MemoryUtils::import_host_memory(engine_context, cache_file->get_mapping(), cache_file->get_mapping_size(),
+                                                                 imported_buffer, imported_memory))
+        {
+            auto upload_manager = engine_context.renderer->get_render_pass()->get_upload_manager();
+            point = upload_manager->copy(imported_buffer, cache_file->get_data_offset(), destination.buffer, destination_offset, size);
+
+            //Keeps the file mapped until the transfer queue is done reading it
+            upload_manager->release_after(point, [this, imported_buffer, imported_memory, cache_file]()
+            {
+                engine_context.dispatch_table.destroyBuffer(imported_buffer, nullptr);
+                engine_context.dispatch_table.freeMemory(imported_memory, nullptr);
+            });
+        }
+
+        if (point.value != 0)
+        {
+            last_gaussian_upload.path = UploadPath::HostImport;
+            last_gaussian_upload.bytes = size;
+            last_gaussian_upload.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - import_start).count();
+            last_gaussian_upload.megabytes_per_second = last_gaussian_upload.milliseconds > 0.0f ?
+                static_cast<float>(size) / (1024.0f * 1024.0f) / (last_gaussian_upload.milliseconds / 1000.0f) : 0.0f;
+
+            std::cout << "Imported " << count << " cached gaussians as host memory" << std::endl;
+        }
+        else if (count != 0)
+        {
+            //The mapping is an ordinary host source: copied straight into mapped VRAM or the staging ring, no intermediate copy
+            utils::MemoryUtils::write_device_buffer_range(engine_context, destination, destination_offset, cache_file->get_surfaces(), size,
+                                                          &last_gaussian_upload);
+
+            std::cout << "Uploaded " << count << " cached gaussians " << (last_gaussian_upload.path == UploadPath::Direct ? "directly to VRAM" : "through the staging ring")
+                      << " at " << last_gaussian_upload.megabytes_per_second << " MB/s" << std::endl;
+        }
+    }
+
+    void GPU_BufferContainer::finish_surface_change(bool replaced)
     {
+        gaussian_count = static_cast<uint32_t>(gaussian_buffer.get_size());
+
+        //Growing the gaussian buffer already waited for the device, appends that fit keep the per-splat buffers too
+        if (replaced || gaussian_buffer.get_capacity() != per_splat_capacity)
+        {
+            allocate_per_splat_buffers(gaussian_buffer.get_capacity());
+            per_splat_capacity = gaussian_buffer.get_capacity();
+        }
+
+        //Appends keep the existing buffers in place, only a new scene leaves holes worth closing
+        if (replaced)
+        {
+            compact_splat_memory();
+        }
+
+        scene_version++;
+    }
+
+    bool GPU_BufferContainer::reserve_compute_scratch(VkDeviceSize size)
+    {
+        if (compute_scratch_buffer.buffer != VK_NULL_HANDLE && compute_scratch_buffer.size >= size)
+        {
+            return false;
+        }
+
+        //Only grows, the passes that bound their scratch into the old memory notice the version change
         engine_context.dispatch_table.deviceWaitIdle();
 
         auto device_manager = engine_context.device_manager.get();
 
-        vmaDestroyBuffer(device_manager->get_allocator(), gaussian_buffer.buffer, gaussian_buffer.allocation);
-        gaussian_buffer = { VK_NULL_HANDLE, VK_NULL_HANDLE, {}, {} };
+        utils::MemoryUtils::destroy_buffer(device_manager->get_allocator(), compute_scratch_buffer);
+        utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), size,
+                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                          VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, MemoryCategory::Sort, compute_scratch_buffer, {},
+                                          device_manager->get_scratch_pool());
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) compute_scratch_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Compute Scratch");
+
+        compute_scratch_version++;
+
+        return true;
+    }
+
+    void GPU_BufferContainer::compact_splat_memory()
+    {
+        //Closes the holes the previous scene left between the new buffers. The splat records are rewritten every frame
+        //by whichever queue owns them and the color cache is recomputed for the new scene, so both stay in place
+        //instead of being copied by the transfer queue
+        utils::MemoryUtils::defragment_pool(engine_context, engine_context.device_manager->get_splat_pool(), { &gaussian_buffer.get_buffer() });
+    }
+
+    void GPU_BufferContainer::create_gaussian_memory(VkDeviceSize gaussian_size, GPU_Buffer& out_buffer)
+    {
+        auto device_manager = engine_context.device_manager.get();
+
+        const size_t count = gaussian_size / sizeof(GaussianSurface);
+
+        //The splat records and color cache (and, when growing, the old surfaces) are still alive and get replaced right after,
+        //so only growth counts
+        const VkDeviceSize scene_size = gaussian_size + (sizeof(SplatRecord) * frame_count + sizeof(uint32_t) * 2) * std::max<size_t>(count, 1);
+        const VkDeviceSize held_size = utils::MemoryTracker::get_category_bytes(MemoryCategory::Splats);
+
+        VkDeviceSize available = 0;
+        gaussians_in_system_memory = !utils::MemoryTracker::fits_device_local_budget(device_manager->get_allocator(),
+                                                                                      scene_size > held_size ? scene_size - held_size : 0, &available);
+
+        if (gaussians_in_system_memory)
+        {
+            //Falls back before the allocation fails: the surfaces stay in host memory and are read over the bus,
+            //which leaves VRAM to the per-splat buffers the passes write every frame
+            std::cout << "Warning: " << count << " gaussians need " << scene_size / (1024 * 1024) << " MB but only " << available / (1024 * 1024)
+                      << " MB of VRAM budget is left, keeping the surfaces in system memory" << std::endl;
+
+            utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), gaussian_size,
+                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                              VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                              VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                                              VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                              MemoryCategory::Splats, out_buffer, device_manager->get_shared_queue_families());
+        }
+        else
+        {
+            //Transfer source for the copy into a larger buffer when surfaces are appended
+            utils::MemoryUtils::create_device_buffer_prefer_mapped(engine_context, gaussian_size,
+                                                                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                                   MemoryCategory::Splats, out_buffer);
+        }
+
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) out_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Gaussian Buffer");
+    }
+
+    void GPU_BufferContainer::allocate_per_splat_buffers(size_t count)
+    {
+        auto device_manager = engine_context.device_manager.get();
+
+        //Screen space records are produced on the GPU, so only device memory is needed.
+        //Exclusive to one family at a time: the passes transfer ownership from compute to graphics every frame
+        destroy_splat_record_buffers();
+        splat_record_buffers.resize(frame_count);
+
+        VkDeviceSize record_buffer_size = sizeof(SplatRecord) * std::max<size_t>(count, 1);
+        for (auto& splat_record_buffer : splat_record_buffers)
+        {
+            utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(),
+                                              record_buffer_size,
+                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                              VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, MemoryCategory::Splats, splat_record_buffer, {},
+                                              device_manager->get_splat_pool());
+            utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) splat_record_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Splat Record Buffer");
+        }
+
+        //Two uints per splat (RGBA16F)
+        utils::MemoryUtils::destroy_buffer(device_manager->get_allocator(), color_cache_buffer);
+
+        VkDeviceSize color_cache_size = sizeof(uint32_t) * 2 * std::max<size_t>(count, 1);
+        utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(),
+                                          color_cache_size,
+                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                          VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, MemoryCategory::Splats, color_cache_buffer,
+                                          device_manager->get_shared_queue_families(), //Persists across frames whichever queue runs the cache pass
+                                          device_manager->get_splat_pool());
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) color_cache_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Color Cache Buffer");
+    }
+
+    void GPU_BufferContainer::destroy_splat_record_buffers()
+    {
+        for (auto& splat_record_buffer : splat_record_buffers)
+        {
+            utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), splat_record_buffer);
+        }
+
+        splat_record_buffers.clear();
+    }
+
+    void GPU_BufferContainer::update_camera_buffer(const camera::FirstPersonCamera& first_person_camera, VkExtent2D extent, uint32_t frame)
+    {
+        frame_index = frame;
+        frame_uniforms->begin_frame(frame);
+
+        CameraData camera_data{};
+
+        camera_data.projection = first_person_camera.get_projection_matrix();
+        camera_data.view = first_person_camera.get_view_matrix();
+        camera_data.position = glm::vec4(first_person_camera.get_position(), 1.0f);
+
+        //Focal lengths in pixels, derived from the projection so the compute passes match the rasterizer
+        const auto width = static_cast<float>(extent.width);
+        const auto height = static_cast<float>(extent.height);
+        camera_data.viewport = glm::vec4(width, height,
+                                         0.5f * width * camera_data.projection[0][0],
+                                         0.5f * height * std::abs(camera_data.projection[1][1]));
+
+        camera_data.overdraw_enabled = overdraw_enabled ? 1u : 0u;
+        camera_data.overdraw_address = overdraw_enabled ? overdraw_buffer.buffer_address : 0;
 
-        utils::MemoryUtils::create_vertex_buffer_with_staging(engine_context,
-                                                              gaussians,
-                                                              engine_context.renderer->get_render_pass()->get_command_pool(),
-                                                              gaussian_buffer);
+        //This frame slot has been waited on, so the GPU is done reading this part of the ring
+        camera_data_address = frame_uniforms->write(camera_data);
     }
 }
\ No newline at end of file
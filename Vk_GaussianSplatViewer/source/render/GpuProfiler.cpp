@@ -0,0 +1,332 @@
+#include "renderer/GpuProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "structs/EngineContext.h"
+
+namespace core::renderer
+{
+    namespace
+    {
+        //Label colors by nesting depth, so passes and their dispatches are told apart in captures
+        constexpr float label_colors[3][4] =
+        {
+            { 0.95f, 0.55f, 0.15f, 1.0f },
+            { 0.25f, 0.65f, 0.95f, 1.0f },
+            { 0.45f, 0.85f, 0.35f, 1.0f }
+        };
+    }
+
+    GpuProfiler::GpuProfiler(EngineContext& engine_context) : engine_context(engine_context)
+    {
+    }
+
+    bool GpuProfiler::init(uint32_t frame_count, uint32_t max_scopes_per_lane, uint32_t history_length)
+    {
+        auto* device_manager = engine_context.device_manager.get();
+
+        has_debug_labels = engine_context.dispatch_table.fp_vkCmdBeginDebugUtilsLabelEXT != nullptr &&
+                           engine_context.dispatch_table.fp_vkCmdEndDebugUtilsLabelEXT != nullptr;
+
+        this->history_length = std::max(history_length, 1u);
+        queries_per_lane = max_scopes_per_lane * 2;
+
+        timestamp_period = device_manager->get_physical_device().properties.limits.timestampPeriod;
+
+        //Lanes may run on different families, only bits valid on all of them are compared
+        const uint32_t valid_bits = std::min(device_manager->get_timestamp_valid_bits(device_manager->get_graphics_queue_family()),
+                                             device_manager->get_timestamp_valid_bits(device_manager->get_compute_queue_family()));
+        timestamp_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+        supported = timestamp_period > 0.0f && valid_bits > 0;
+        if (!supported)
+        {
+            std::cout << "queue timestamps not supported, GPU profiler disabled\n";
+            return true;
+        }
+
+        VkQueryPoolCreateInfo query_pool_info{};
+        query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        query_pool_info.queryCount = queries_per_lane * static_cast<uint32_t>(QueueLane::Count);
+
+        frames.resize(frame_count);
+        for (auto& frame : frames)
+        {
+            if (engine_context.dispatch_table.createQueryPool(&query_pool_info, nullptr, &frame.query_pool) != VK_SUCCESS)
+            {
+                std::cout << "failed to create timestamp query pool\n";
+                cleanup();
+                supported = false;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void GpuProfiler::cleanup()
+    {
+        for (auto& frame : frames)
+        {
+            if (frame.query_pool != VK_NULL_HANDLE)
+            {
+                engine_context.dispatch_table.destroyQueryPool(frame.query_pool, nullptr);
+            }
+        }
+        frames.clear();
+    }
+
+    void GpuProfiler::begin_frame(uint32_t frame)
+    {
+        //Query ranges used by the frame recorded last, read when its slot comes around again
+        if (current_frame < frames.size())
+        {
+            for (size_t lane = 0; lane < std::size(lanes); ++lane)
+            {
+                frames[current_frame].lane_query_counts[lane] = lanes[lane].used_queries;
+            }
+        }
+
+        current_frame = frame;
+
+        if (frame < frames.size())
+        {
+            read_results(frame);
+            frames[frame].records.clear();
+            std::fill(std::begin(frames[frame].lane_query_counts), std::end(frames[frame].lane_query_counts), 0u);
+        }
+
+        for (auto& lane : lanes)
+        {
+            lane = {};
+        }
+    }
+
+    void GpuProfiler::begin_lane(VkCommandBuffer command_buffer, QueueLane lane)
+    {
+        LaneState& state = lanes[static_cast<size_t>(lane)];
+        state = {};
+        state.command_buffer = command_buffer;
+        state.first_query = static_cast<uint32_t>(lane) * queries_per_lane;
+
+        if (supported && current_frame < frames.size())
+        {
+            engine_context.dispatch_table.cmdResetQueryPool(command_buffer, frames[current_frame].query_pool, state.first_query, queries_per_lane);
+        }
+    }
+
+    void GpuProfiler::begin_scope(VkCommandBuffer command_buffer, const char* name)
+    {
+        QueueLane lane_id = QueueLane::Graphics;
+        LaneState* lane = find_lane(command_buffer, &lane_id);
+
+        if (has_debug_labels)
+        {
+            const size_t depth = lane != nullptr ? std::min(lane->open_scopes.size(), std::size(label_colors) - 1) : 0;
+
+            VkDebugUtilsLabelEXT label{};
+            label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+            label.pLabelName = name;
+            std::copy_n(label_colors[depth], 4, label.color);
+            engine_context.dispatch_table.cmdBeginDebugUtilsLabelEXT(command_buffer, &label);
+        }
+
+        if (!supported || lane == nullptr)
+        {
+            return;
+        }
+
+        if (lane->used_queries + 2 > queries_per_lane)
+        {
+            lane->open_scopes.push_back(-1);
+            return;
+        }
+
+        FrameQueries& frame = frames[current_frame];
+
+        ScopeRecord record;
+        record.name = name;
+        record.depth = static_cast<uint32_t>(lane->open_scopes.size());
+        record.lane = lane_id;
+        record.query = lane->first_query + lane->used_queries;
+        lane->used_queries += 2;
+
+        //Both ends wait for all prior work, so sibling scopes measure back to back instead of overlapping
+        engine_context.dispatch_table.cmdWriteTimestamp2(command_buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, frame.query_pool, record.query);
+
+        lane->open_scopes.push_back(static_cast<int32_t>(frame.records.size()));
+        frame.records.push_back(std::move(record));
+    }
+
+    void GpuProfiler::end_scope(VkCommandBuffer command_buffer)
+    {
+        LaneState* lane = find_lane(command_buffer);
+
+        if (supported && lane != nullptr && !lane->open_scopes.empty())
+        {
+            const int32_t record_index = lane->open_scopes.back();
+            lane->open_scopes.pop_back();
+
+            if (record_index >= 0)
+            {
+                ScopeRecord& record = frames[current_frame].records[record_index];
+                engine_context.dispatch_table.cmdWriteTimestamp2(command_buffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                 frames[current_frame].query_pool, record.query + 1);
+                record.closed = true;
+            }
+        }
+
+        if (has_debug_labels)
+        {
+            engine_context.dispatch_table.cmdEndDebugUtilsLabelEXT(command_buffer);
+        }
+    }
+
+    float GpuProfiler::get_scope_ms(const char* name) const
+    {
+        for (const auto& scope : last_frame)
+        {
+            if (scope.name == name)
+            {
+                return scope.milliseconds;
+            }
+        }
+
+        return 0.0f;
+    }
+
+    bool GpuProfiler::export_csv(const std::string& file_path) const
+    {
+        std::ofstream file(file_path, std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "Failed to write GPU profile " << file_path << std::endl;
+            return false;
+        }
+
+        file << "frame";
+        for (const auto& scope : history)
+        {
+            //Nesting depth is kept as leading '>' in the column name
+            file << "," << std::string(scope.depth, '>') << scope.name;
+        }
+        file << "\n";
+
+        for (uint32_t i = 0; i < history_length; ++i)
+        {
+            const uint32_t index = (history_offset + i) % history_length;
+
+            file << i;
+            for (const auto& scope : history)
+            {
+                file << "," << scope.values[index];
+            }
+            file << "\n";
+        }
+
+        std::cout << "GPU profile written to " << file_path << "\n";
+
+        return true;
+    }
+
+    GpuProfiler::LaneState* GpuProfiler::find_lane(VkCommandBuffer command_buffer, QueueLane* out_lane)
+    {
+        for (size_t i = 0; i < std::size(lanes); ++i)
+        {
+            if (lanes[i].command_buffer == command_buffer)
+            {
+                if (out_lane != nullptr)
+                {
+                    *out_lane = static_cast<QueueLane>(i);
+                }
+                return &lanes[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    void GpuProfiler::read_results(uint32_t frame)
+    {
+        FrameQueries& frame_queries = frames[frame];
+        if (!supported || frame_queries.records.empty())
+        {
+            return;
+        }
+
+        const uint32_t query_count = queries_per_lane * static_cast<uint32_t>(QueueLane::Count);
+        std::vector<uint64_t> timestamps(query_count, 0);
+
+        //The slot was just waited on, every written query is available
+        for (size_t lane = 0; lane < std::size(lanes); ++lane)
+        {
+            const uint32_t used = frame_queries.lane_query_counts[lane];
+            const uint32_t first = static_cast<uint32_t>(lane) * queries_per_lane;
+
+            if (used > 0 && engine_context.dispatch_table.getQueryPoolResults(frame_queries.query_pool, first, used, sizeof(uint64_t) * used,
+                                                                              timestamps.data() + first, sizeof(uint64_t),
+                                                                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+            {
+                return;
+            }
+        }
+
+        last_frame.clear();
+
+        for (const auto& record : frame_queries.records)
+        {
+            if (!record.closed)
+            {
+                continue;
+            }
+
+            const uint64_t ticks = (timestamps[record.query + 1] - timestamps[record.query]) & timestamp_mask;
+            const float milliseconds = static_cast<float>(ticks) * timestamp_period / 1000000.0f;
+
+            auto existing = std::find_if(last_frame.begin(), last_frame.end(), [&record](const GpuScopeTiming& timing)
+            {
+                return timing.name == record.name && timing.depth == record.depth;
+            });
+
+            if (existing != last_frame.end())
+            {
+                existing->milliseconds += milliseconds;
+            }
+            else
+            {
+                last_frame.push_back({ record.name, record.depth, milliseconds });
+            }
+        }
+
+        push_history();
+    }
+
+    void GpuProfiler::push_history()
+    {
+        for (auto& scope : history)
+        {
+            scope.values[history_offset] = 0.0f;
+        }
+
+        for (const auto& timing : last_frame)
+        {
+            auto existing = std::find_if(history.begin(), history.end(), [&timing](const GpuScopeHistory& scope)
+            {
+                return scope.name == timing.name && scope.depth == timing.depth;
+            });
+
+            if (existing == history.end())
+            {
+                history.push_back({ timing.name, timing.depth, std::vector<float>(history_length, 0.0f) });
+                existing = history.end() - 1;
+            }
+
+            existing->values[history_offset] = timing.milliseconds;
+        }
+
+        history_offset = (history_offset + 1) % history_length;
+    }
+}
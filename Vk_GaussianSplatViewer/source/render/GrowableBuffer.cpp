@@ -0,0 +1,145 @@
+#include "renderer/GrowableBuffer.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "renderer/RenderPass.h"
+#include "renderer/Renderer.h"
+#include "renderer/UploadManager.h"
+#include "structs/EngineContext.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+
+namespace core::renderer
+{
+    GrowableBuffer::GrowableBuffer(EngineContext& engine_context, VkDeviceSize element_size, AllocateFunction allocate) :
+        engine_context(engine_context), element_size(element_size), allocate(std::move(allocate))
+    {
+    }
+
+    void GrowableBuffer::reset(size_t p_capacity)
+    {
+        engine_context.dispatch_table.deviceWaitIdle();
+
+        destroy();
+
+        if (p_capacity > 0)
+        {
+            allocate(p_capacity * element_size, buffer);
+            capacity = p_capacity;
+        }
+    }
+
+    bool GrowableBuffer::reserve(size_t p_capacity)
+    {
+        if (p_capacity <= capacity)
+        {
+            return true;
+        }
+
+        //Frames in flight read the old buffer through its device address
+        engine_context.dispatch_table.deviceWaitIdle();
+
+        const size_t new_capacity = std::max({ p_capacity, capacity * 2, static_cast<size_t>(1) });
+
+        GPU_Buffer new_buffer;
+        allocate(new_capacity * element_size, new_buffer);
+
+        if (size > 0)
+        {
+            UploadManager* upload_manager = engine_context.renderer->get_render_pass()->get_upload_manager();
+
+            const TimelinePoint point = upload_manager->copy(buffer.buffer, 0, new_buffer.buffer, 0, size * element_size);
+            if (point.value == 0)
+            {
+                //The new buffer holds nothing, keep the old one and its elements
+                std::cerr << "Failed to copy " << size << " elements into the grown buffer, keeping " << capacity << " elements" << std::endl;
+                utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), new_buffer);
+                return false;
+            }
+
+            //The old buffer is the source of the copy, freed once the transfer lane is past it
+            upload_manager->release_after(point, [allocator = engine_context.device_manager->get_allocator(), old_buffer = buffer]() mutable
+            {
+                utils::MemoryUtils::destroy_buffer(allocator, old_buffer);
+            });
+        }
+        else
+        {
+            utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer);
+        }
+
+        std::cout << "Growable buffer: " << capacity << " -> " << new_capacity << " elements (" << size << " copied on the GPU)" << std::endl;
+
+        buffer = new_buffer;
+        capacity = new_capacity;
+
+        return true;
+    }
+
+    bool GrowableBuffer::append(size_t count, const ElementWriter& writer, UploadReport* report)
+    {
+        size_t first = 0;
+        if (!append_uninitialized(count, first))
+        {
+            return false;
+        }
+
+        write(first, count, writer, report);
+
+        return true;
+    }
+
+    bool GrowableBuffer::append_uninitialized(size_t count, size_t& first)
+    {
+        if (!reserve(size + count))
+        {
+            return false;
+        }
+
+        first = size;
+        size += count;
+
+        return true;
+    }
+
+    TimelinePoint GrowableBuffer::update(size_t first, const void* data, size_t count)
+    {
+        if (first + count > size)
+        {
+            std::cerr << "Growable buffer update [" << first << ", " << first + count << ") is past the " << size << " elements" << std::endl;
+            return { QueueLane::Transfer, 0 };
+        }
+
+        //Unlike appended elements, these are read by the frames in flight. A pending growth copy may also still write them
+        RenderPass* render_pass = engine_context.renderer->get_render_pass();
+        const FrameScheduler* frame_scheduler = render_pass->get_frame_scheduler();
+        frame_scheduler->wait_for(frame_scheduler->get_last_submitted(QueueLane::Graphics));
+        frame_scheduler->wait_for(frame_scheduler->get_last_submitted(QueueLane::Compute));
+        frame_scheduler->wait_for(render_pass->get_upload_manager()->get_last_upload());
+
+        return utils::MemoryUtils::write_device_buffer_range(engine_context, buffer, first * element_size, data, count * element_size);
+    }
+
+    void GrowableBuffer::destroy()
+    {
+        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer);
+
+        buffer = {};
+        size = 0;
+        capacity = 0;
+    }
+
+    TimelinePoint GrowableBuffer::write(size_t first, size_t count, const ElementWriter& writer, UploadReport* report)
+    {
+        if (count == 0)
+        {
+            return { QueueLane::Transfer, 0 };
+        }
+
+        return utils::MemoryUtils::write_device_buffer_range(engine_context, buffer, first * element_size, count * element_size, element_size,
+                                                             [this, &writer](void* destination, VkDeviceSize offset, VkDeviceSize size)
+        {
+            writer(destination, static_cast<size_t>(offset / element_size), static_cast<size_t>(size / element_size));
+        }, report);
+    }
+}
@@ -0,0 +1,114 @@
+#include "renderer/PipelineStatistics.h"
+
+#include <iostream>
+
+#include "structs/EngineContext.h"
+
+namespace core::renderer
+{
+    namespace
+    {
+        //Results come back in bit order: vertex invocations, clipping primitives, fragment invocations
+        constexpr VkQueryPipelineStatisticFlags statistic_flags = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                                                                  VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+                                                                  VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+        constexpr uint32_t statistic_count = 3;
+    }
+
+    PipelineStatistics::PipelineStatistics(EngineContext& engine_context) : engine_context(engine_context)
+    {
+    }
+
+    bool PipelineStatistics::init(uint32_t frame_count)
+    {
+        supported = engine_context.device_manager->is_pipeline_statistics_query_supported();
+        if (!supported)
+        {
+            return true;
+        }
+
+        VkQueryPoolCreateInfo query_pool_info{};
+        query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        query_pool_info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        query_pool_info.queryCount = 1;
+        query_pool_info.pipelineStatistics = statistic_flags;
+
+        frames.resize(frame_count);
+        for (auto& frame : frames)
+        {
+            if (engine_context.dispatch_table.createQueryPool(&query_pool_info, nullptr, &frame.query_pool) != VK_SUCCESS)
+            {
+                std::cout << "failed to create pipeline statistics query pool\n";
+                cleanup();
+                supported = false;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void PipelineStatistics::cleanup()
+    {
+        for (auto& frame : frames)
+        {
+            if (frame.query_pool != VK_NULL_HANDLE)
+            {
+                engine_context.dispatch_table.destroyQueryPool(frame.query_pool, nullptr);
+            }
+        }
+        frames.clear();
+    }
+
+    void PipelineStatistics::begin_frame(uint32_t frame)
+    {
+        current_frame = frame;
+        if (!supported || frame >= frames.size())
+        {
+            return;
+        }
+
+        FrameQuery& frame_query = frames[frame];
+        has_last_results = false;
+
+        if (frame_query.written)
+        {
+            uint64_t results[statistic_count]{};
+            if (engine_context.dispatch_table.getQueryPoolResults(frame_query.query_pool, 0, 1, sizeof(results), results, sizeof(results),
+                                                                  VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+            {
+                vertex_invocations = results[0];
+                clipping_primitives = results[1];
+                fragment_invocations = results[2];
+                has_last_results = true;
+            }
+        }
+
+        frame_query.written = false;
+    }
+
+    void PipelineStatistics::reset(VkCommandBuffer command_buffer)
+    {
+        if (supported && current_frame < frames.size())
+        {
+            engine_context.dispatch_table.cmdResetQueryPool(command_buffer, frames[current_frame].query_pool, 0, 1);
+        }
+    }
+
+    void PipelineStatistics::begin(VkCommandBuffer command_buffer)
+    {
+        if (supported && current_frame < frames.size())
+        {
+            engine_context.dispatch_table.cmdBeginQuery(command_buffer, frames[current_frame].query_pool, 0, 0);
+        }
+    }
+
+    void PipelineStatistics::end(VkCommandBuffer command_buffer)
+    {
+        if (supported && current_frame < frames.size())
+        {
+            engine_context.dispatch_table.cmdEndQuery(command_buffer, frames[current_frame].query_pool, 0);
+            frames[current_frame].written = true;
+        }
+    }
+}
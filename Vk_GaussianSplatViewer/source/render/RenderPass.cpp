@@ -1,12 +1,23 @@
 ﻿
 #include "renderer/RenderPass.h"
+#include "core/CpuProfiler.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include "renderer/subpasses/ColorCachePass.h"
 #include "renderer/subpasses/GeometryPass.h"
 #include "renderer/subpasses/ImGuiPass.h"
+#include "renderer/subpasses/OverdrawPass.h"
+#include "renderer/subpasses/PreprocessPass.h"
+#include "renderer/subpasses/TileRasterPass.h"
 #include "structs/scene/PushConstantBlock.h"
 #include "structs/geometry/Vertex.h"
+#include "config/Config.inl"
 #include "structs/EngineContext.h"
+#include "vulkanapp/utils/ImageUtils.h"
+#include "vulkanapp/utils/MemoryTracker.h"
+#include "vulkanapp/utils/MemoryUtils.h"
 #include "vulkanapp/utils/RenderUtils.h"
 
 namespace core::renderer
@@ -24,6 +35,7 @@ namespace core::renderer
     void RenderPass::allocate_and_record_command_buffers()
     {
         command_buffers.assign(max_frames_in_flight, VK_NULL_HANDLE);
+        compute_command_buffers.assign(compute_command_pools.size(), VK_NULL_HANDLE);
 
         for (uint32_t i = 0; i < max_frames_in_flight; i++)
         {
@@ -35,21 +47,43 @@ namespace core::renderer
     {
         create_sync_objects();
         create_renderpass_resources(true);
+
+        if (swapchain_manager->is_offscreen())
+        {
+            create_readback_buffers();
+        }
     }
 
     void RenderPass::record_subpasses(uint32_t image_index)
     {
-        //TODO: Need better sync -- works for now, though
-        engine_context.dispatch_table.deviceWaitIdle();
+        GSV_CPU_ZONE("Record subpasses");
+
+        auto record_start = std::chrono::high_resolution_clock::now();
+
+        //Scratch buffers that are only used by compute are exclusive to the queue family running it,
+        //so switching queues lets the frames in flight drain first
+        const bool use_async_compute = device_manager->is_async_compute_supported() &&
+                                       engine_context.renderer->get_render_settings().use_async_compute;
+        if (use_async_compute != async_compute_active)
+        {
+            engine_context.dispatch_table.deviceWaitIdle();
+            async_compute_active = use_async_compute;
+        }
 
         for (auto & subpasse : subpasses)
         {
+            subpasse->set_async_compute(async_compute_active);
             subpasse->frame_pre_recording();
         }
 
+        //This slot was waited on before acquiring, so only this frame's copies are touched here.
+        //Written after frame_pre_recording, which may (re)create buffers the camera data points to
+        engine_context.buffer_container->update_camera_buffer(*engine_context.renderer->get_camera(), swapchain_manager->get_extent(),
+                                                              static_cast<uint32_t>(current_frame));
+
         auto command_buffer = get_command_buffer(current_frame);
 
-        engine_context.dispatch_table.resetCommandBuffer(*command_buffer, 0);
+        engine_context.dispatch_table.resetCommandPool(frame_command_pools[current_frame], 0);
 
         VkCommandBufferBeginInfo begin_info = {};
         begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -60,16 +94,78 @@ namespace core::renderer
             return;
         }
 
+        //Compute work of all passes goes first: into its own command buffer for the async queue,
+        //otherwise at the start of the graphics command buffer
+        VkCommandBuffer compute_command_buffer = *command_buffer;
+        if (async_compute_active)
+        {
+            engine_context.dispatch_table.resetCommandPool(compute_command_pools[current_frame], 0);
+            compute_command_buffer = compute_command_buffers[current_frame];
+
+            if (engine_context.dispatch_table.beginCommandBuffer(compute_command_buffer, &begin_info) != VK_SUCCESS)
+            {
+                std::cout << "failed to begin recording compute command buffer\n";
+                return;
+            }
+        }
+
+        //Each queue gets its own query range, reset by the command buffer that writes it
+        gpu_profiler->begin_lane(*command_buffer, QueueLane::Graphics);
+        if (async_compute_active)
+        {
+            gpu_profiler->begin_lane(compute_command_buffer, QueueLane::Compute);
+        }
+
+        gpu_profiler->begin_scope(compute_command_buffer, compute_scope_name);
+
+        for (auto& subpass : subpasses)
+        {
+            subpass->init_pass_new_frame(compute_command_buffer, depth_stencil_image.get(), current_frame);
+
+            if (subpass->has_compute_commands())
+            {
+                gpu_profiler->begin_scope(compute_command_buffer, subpass->get_name());
+                subpass->record_compute_commands(&compute_command_buffer);
+                gpu_profiler->end_scope(compute_command_buffer);
+            }
+        }
+
+        gpu_profiler->end_scope(compute_command_buffer);
+
+        if (async_compute_active && engine_context.dispatch_table.endCommandBuffer(compute_command_buffer) != VK_SUCCESS)
+        {
+            std::cout << "failed to record compute command buffer\n";
+        }
+
+        gpu_profiler->begin_scope(*command_buffer, graphics_scope_name);
+
+        //Offscreen images are never presented, they stay in attachment layout and are copied out instead
+        const bool offscreen = swapchain_manager->is_offscreen();
+
         for (size_t i = 0; i < subpasses.size(); ++i)
         {
             subpasses[i]->init_pass_new_frame(*command_buffer, depth_stencil_image.get(), current_frame);
-            subpasses[i]->record_commands(command_buffer, image_index, i == subpasses.size() - 1);
+
+            gpu_profiler->begin_scope(*command_buffer, subpasses[i]->get_name());
+            subpasses[i]->record_commands(command_buffer, image_index, !offscreen && i == subpasses.size() - 1);
+            gpu_profiler->end_scope(*command_buffer);
         }
 
+        if (offscreen)
+        {
+            gpu_profiler->begin_scope(*command_buffer, "Readback");
+            record_readback(*command_buffer, image_index);
+            gpu_profiler->end_scope(*command_buffer);
+        }
+
+        gpu_profiler->end_scope(*command_buffer);
+
         if (engine_context.dispatch_table.endCommandBuffer(*command_buffer) != VK_SUCCESS)
         {
             std::cout << "failed to record command buffer\n";
         }
+
+        record_ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - record_start).count();
     }
 
     void RenderPass::record_commands_and_draw()
@@ -77,8 +173,39 @@ namespace core::renderer
         uint32_t image_index = 0;
         auto dispatch_table = engine_context.dispatch_table;
 
+        //Only block on the frame slot that is about to be reused, the other frames keep running on the GPU
+        auto wait_start = std::chrono::high_resolution_clock::now();
+        {
+            GSV_CPU_ZONE("Wait frame slot");
+            frame_scheduler->wait_for_frame_slot(static_cast<uint32_t>(current_frame));
+        }
+        slot_wait_ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - wait_start).count();
+
+        frame_scheduler->poll();
+        upload_manager->retire_completed();
+        gpu_profiler->begin_frame(static_cast<uint32_t>(current_frame));
+        pipeline_statistics->begin_frame(static_cast<uint32_t>(current_frame));
+
+        vmaSetCurrentFrameIndex(device_manager->get_allocator(), ++allocator_frame_index);
+        utils::MemoryTracker::check_budget(device_manager->get_allocator());
+
+        deliver_readback(static_cast<uint32_t>(current_frame));
+
+        //Each frame slot owns one offscreen image, there is nothing to acquire
+        if (swapchain_manager->is_offscreen())
+        {
+            image_index = static_cast<uint32_t>(current_frame);
+            record_subpasses(image_index);
+            draw_frame(image_index);
+            return;
+        }
+
         // We need to acquire the image before recording because we need image_index for layout transitions
-        VkResult result = dispatch_table.acquireNextImageKHR(swapchain_manager->get_swapchain(), UINT64_MAX, available_semaphores[current_frame], VK_NULL_HANDLE, &image_index);
+        VkResult result;
+        {
+            GSV_CPU_ZONE("Acquire image");
+            result = dispatch_table.acquireNextImageKHR(swapchain_manager->get_swapchain(), UINT64_MAX, available_semaphores[current_frame], VK_NULL_HANDLE, &image_index);
+        }
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR)
         {
@@ -103,6 +230,13 @@ namespace core::renderer
 
         reset_subpass_command_buffers();
         recreate_swapchain();
+
+        if (finished_semaphores.size() != swapchain_manager->get_images().size())
+        {
+            destroy_finished_semaphores();
+            create_finished_semaphores();
+        }
+
         create_renderpass_resources(false);
         set_new_camera_aspect_ratio();
     }
@@ -118,10 +252,18 @@ namespace core::renderer
         {
             if (available_semaphores[i] != VK_NULL_HANDLE)
                 dispatch_table.destroySemaphore(available_semaphores[i], nullptr);
-            if (finished_semaphores[i] != VK_NULL_HANDLE)
-                dispatch_table.destroySemaphore(finished_semaphores[i], nullptr);
-            if (in_flight_fences[i] != VK_NULL_HANDLE)
-                dispatch_table.destroyFence(in_flight_fences[i], nullptr);
+        }
+
+        destroy_finished_semaphores();
+
+        if (upload_manager)
+        {
+            upload_manager->cleanup();
+        }
+
+        if (frame_scheduler)
+        {
+            frame_scheduler->cleanup();
         }
 
         if (command_pool != VK_NULL_HANDLE)
@@ -130,13 +272,38 @@ namespace core::renderer
             command_pool = VK_NULL_HANDLE;
         }
 
-        if (depth_stencil_image)
+        for (auto& frame_command_pool : frame_command_pools)
+        {
+            dispatch_table.destroyCommandPool(frame_command_pool, nullptr);
+        }
+        frame_command_pools.clear();
+
+        for (auto& compute_command_pool : compute_command_pools)
         {
-            if (depth_stencil_image->view != VK_NULL_HANDLE)
-                dispatch_table.destroyImageView(depth_stencil_image->view, nullptr);
+            dispatch_table.destroyCommandPool(compute_command_pool, nullptr);
+        }
+        compute_command_pools.clear();
+        compute_command_buffers.clear();
 
-            if (depth_stencil_image->image != VK_NULL_HANDLE)
-                vmaDestroyImage(device_manager->get_allocator(), depth_stencil_image->image, depth_stencil_image->allocation);
+        if (gpu_profiler)
+        {
+            gpu_profiler->cleanup();
+        }
+
+        if (pipeline_statistics)
+        {
+            pipeline_statistics->cleanup();
+        }
+
+        for (auto& readback_buffer : readback_buffers)
+        {
+            utils::MemoryUtils::destroy_buffer(device_manager->get_allocator(), readback_buffer);
+        }
+        readback_buffers.clear();
+
+        if (depth_stencil_image)
+        {
+            utils::MemoryUtils::destroy_image(dispatch_table, device_manager->get_allocator(), *depth_stencil_image);
 
             depth_stencil_image.reset();
         }
@@ -149,13 +316,40 @@ namespace core::renderer
 
     void RenderPass::init_subpasses()
     {
+        subpasses.emplace_back(std::make_unique<ColorCachePass>(engine_context, max_frames_in_flight));
+        subpasses.emplace_back(std::make_unique<PreprocessPass>(engine_context, max_frames_in_flight));
         subpasses.emplace_back(std::make_unique<GeometryPass>(engine_context, max_frames_in_flight));
-        subpasses.emplace_back(std::make_unique<ImGuiPass>(engine_context, max_frames_in_flight));
+        subpasses.emplace_back(std::make_unique<TileRasterPass>(engine_context, max_frames_in_flight));
+
+        //Draws over the frame of either render mode while the overdraw view is selected
+        subpasses.emplace_back(std::make_unique<OverdrawPass>(engine_context, max_frames_in_flight));
+
+        //The UI needs a window
+        if (!swapchain_manager->is_offscreen())
+        {
+            subpasses.emplace_back(std::make_unique<ImGuiPass>(engine_context, max_frames_in_flight));
+        }
     }
 
     void RenderPass::create_command_pool()
     {
         utils::RenderUtils::create_command_pool(engine_context, command_pool);
+
+        frame_command_pools.assign(max_frames_in_flight, VK_NULL_HANDLE);
+        for (auto& frame_command_pool : frame_command_pools)
+        {
+            utils::RenderUtils::create_command_pool(engine_context, frame_command_pool, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        }
+
+        if (device_manager->is_async_compute_supported())
+        {
+            compute_command_pools.assign(max_frames_in_flight, VK_NULL_HANDLE);
+            for (auto& compute_command_pool : compute_command_pools)
+            {
+                utils::RenderUtils::create_command_pool(engine_context, compute_command_pool, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                                        device_manager->get_compute_queue_family());
+            }
+        }
     }
 
     void RenderPass::reset_command_pool()
@@ -167,17 +361,22 @@ namespace core::renderer
             command_pool = VK_NULL_HANDLE;
         }
 
-        if (depth_stencil_image)
+        for (auto& frame_command_pool : frame_command_pools)
         {
-            if (depth_stencil_image->view != VK_NULL_HANDLE)
-            {
-                engine_context.dispatch_table.destroyImageView(depth_stencil_image->view, nullptr);
-            }
+            engine_context.dispatch_table.destroyCommandPool(frame_command_pool, 0);
+        }
+        frame_command_pools.clear();
 
-            if (depth_stencil_image->image != VK_NULL_HANDLE)
-            {
-                vmaDestroyImage(device_manager->get_allocator(), depth_stencil_image->image, depth_stencil_image->allocation);
-            }
+        for (auto& compute_command_pool : compute_command_pools)
+        {
+            engine_context.dispatch_table.destroyCommandPool(compute_command_pool, 0);
+        }
+        compute_command_pools.clear();
+        compute_command_buffers.clear();
+
+        if (depth_stencil_image)
+        {
+            utils::MemoryUtils::destroy_image(engine_context.dispatch_table, device_manager->get_allocator(), *depth_stencil_image);
 
             depth_stencil_image.reset();
         }
@@ -197,7 +396,12 @@ namespace core::renderer
     {
         if (VkCommandBuffer* command_buffer = get_command_buffer(image))
         {
-            utils::RenderUtils::allocate_command_buffer(engine_context, command_pool, *command_buffer);
+            utils::RenderUtils::allocate_command_buffer(engine_context, frame_command_pools[image], *command_buffer);
+        }
+
+        if (image < compute_command_buffers.size())
+        {
+            utils::RenderUtils::allocate_command_buffer(engine_context, compute_command_pools[image], compute_command_buffers[image]);
         }
     }
 
@@ -244,53 +448,97 @@ namespace core::renderer
 
     bool RenderPass::draw_frame(uint32_t image_index)
     {
-        auto dispatch_table = engine_context.dispatch_table;
-        dispatch_table.waitForFences(1, &in_flight_fences[current_frame], VK_TRUE, UINT64_MAX);
+        GSV_CPU_ZONE("Draw frame");
 
-        if (image_in_flight[image_index] != VK_NULL_HANDLE)
-        {
-            dispatch_table.waitForFences(1, &image_in_flight[image_index], VK_TRUE, UINT64_MAX);
-        }
-
-        image_in_flight[image_index] = in_flight_fences[current_frame];
+        auto dispatch_table = engine_context.dispatch_table;
 
-        VkSubmitInfo2 submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        //Offscreen frames neither wait for an acquired image nor signal a present
+        const bool offscreen = swapchain_manager->is_offscreen();
 
         VkSemaphoreSubmitInfo waitSemaphoreSubmitInfo = {};
         waitSemaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
         waitSemaphoreSubmitInfo.semaphore = available_semaphores[current_frame];
         waitSemaphoreSubmitInfo.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
 
-        submitInfo.waitSemaphoreInfoCount = 1;
-        submitInfo.pWaitSemaphoreInfos = &waitSemaphoreSubmitInfo;
-
-        VkCommandBufferSubmitInfo commandBufferSubmitInfo = {};
-        commandBufferSubmitInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-        commandBufferSubmitInfo.commandBuffer = command_buffers[current_frame];
-
-        submitInfo.commandBufferInfoCount = 1;
-        submitInfo.pCommandBufferInfos = &commandBufferSubmitInfo;
-
         VkSemaphoreSubmitInfo signalSemaphoreSubmitInfo = {};
         signalSemaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
-        signalSemaphoreSubmitInfo.semaphore = finished_semaphores[current_frame];
+        signalSemaphoreSubmitInfo.semaphore = offscreen ? VK_NULL_HANDLE : finished_semaphores[image_index];
         signalSemaphoreSubmitInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT; // Signal when all commands are done
 
-        submitInfo.signalSemaphoreInfoCount = 1;
-        submitInfo.pSignalSemaphoreInfos = &signalSemaphoreSubmitInfo;
+        std::vector<VkSemaphoreSubmitInfo> wait_semaphores;
+        std::vector<VkSemaphoreSubmitInfo> binary_signal_semaphores;
+        if (!offscreen)
+        {
+            wait_semaphores.push_back(waitSemaphoreSubmitInfo);
+            binary_signal_semaphores.push_back(signalSemaphoreSubmitInfo);
+        }
+
+        //Whichever submission runs the frame's compute work waits for buffer uploads on the transfer lane.
+        //Already signaled unless something was uploaded since the last frame
+        std::vector<VkSemaphoreSubmitInfo> upload_waits;
+        if (TimelinePoint upload_point = upload_manager->get_last_upload(); upload_point.value != 0)
+        {
+            upload_waits.push_back(frame_scheduler->make_wait_info(upload_point, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+        }
+
+        //Async compute goes first on its own lane; graphics only waits for it where the results are consumed
+        if (async_compute_active)
+        {
+            TimelinePoint previous_compute = frame_scheduler->get_last_submitted(QueueLane::Compute);
+            TimelinePoint compute_point = frame_scheduler->submit(QueueLane::Compute, device_manager->get_compute_queue(),
+                                                                  { compute_command_buffers[current_frame] }, upload_waits, {}, "compute");
+            if (compute_point.value == previous_compute.value)
+            {
+                //The graphics work reads the compute results, so it is not submitted either
+                if (!offscreen)
+                {
+                    skip_acquired_frame(waitSemaphoreSubmitInfo);
+                }
+
+                return false;
+            }
+
+            VkPipelineStageFlags2 consumer_stages = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT |
+                                                    VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            if (device_manager->is_mesh_shader_supported())
+            {
+                consumer_stages |= VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+            }
 
-        dispatch_table.resetFences(1, &in_flight_fences[current_frame]);
-        if (dispatch_table.queueSubmit2(device_manager->get_graphics_queue(), 1, &submitInfo, in_flight_fences[current_frame]) != VK_SUCCESS)
+            wait_semaphores.push_back(frame_scheduler->make_wait_info(compute_point, consumer_stages));
+        }
+        else
+        {
+            wait_semaphores.insert(wait_semaphores.end(), upload_waits.begin(), upload_waits.end());
+        }
+
+        //Signals the graphics timeline too, the frame slot is free again once that value is reached
+        TimelinePoint previous_graphics = frame_scheduler->get_last_submitted(QueueLane::Graphics);
+        if (frame_scheduler->submit_frame(static_cast<uint32_t>(current_frame), device_manager->get_graphics_queue(), command_buffers[current_frame],
+                                          wait_semaphores, binary_signal_semaphores).value == previous_graphics.value)
         {
-            std::cout << "failed to submit draw command buffer\n";
+            if (!offscreen)
+            {
+                skip_acquired_frame(waitSemaphoreSubmitInfo);
+            }
+
             return false;
         }
 
+        if (offscreen)
+        {
+            readback_frame_numbers[current_frame] = submitted_frame_count++;
+            readback_tags[current_frame] = frame_tag;
+            readback_pending[current_frame] = true;
+
+            current_frame = (current_frame + 1) % max_frames_in_flight;
+            return true;
+        }
+
         VkPresentInfoKHR present_info = {};
         present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
-        VkSemaphore signal_semaphores[] = { finished_semaphores[current_frame] };
+        VkSemaphore signal_semaphores[] = { finished_semaphores[image_index] };
         present_info.waitSemaphoreCount = 1;
         present_info.pWaitSemaphores = signal_semaphores;
 
@@ -300,7 +548,11 @@ namespace core::renderer
 
         present_info.pImageIndices = &image_index;
 
-        VkResult result = dispatch_table.queuePresentKHR(device_manager->get_present_queue(), &present_info);
+        VkResult result;
+        {
+            GSV_CPU_ZONE("Present");
+            result = dispatch_table.queuePresentKHR(device_manager->get_present_queue(), &present_info);
+        }
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
         {
             recreate_render_resources();
@@ -318,36 +570,170 @@ namespace core::renderer
         return true;
     }
 
+    void RenderPass::skip_acquired_frame(const VkSemaphoreSubmitInfo& acquire_wait)
+    {
+        //An empty batch still waits on the acquire semaphore, which must not stay signaled for the next acquire,
+        //and a new swapchain gives back the unpresented image
+        frame_scheduler->submit(QueueLane::Graphics, device_manager->get_graphics_queue(), {}, { acquire_wait }, {}, "skipped frame");
+        recreate_render_resources();
+    }
+
     bool RenderPass::create_sync_objects()
    {
        available_semaphores.assign(max_frames_in_flight, VK_NULL_HANDLE);
-       finished_semaphores.assign(max_frames_in_flight, VK_NULL_HANDLE);
-       in_flight_fences.assign(max_frames_in_flight, VK_NULL_HANDLE);
-       image_in_flight.assign(swapchain_manager->get_image_count(), VK_NULL_HANDLE);
 
        VkSemaphoreCreateInfo semaphore_info = {};
        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-       VkFenceCreateInfo fence_info = {};
-       fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-       fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
        auto dispatch_table = engine_context.dispatch_table;
 
        for (size_t i = 0; i < max_frames_in_flight; i++)
        {
-           if (dispatch_table.createSemaphore(&semaphore_info, nullptr, &available_semaphores[i]) != VK_SUCCESS ||
-               dispatch_table.createSemaphore(&semaphore_info, nullptr, &finished_semaphores[i]) != VK_SUCCESS ||
-               dispatch_table.createFence(&fence_info, nullptr, &in_flight_fences[i]) != VK_SUCCESS)
+           if (dispatch_table.createSemaphore(&semaphore_info, nullptr, &available_semaphores[i]) != VK_SUCCESS)
            {
                std::cout << "failed to create sync objects\n";
                return false;
            }
        }
 
-       return true;
+       if (!create_finished_semaphores())
+       {
+           return false;
+       }
+
+       gpu_profiler = std::make_unique<GpuProfiler>(engine_context);
+       gpu_profiler->init(max_frames_in_flight, gpu_profiler_max_scopes, gpu_profiler_history_length);
+
+       pipeline_statistics = std::make_unique<PipelineStatistics>(engine_context);
+       pipeline_statistics->init(max_frames_in_flight);
+
+       frame_scheduler = std::make_unique<FrameScheduler>(engine_context, max_frames_in_flight);
+       if (!frame_scheduler->init())
+       {
+           return false;
+       }
+
+       upload_manager = std::make_unique<UploadManager>(engine_context, *frame_scheduler);
+       return upload_manager->init(upload_staging_size, upload_chunk_size);
    }
 
+    bool RenderPass::create_finished_semaphores()
+    {
+        //Offscreen frames never present
+        if (swapchain_manager->is_offscreen())
+        {
+            return true;
+        }
+
+        finished_semaphores.assign(swapchain_manager->get_images().size(), VK_NULL_HANDLE);
+
+        VkSemaphoreCreateInfo semaphore_info = {};
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        for (VkSemaphore& semaphore : finished_semaphores)
+        {
+            if (engine_context.dispatch_table.createSemaphore(&semaphore_info, nullptr, &semaphore) != VK_SUCCESS)
+            {
+                std::cout << "failed to create sync objects\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void RenderPass::destroy_finished_semaphores()
+    {
+        for (VkSemaphore semaphore : finished_semaphores)
+        {
+            if (semaphore != VK_NULL_HANDLE)
+            {
+                engine_context.dispatch_table.destroySemaphore(semaphore, nullptr);
+            }
+        }
+
+        finished_semaphores.clear();
+    }
+
+    void RenderPass::create_readback_buffers()
+    {
+        //The offscreen color format is 4 bytes per pixel
+        VkExtent2D extent = swapchain_manager->get_extent();
+        VkDeviceSize readback_size = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+
+        readback_buffers.assign(max_frames_in_flight, GPU_Buffer{});
+        readback_frame_numbers.assign(max_frames_in_flight, 0);
+        readback_tags.assign(max_frames_in_flight, -1);
+        readback_pending.assign(max_frames_in_flight, false);
+
+        for (auto& readback_buffer : readback_buffers)
+        {
+            utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), readback_size,
+                                              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              VMA_MEMORY_USAGE_AUTO,
+                                              VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                              MemoryCategory::Staging, readback_buffer);
+        }
+    }
+
+    void RenderPass::record_readback(VkCommandBuffer command_buffer, uint32_t image_index)
+    {
+        Vk_Image color_image{};
+        color_image.image = swapchain_manager->get_images()[image_index].image;
+
+        GPU_Buffer& readback_buffer = readback_buffers[current_frame];
+        utils::ImageUtils::copy_image_to_buffer(engine_context, color_image, readback_buffer, command_buffer, {0, 0, 0});
+
+        //Makes the copy visible to the host once the frame's timeline value was waited on
+        utils::MemoryUtils::buffer_memory_barrier(engine_context.dispatch_table, command_buffer, readback_buffer.buffer,
+                                                  VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_HOST_BIT,
+                                                  VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_HOST_READ_BIT);
+    }
+
+    void RenderPass::deliver_readback(uint32_t frame)
+    {
+        if (frame >= readback_pending.size() || !readback_pending[frame])
+        {
+            return;
+        }
+
+        readback_pending[frame] = false;
+
+        if (!readback_callback)
+        {
+            return;
+        }
+
+        GPU_Buffer& readback_buffer = readback_buffers[frame];
+        vmaInvalidateAllocation(device_manager->get_allocator(), readback_buffer.allocation, 0, VK_WHOLE_SIZE);
+
+        FrameReadback readback{};
+        readback.frame_number = readback_frame_numbers[frame];
+        readback.tag = readback_tags[frame];
+        readback.extent = swapchain_manager->get_extent();
+        readback.format = swapchain_manager->get_image_format();
+        readback.pixels = static_cast<const uint8_t*>(readback_buffer.allocation_info.pMappedData);
+        readback.size = static_cast<VkDeviceSize>(readback.extent.width) * readback.extent.height * 4;
+
+        readback_callback(readback);
+    }
+
+    void RenderPass::flush_readbacks()
+    {
+        //current_frame is the slot that is reused next, so it holds the oldest frame
+        for (uint32_t i = 0; i < max_frames_in_flight; ++i)
+        {
+            auto frame = static_cast<uint32_t>((current_frame + i) % max_frames_in_flight);
+            if (frame >= readback_pending.size() || !readback_pending[frame])
+            {
+                continue;
+            }
+
+            frame_scheduler->wait_for_frame_slot(frame);
+            deliver_readback(frame);
+        }
+    }
+
     void RenderPass::set_new_camera_aspect_ratio() const
     {
         engine_context.renderer->get_camera()->set_aspect_ratio(static_cast<float>(
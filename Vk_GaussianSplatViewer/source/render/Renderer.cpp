@@ -1,5 +1,7 @@
 ﻿#include "renderer/Renderer.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <ostream>
 
@@ -13,12 +15,32 @@ namespace core::renderer
     {
         std::cout << "Renderer Setup" << std::endl;
 
+        auto init_start = std::chrono::high_resolution_clock::now();
+
         init_vulkan();
         
         create_camera_and_buffer();
-        render_pass = std::make_unique<RenderPass>(engine_context, 2);
+        render_pass = std::make_unique<RenderPass>(engine_context, max_frames_in_flight);
         render_pass->renderpass_init();
 
+        register_ui_actions();
+
+        std::cout << "Renderer initialized in "
+                  << std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - init_start).count() << " ms";
+
+        //Compare with use_shader_binary_cache off to see what the cache saves
+        if (auto shader_binary_cache = engine_context.shader_binary_cache.get())
+        {
+            std::cout << ", shader objects " << shader_binary_cache->get_creation_ms() << " ms (" << shader_binary_cache->get_hit_count() << " cached, "
+                      << shader_binary_cache->get_miss_count() << " compiled, cache " << (shader_binary_cache->is_enabled() ? "on" : "off") << ")";
+        }
+        else if (auto pipeline_cache = engine_context.pipeline_cache.get())
+        {
+            std::cout << ", pipelines (" << pipeline_cache->get_loaded_size() / 1024 << " KB pipeline cache loaded)";
+        }
+
+        std::cout << std::endl;
+
         std::cout << "Done initializing the renderer";
     }
 
@@ -26,4 +48,62 @@ namespace core::renderer
     {
         render_pass->record_commands_and_draw();
     }
+
+    void Renderer::register_ui_actions()
+    {
+        engine_context.ui_action_manager->register_int_action(UIAction::SET_RENDER_MODE, [this](int mode)
+        {
+            render_settings.render_mode = static_cast<RenderMode>(mode);
+        });
+
+        engine_context.ui_action_manager->register_bool_action(UIAction::TOGGLE_MESH_SHADERS, [this](bool enabled)
+        {
+            render_settings.use_mesh_shaders = enabled;
+        });
+
+        engine_context.ui_action_manager->register_int_action(UIAction::SET_SH_DEGREE, [this](int degree)
+        {
+            render_settings.sh_degree = static_cast<uint32_t>(std::clamp(degree, 0, static_cast<int>(max_sh_degree)));
+        });
+
+        engine_context.ui_action_manager->register_bool_action(UIAction::TOGGLE_COLOR_CACHE, [this](bool enabled)
+        {
+            render_settings.cache_view_colors = enabled;
+        });
+
+        engine_context.ui_action_manager->register_float_action(UIAction::SET_COLOR_CACHE_THRESHOLD, [this](float threshold)
+        {
+            render_settings.color_cache_threshold = std::max(threshold, 0.0f);
+        });
+
+        engine_context.ui_action_manager->register_bool_action(UIAction::TOGGLE_ASYNC_COMPUTE, [this](bool enabled)
+        {
+            render_settings.use_async_compute = enabled;
+        });
+
+        engine_context.ui_action_manager->register_bool_action(UIAction::TOGGLE_FRUSTUM_CULLING, [this](bool enabled)
+        {
+            render_settings.frustum_culling = enabled;
+        });
+
+        engine_context.ui_action_manager->register_int_action(UIAction::SET_DEBUG_VIEW, [this](int view)
+        {
+            render_settings.debug_view = static_cast<DebugView>(std::clamp(view, 0, static_cast<int>(DebugView::Overdraw)));
+        });
+
+        engine_context.ui_action_manager->register_int_action(UIAction::SET_OVERDRAW_SCALE, [this](int scale)
+        {
+            render_settings.overdraw_scale = static_cast<uint32_t>(std::max(scale, 1));
+        });
+
+        engine_context.ui_action_manager->register_bool_action(UIAction::TOGGLE_SPLAT_CACHE, [this](bool enabled)
+        {
+            render_settings.write_splat_cache = enabled;
+        });
+
+        engine_context.ui_action_manager->register_action(UIAction::EXPORT_GPU_PROFILE, [this]()
+        {
+            render_pass->get_gpu_profiler()->export_csv(gpu_profile_file);
+        });
+    }
 }
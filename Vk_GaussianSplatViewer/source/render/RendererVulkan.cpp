@@ -20,13 +20,40 @@ namespace core::renderer
     void Renderer::init_vulkan()
     {
         create_device();
-        create_swapchain();
+        //Offscreen images are allocated through VMA, so the allocator comes before the swapchain
         utils::MemoryUtils::create_vma_allocator(*engine_context.device_manager);
+        create_swapchain();
+        create_shader_caches();
+    }
+
+    void Renderer::create_shader_caches() const
+    {
+        if (engine_context.device_manager->is_shader_object_supported())
+        {
+            engine_context.shader_binary_cache = std::make_unique<material::ShaderBinaryCache>(engine_context, shader_cache_directory,
+                                                                                               use_shader_binary_cache);
+            return;
+        }
+
+        engine_context.pipeline_cache = std::make_unique<material::PipelineCache>(engine_context, pipeline_cache_file);
+        engine_context.pipeline_cache->init();
     }
 
     void Renderer::create_swapchain() const
     {
         engine_context.swapchain_manager = std::make_unique<vulkanapp::SwapchainManager>(engine_context);
+
+        //One image per frame in flight. sRGB like the swapchain, so read back pixels look the same as on screen
+        if (headless)
+        {
+            engine_context.swapchain_manager->initialize_offscreen(engine_context.device_manager->get_device(),
+                                                                    engine_context.device_manager->get_allocator(),
+                                                                    max_frames_in_flight,
+                                                                    offscreen_extent,
+                                                                    VK_FORMAT_R8G8B8A8_SRGB);
+            return;
+        }
+
         engine_context.swapchain_manager->initialize(engine_context.device_manager->get_physical_device(),
                                                       engine_context.device_manager->get_device(),
                                                       //Windowing
@@ -39,7 +66,7 @@ namespace core::renderer
     void Renderer::create_device() const
     {
         engine_context.device_manager = std::make_unique<vulkanapp::DeviceManager>(engine_context);
-        engine_context.device_manager->device_init();
+        engine_context.device_manager->device_init(headless);
         engine_context.device_manager->init_queues();
     }
 
@@ -54,6 +81,12 @@ namespace core::renderer
         // 4. Swapchain
         vulkanapp::VulkanCleanupQueue::push_cleanup_function(CLEANUP_FUNCTION(engine_context.swapchain_manager->cleanup()));
 
+        // 3. Pipeline cache is written to disk after the render pass released its materials
+        if (engine_context.pipeline_cache)
+        {
+            vulkanapp::VulkanCleanupQueue::push_cleanup_function(CLEANUP_FUNCTION(engine_context.pipeline_cache->cleanup()));
+        }
+
         // 2. Render pass cleanup (includes destroying sync objects, command pool, depth image)
         vulkanapp::VulkanCleanupQueue::push_cleanup_function(CLEANUP_FUNCTION(render_pass->cleanup()));
 
@@ -69,7 +102,7 @@ namespace core::renderer
         first_person_camera = std::make_unique<camera::FirstPersonCamera>(glm::vec3(0.0f, 0.0f, 3.0f), 45.0f,
                                                                           static_cast<float>(swapchain_manager->get_extent().width ) / static_cast<float>(swapchain_manager->get_extent().height));
 
-        engine_context.buffer_container->allocate_camera_buffer(*first_person_camera);
+        engine_context.buffer_container->allocate_camera_buffer(*first_person_camera, max_frames_in_flight);
     }
 
     void Renderer::cleanup()
@@ -1,7 +1,9 @@
 #include "renderer/Subpass.h"
 
+#include "renderer/RenderPass.h"
 #include "structs/EngineContext.h"
 #include "vulkanapp/utils/ImageUtils.h"
+#include "vulkanapp/utils/MemoryUtils.h"
 #include "vulkanapp/utils/RenderUtils.h"
 
 namespace core::renderer
@@ -52,7 +54,7 @@ namespace core::renderer
 
             utils::ImageUtils::image_layout_transition(active_command_buffer,
                                             image.image,
-                                            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                                            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, //Chains with the acquire semaphore wait
                                             VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
                                             0,
                                             VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
@@ -157,6 +159,93 @@ namespace core::renderer
         material_to_use = material;
     }
 
+    void Subpass::record_compute_commands(VkCommandBuffer* command_buffer)
+    {
+
+    }
+
+    void Subpass::blit_to_swapchain(VkCommandBuffer command_buffer, VkImage image, VkExtent2D extent, uint32_t image_index) const
+    {
+        VkImage swapchain_image = swapchain_manager->get_images()[image_index].image;
+        VkImageSubresourceRange color_range{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+        utils::ImageUtils::image_layout_transition(command_buffer, image,
+                                                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_BLIT_BIT,
+                                                   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+                                                   VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                   color_range);
+
+        //The geometry pass already cleared the swapchain image
+        utils::ImageUtils::image_layout_transition(command_buffer, swapchain_image,
+                                                   VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_2_BLIT_BIT,
+                                                   VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                   color_range);
+
+        VkImageBlit2 blit_region{};
+        blit_region.sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2;
+        blit_region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        blit_region.srcOffsets[1] = { static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1 };
+        blit_region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        blit_region.dstOffsets[1] = blit_region.srcOffsets[1];
+
+        VkBlitImageInfo2 blit_info{};
+        blit_info.sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2;
+        blit_info.srcImage = image;
+        blit_info.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        blit_info.dstImage = swapchain_image;
+        blit_info.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        blit_info.regionCount = 1;
+        blit_info.pRegions = &blit_region;
+        blit_info.filter = VK_FILTER_NEAREST;
+
+        engine_context.dispatch_table.cmdBlitImage2(command_buffer, &blit_info);
+
+        //Back to attachment layout so the ImGui pass can draw on top
+        utils::ImageUtils::image_layout_transition(command_buffer, swapchain_image,
+                                                   VK_PIPELINE_STAGE_2_BLIT_BIT, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                   VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                                   color_range);
+    }
+
+    void Subpass::begin_gpu_scope(VkCommandBuffer command_buffer, const char* name) const
+    {
+        engine_context.renderer->get_render_pass()->get_gpu_profiler()->begin_scope(command_buffer, name);
+    }
+
+    void Subpass::end_gpu_scope(VkCommandBuffer command_buffer) const
+    {
+        engine_context.renderer->get_render_pass()->get_gpu_profiler()->end_scope(command_buffer);
+    }
+
+    void Subpass::release_to_graphics(VkCommandBuffer command_buffer, VkBuffer buffer, VkAccessFlags2 src_access_mask) const
+    {
+        if (!async_compute)
+        {
+            return;
+        }
+
+        utils::MemoryUtils::queue_release_barrier(engine_context.dispatch_table, command_buffer, buffer,
+                                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, src_access_mask,
+                                                  device_manager->get_compute_queue_family(), device_manager->get_graphics_queue_family());
+    }
+
+    void Subpass::acquire_from_compute(VkCommandBuffer command_buffer, VkBuffer buffer, VkPipelineStageFlags2 dst_stage_mask, VkAccessFlags2 dst_access_mask) const
+    {
+        if (!async_compute)
+        {
+            utils::MemoryUtils::buffer_memory_barrier(engine_context.dispatch_table, command_buffer, buffer,
+                                                      VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, dst_stage_mask,
+                                                      VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, dst_access_mask);
+            return;
+        }
+
+        utils::MemoryUtils::queue_acquire_barrier(engine_context.dispatch_table, command_buffer, buffer,
+                                                  dst_stage_mask, dst_access_mask,
+                                                  device_manager->get_compute_queue_family(), device_manager->get_graphics_queue_family());
+    }
+
     void Subpass::cleanup()
     {
         if (material_to_use)
@@ -0,0 +1,77 @@
+#include "renderer/UniformRing.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "structs/EngineContext.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+#include "vulkanapp/utils/Vk_Utils.h"
+
+namespace core::renderer
+{
+    UniformRing::UniformRing(EngineContext& engine_context) : engine_context(engine_context)
+    {
+    }
+
+    bool UniformRing::init(uint32_t frame_count, VkDeviceSize p_slot_size)
+    {
+        //Keep every allocation aligned for uniform and storage access alike
+        const VkPhysicalDeviceLimits limits = engine_context.device_manager->get_physical_device().properties.limits;
+        alignment = std::max<VkDeviceSize>({ alignment, limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment });
+
+        slot_size = (p_slot_size + alignment - 1) / alignment * alignment;
+
+        //Host visible is required here, so no transfer fallback unlike allocate_buffer_with_mapped_access
+        utils::MemoryUtils::create_buffer(engine_context.dispatch_table, engine_context.device_manager->get_allocator(),
+                                          slot_size * frame_count,
+                                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                          VMA_MEMORY_USAGE_AUTO,
+                                          VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                          MemoryCategory::Uniforms, ring_buffer, engine_context.device_manager->get_shared_queue_families());
+
+        if (ring_buffer.allocation_info.pMappedData == nullptr)
+        {
+            std::cerr << "Uniform ring buffer could not be mapped" << std::endl;
+            return false;
+        }
+
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) ring_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Frame Uniform Ring");
+
+        return true;
+    }
+
+    void UniformRing::cleanup()
+    {
+        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), ring_buffer);
+    }
+
+    void UniformRing::begin_frame(uint32_t frame)
+    {
+        current_slot = frame;
+        slot_offset = 0;
+    }
+
+    UniformAllocation UniformRing::allocate(VkDeviceSize size)
+    {
+        VkDeviceSize aligned_size = (size + alignment - 1) / alignment * alignment;
+        if (slot_offset + aligned_size > slot_size)
+        {
+            std::cerr << "Uniform ring slot overflow (" << slot_offset + aligned_size << " > " << slot_size << " bytes)" << std::endl;
+            return {};
+        }
+
+        UniformAllocation allocation{};
+        allocation.offset = current_slot * slot_size + slot_offset;
+        allocation.mapped_data = static_cast<char*>(ring_buffer.allocation_info.pMappedData) + allocation.offset;
+        allocation.address = ring_buffer.buffer_address + allocation.offset;
+
+        slot_offset += aligned_size;
+
+        return allocation;
+    }
+
+    void UniformRing::flush(const UniformAllocation& allocation, VkDeviceSize size) const
+    {
+        vmaFlushAllocation(engine_context.device_manager->get_allocator(), ring_buffer.allocation, allocation.offset, size);
+    }
+}
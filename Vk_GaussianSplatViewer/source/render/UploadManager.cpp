@@ -0,0 +1,254 @@
+#include "renderer/UploadManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "structs/EngineContext.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+#include "vulkanapp/utils/RenderUtils.h"
+#include "vulkanapp/utils/Vk_Utils.h"
+
+namespace core::renderer
+{
+    UploadManager::UploadManager(EngineContext& engine_context, FrameScheduler& frame_scheduler) :
+        engine_context(engine_context), frame_scheduler(frame_scheduler)
+    {
+    }
+
+    bool UploadManager::init(VkDeviceSize p_staging_size, VkDeviceSize p_chunk_size)
+    {
+        auto device_manager = engine_context.device_manager.get();
+
+        staging_size = p_staging_size;
+        chunk_size = std::min(p_chunk_size, p_staging_size);
+
+        utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), staging_size,
+                                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                          VMA_MEMORY_USAGE_AUTO,
+                                          VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                                          MemoryCategory::Staging, staging_buffer);
+
+        if (staging_buffer.allocation_info.pMappedData == nullptr)
+        {
+            std::cerr << "Upload staging ring could not be mapped" << std::endl;
+            return false;
+        }
+
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) staging_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Upload Staging Ring");
+
+        //Command buffers are reused individually once their chunk finished
+        return utils::RenderUtils::create_command_pool(engine_context, command_pool,
+                                                       VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                                                       device_manager->get_transfer_queue_family());
+    }
+
+    void UploadManager::cleanup()
+    {
+        frame_scheduler.wait_for(last_upload);
+        in_flight_chunks.clear();
+
+        for (PendingRelease& pending_release : pending_releases)
+        {
+            pending_release.release();
+        }
+        pending_releases.clear();
+        free_command_buffers.clear();
+
+        if (command_pool != VK_NULL_HANDLE)
+        {
+            engine_context.dispatch_table.destroyCommandPool(command_pool, nullptr);
+            command_pool = VK_NULL_HANDLE;
+        }
+
+        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), staging_buffer);
+    }
+
+    TimelinePoint UploadManager::upload(const void* data, VkDeviceSize size, VkBuffer dst_buffer, VkDeviceSize dst_offset)
+    {
+        const auto* source = static_cast<const char*>(data);
+
+        return upload(size, [source](void* destination, VkDeviceSize offset, VkDeviceSize copy_size)
+        {
+            memcpy(destination, source + offset, copy_size);
+        }, dst_buffer, dst_offset);
+    }
+
+    TimelinePoint UploadManager::upload(VkDeviceSize size, const ChunkWriter& writer, VkBuffer dst_buffer, VkDeviceSize dst_offset,
+                                        VkDeviceSize granularity)
+    {
+        auto upload_start = std::chrono::high_resolution_clock::now();
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        retire_completed();
+
+        const VkDeviceSize granular_chunk_size = std::max(granularity, chunk_size - chunk_size % granularity);
+        VkDeviceSize copied = 0;
+
+        while (copied < size)
+        {
+            const VkDeviceSize copy_size = std::min(granular_chunk_size, size - copied);
+            const VkDeviceSize staging_offset = acquire_staging(copy_size);
+
+            writer(static_cast<char*>(staging_buffer.allocation_info.pMappedData) + staging_offset, copied, copy_size);
+            vmaFlushAllocation(engine_context.device_manager->get_allocator(), staging_buffer.allocation, staging_offset, copy_size);
+
+            VkCommandBuffer command_buffer = acquire_command_buffer();
+
+            VkCommandBufferBeginInfo begin_info{};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            dispatch_table.beginCommandBuffer(command_buffer, &begin_info);
+
+            VkBufferCopy copy_region{};
+            copy_region.srcOffset = staging_offset;
+            copy_region.dstOffset = dst_offset + copied;
+            copy_region.size = copy_size;
+            dispatch_table.cmdCopyBuffer(command_buffer, staging_buffer.buffer, dst_buffer, 1, &copy_region);
+
+            dispatch_table.endCommandBuffer(command_buffer);
+
+            if (!submit_copy(command_buffer, staging_offset, copy_size))
+            {
+                return last_upload;
+            }
+
+            copied += copy_size;
+        }
+
+        uploaded_bytes += size;
+
+        float upload_seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - upload_start).count();
+        if (upload_seconds > 0.0f)
+        {
+            last_upload_mb_per_s = static_cast<float>(size) / (1024.0f * 1024.0f) / upload_seconds;
+        }
+
+        return last_upload;
+    }
+
+    TimelinePoint UploadManager::copy(VkBuffer src_buffer, VkDeviceSize src_offset, VkBuffer dst_buffer, VkDeviceSize dst_offset, VkDeviceSize size)
+    {
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        retire_completed();
+
+        VkCommandBuffer command_buffer = acquire_command_buffer();
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        dispatch_table.beginCommandBuffer(command_buffer, &begin_info);
+
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = src_offset;
+        copy_region.dstOffset = dst_offset;
+        copy_region.size = size;
+        dispatch_table.cmdCopyBuffer(command_buffer, src_buffer, dst_buffer, 1, &copy_region);
+
+        dispatch_table.endCommandBuffer(command_buffer);
+
+        //Uses no ring space, so it never blocks a staging region
+        if (!submit_copy(command_buffer, 0, 0))
+        {
+            return { QueueLane::Transfer, 0 };
+        }
+
+        uploaded_bytes += size;
+
+        return last_upload;
+    }
+
+    void UploadManager::release_after(TimelinePoint point, std::function<void()> release)
+    {
+        pending_releases.push_back({ point, std::move(release) });
+    }
+
+    void UploadManager::retire_completed()
+    {
+        if (in_flight_chunks.empty() && pending_releases.empty())
+        {
+            return;
+        }
+
+        uint64_t completed_value = frame_scheduler.get_completed_value(QueueLane::Transfer);
+
+        //Chunks are submitted in ring order, so the finished ones are at the front
+        while (!in_flight_chunks.empty() && in_flight_chunks.front().point.value <= completed_value)
+        {
+            free_command_buffers.push_back(in_flight_chunks.front().command_buffer);
+            in_flight_chunks.pop_front();
+        }
+
+        while (!pending_releases.empty() && pending_releases.front().point.value <= completed_value)
+        {
+            pending_releases.front().release();
+            pending_releases.pop_front();
+        }
+    }
+
+    bool UploadManager::submit_copy(VkCommandBuffer command_buffer, VkDeviceSize staging_offset, VkDeviceSize staging_used)
+    {
+        TimelinePoint previous = frame_scheduler.get_last_submitted(QueueLane::Transfer);
+        TimelinePoint point = frame_scheduler.submit(QueueLane::Transfer, engine_context.device_manager->get_transfer_queue(),
+                                                     { command_buffer }, {}, {}, "upload");
+        if (point.value == previous.value)
+        {
+            free_command_buffers.push_back(command_buffer);
+            return false;
+        }
+
+        in_flight_chunks.push_back({ staging_offset, staging_used, point, command_buffer });
+        last_upload = point;
+
+        return true;
+    }
+
+    VkDeviceSize UploadManager::acquire_staging(VkDeviceSize size)
+    {
+        if (ring_head + size > staging_size)
+        {
+            ring_head = 0;
+        }
+
+        const VkDeviceSize offset = ring_head;
+
+        //Wait for the newest chunk that still reads from this region; older ones on the lane finish before it
+        TimelinePoint blocking_point{ QueueLane::Transfer, 0 };
+        for (const InFlightChunk& chunk : in_flight_chunks)
+        {
+            if (chunk.staging_offset < offset + size && offset < chunk.staging_offset + chunk.size)
+            {
+                blocking_point.value = std::max(blocking_point.value, chunk.point.value);
+            }
+        }
+
+        if (blocking_point.value != 0)
+        {
+            frame_scheduler.wait_for(blocking_point);
+            retire_completed();
+        }
+
+        //Keep chunks aligned for the copy offsets
+        ring_head = (offset + size + 15) & ~static_cast<VkDeviceSize>(15);
+
+        return offset;
+    }
+
+    VkCommandBuffer UploadManager::acquire_command_buffer()
+    {
+        if (!free_command_buffers.empty())
+        {
+            VkCommandBuffer command_buffer = free_command_buffers.back();
+            free_command_buffers.pop_back();
+
+            return command_buffer;
+        }
+
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        utils::RenderUtils::allocate_command_buffer(engine_context, command_pool, command_buffer);
+
+        return command_buffer;
+    }
+}
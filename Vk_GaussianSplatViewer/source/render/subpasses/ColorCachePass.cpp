@@ -0,0 +1,110 @@
+#include "renderer/subpasses/ColorCachePass.h"
+
+#include <algorithm>
+#include <string>
+#include <glm/geometric.hpp>
+
+#include "camera/FirstPersonCamera.h"
+#include "materials/MaterialUtils.h"
+#include "renderer/GPU_BufferContainer.h"
+#include "renderer/Renderer.h"
+#include "structs/EngineContext.h"
+#include "structs/scene/PushConstantBlock.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+
+namespace core::renderer
+{
+    namespace
+    {
+        const std::string color_cache_shader_path = std::string(shader_directory) + R"(gaussian_color\color_cache.comp.spv)";
+
+        //Only the SH degree is read by color_cache.comp.glsl, the other switches stay at their defaults
+        material::ShaderVariant get_sh_variant(uint32_t degree)
+        {
+            material::ShaderVariant variant{};
+            variant.sh_degree = degree;
+            return variant;
+        }
+    }
+
+    ColorCachePass::ColorCachePass(EngineContext& engine_context, uint32_t max_frames_in_flight) : Subpass(engine_context, max_frames_in_flight),
+        material_utils(engine_context)
+    {
+        set_material(material_utils.get_compute_variant("color_cache", color_cache_shader_path, sizeof(ColorCachePushConstantBlock),
+                                                        get_sh_variant(max_sh_degree)));
+
+        buffer_container = engine_context.buffer_container.get();
+    }
+
+    void ColorCachePass::frame_pre_recording()
+    {
+        const RenderSettings& settings = engine_context.renderer->get_render_settings();
+        uint32_t degree = std::min(settings.sh_degree, max_sh_degree);
+        glm::vec3 camera_position = engine_context.renderer->get_camera()->get_position();
+
+        //Only the camera position feeds the per-splat view vectors, so rotating in place keeps the cache valid
+        update_this_frame = !settings.cache_view_colors ||
+                            !cache_valid ||
+                            degree != cached_sh_degree ||
+                            buffer_container->scene_version != cached_scene_version ||
+                            glm::distance(camera_position, cached_camera_position) > settings.color_cache_threshold;
+
+        if (update_this_frame)
+        {
+            set_material(material_utils.get_compute_variant("color_cache", color_cache_shader_path, sizeof(ColorCachePushConstantBlock),
+                                                            get_sh_variant(degree)));
+
+            cache_valid = buffer_container->gaussian_count > 0;
+            cached_camera_position = camera_position;
+            cached_sh_degree = degree;
+            cached_scene_version = buffer_container->scene_version;
+        }
+    }
+
+    void ColorCachePass::record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last)
+    {
+
+    }
+
+    void ColorCachePass::record_compute_commands(VkCommandBuffer* command_buffer)
+    {
+        if (!update_this_frame || buffer_container->gaussian_count == 0)
+        {
+            return;
+        }
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VkBuffer color_cache = buffer_container->color_cache_buffer.buffer;
+
+        //The preprocess pass of an earlier frame may still be reading the cache
+        utils::MemoryUtils::buffer_memory_barrier(dispatch_table, *command_buffer, color_cache,
+                                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                  0, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+        material_to_use->bind(*command_buffer);
+
+        ColorCachePushConstantBlock push_constant_block{};
+        push_constant_block.camera_data_address = buffer_container->camera_data_address;
+        push_constant_block.gaussian_buffer_address = buffer_container->gaussian_buffer.get_buffer().buffer_address;
+        push_constant_block.color_cache_address = buffer_container->color_cache_buffer.buffer_address;
+        push_constant_block.gaussian_count = buffer_container->gaussian_count;
+
+        dispatch_table.cmdPushConstants(*command_buffer, material_to_use->get_pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                                        0, sizeof(ColorCachePushConstantBlock), &push_constant_block);
+
+        uint32_t group_count = (buffer_container->gaussian_count + splat_workgroup_size - 1) / splat_workgroup_size;
+        dispatch_table.cmdDispatch(*command_buffer, group_count, 1, 1);
+
+        //Cached colors are read by the preprocess pass
+        utils::MemoryUtils::buffer_memory_barrier(dispatch_table, *command_buffer, color_cache,
+                                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                  VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    }
+
+    void ColorCachePass::cleanup()
+    {
+        //material_to_use always points at one of the cached variants
+        material_utils.cleanup_variants();
+        material_to_use.reset();
+    }
+}
@@ -1,15 +1,25 @@
 ﻿#include "renderer/subpasses/GeometryPass.h"
 
+#include <algorithm>
+#include <iostream>
+
+#include "3d/GaussianSplatPlyLoader.h"
+#include "3d/SplatCacheFile.h"
 #include "3d/ModelUtils.h"
+#include "config/Config.inl"
+#include "core/CpuProfiler.h"
 #include "materials/MaterialUtils.h"
 #include "structs/EngineContext.h"
 #include "structs//geometry/Vertex.h"
+#include "structs/geometry/SplatRecord.h"
 #include "structs/scene/CameraData.h"
 #include "structs/scene/PushConstantBlock.h"
 #include "enums/inputs/UIAction.h"
 #include "vulkanapp/VulkanCleanupQueue.h"
 #include "vulkanapp/utils/MemoryUtils.h"
 #include "renderer/GPU_BufferContainer.h"
+#include "renderer/RenderPass.h"
+#include "renderer/Renderer.h"
 
 namespace core::renderer
 {
@@ -18,6 +28,14 @@ namespace core::renderer
         material::MaterialUtils material_utils(engine_context);
         set_material(material_utils.create_material("default"));
 
+        if (device_manager->is_mesh_shader_supported())
+        {
+            mesh_material = material_utils.create_mesh_material("default_mesh",
+                                                                std::string(shader_directory) + R"(gaussian_mesh\gaussian.task.spv)",
+                                                                std::string(shader_directory) + R"(gaussian_mesh\gaussian.mesh.spv)",
+                                                                sizeof(MeshPushConstantBlock));
+        }
+
         camera_data = {glm::mat4{}, glm::mat4{}};
         camera = engine_context.renderer->get_camera();
         extents = swapchain_manager->get_extent();
@@ -31,16 +49,86 @@ namespace core::renderer
         engine_context.ui_action_manager->register_string_action(UIAction::ALLOCATE_SPLAT_MEMORY,
              [this, &engine_context](const std::string& code)
              {
-                engine_context.dispatch_table.deviceWaitIdle();
+                {
+                    GSV_CPU_ZONE("Device wait idle");
+                    engine_context.dispatch_table.deviceWaitIdle();
+                }
 
                 //std::string str = R"(D:\Projects\CPP\Vk_GaussianSplat\data\point_cloud_truck_30k.ply)";
-                auto gaussian_surfaces = entity_3d::ModelUtils::load_gaussian_surfaces(code);
-                //entity_3d::ModelUtils::load_placeholder_gaussian_model();
-                buffer_container->allocate_gaussian_surface_buffer(gaussian_surfaces);
-                buffer_container->gaussian_count = gaussian_surfaces.size();
+                load_splat_file(code, false);
+             });
+
+        //Adds a file to the current scene. No idle wait: the new surfaces go past the ones frames in flight read,
+        //and the gaussian buffer waits by itself when it has to grow
+        engine_context.ui_action_manager->register_string_action(UIAction::APPEND_SPLAT_MEMORY,
+             [this](const std::string& code)
+             {
+                load_splat_file(code, true);
              });
     }
 
+    void GeometryPass::load_splat_file(const std::string& file_path, bool append)
+    {
+        GSV_CPU_ZONE("Load splat file");
+
+        const bool is_cache = splat_loader::SplatCacheFile::is_cache_file(file_path);
+        const std::string cache_path = is_cache ? file_path : splat_loader::SplatCacheFile::get_cache_path(file_path);
+
+        if (is_cache || splat_loader::SplatCacheFile::is_up_to_date(cache_path, file_path))
+        {
+            //Shared with the upload manager, which unmaps it once the import copy finished
+            auto cache_file = std::make_shared<splat_loader::SplatCacheFile>();
+            if (cache_file->open(cache_path))
+            {
+                if (append)
+                {
+                    buffer_container->append_gaussian_surfaces(cache_file);
+                }
+                else
+                {
+                    buffer_container->allocate_gaussian_surface_buffer(cache_file);
+                }
+                return;
+            }
+
+            if (is_cache)
+            {
+                return;
+            }
+        }
+
+        splat_loader::GaussianSplatPlyLoader ply;
+        if (!ply.open(file_path))
+        {
+            std::cerr << "Failed to load PLY\n";
+            return;
+        }
+
+        //Decoded straight into the gaussian buffer when it is host visible, otherwise into the staging ring chunks
+        auto decoder = [&ply](GaussianSurface* destination, size_t first, size_t count)
+        {
+            ply.decode(destination, first, count);
+        };
+
+        if (append)
+        {
+            buffer_container->append_gaussian_surfaces(ply.get_vertex_count(), decoder);
+        }
+        else
+        {
+            buffer_container->allocate_gaussian_surface_buffer(ply.get_vertex_count(), decoder);
+        }
+
+        if (engine_context.renderer->get_render_settings().write_splat_cache)
+        {
+            GSV_CPU_ZONE("Write splat cache");
+            splat_loader::SplatCacheFile::write(cache_path, ply.get_vertex_count(), [&ply](GaussianSurface* destination)
+            {
+                ply.decode(destination);
+            });
+        }
+    }
+
     void GeometryPass::frame_pre_recording()
     {
 
@@ -53,43 +141,139 @@ namespace core::renderer
         setup_color_attachment(image_index, { {0.0f, 0.0f, 0.0f, 1.0f} });
         setup_depth_attachment({ {1.0f, 0} });
 
+        if (buffer_container->overdraw_enabled)
+        {
+            clear_overdraw_counts(*command_buffer);
+        }
+
+        auto pipeline_statistics = engine_context.renderer->get_render_pass()->get_pipeline_statistics();
+        const bool hardware_raster = engine_context.renderer->get_render_settings().render_mode == RenderMode::HardwareRaster;
+        if (hardware_raster)
+        {
+            pipeline_statistics->reset(*command_buffer);
+        }
+
         begin_rendering();
 
+        //The tile compute rasterizer composites its own image later, only the clear is needed here
+        if (!hardware_raster)
+        {
+            end_rendering();
+            end_command_buffer_recording(image_index, is_last);
+            return;
+        }
+
         material::ShaderObject::set_initial_state(engine_context.dispatch_table, swapchain_manager->get_extent(), *command_buffer,
-                                                                            GaussianSurfaceDescriptor::get_binding_description(),
-                                                                            GaussianSurfaceDescriptor::get_attribute_descriptions(),
-                                                                            swapchain_manager->get_extent(), {0, 0});
+                                                                            SplatRecordDescriptor::get_binding_description(),
+                                                                            SplatRecordDescriptor::get_attribute_descriptions(),
+                                                                            swapchain_manager->get_extent(), {0, 0},
+                                                                            device_manager->is_shader_object_supported());
+
+        pipeline_statistics->begin(*command_buffer);
+
+        if (mesh_material && engine_context.renderer->get_render_settings().use_mesh_shaders)
+        {
+            record_mesh_path(*command_buffer);
+        }
+        else
+        {
+            record_vertex_path(*command_buffer);
+        }
+
+        pipeline_statistics->end(*command_buffer);
 
-        material_to_use->get_shader_object()->bind_material_shader(engine_context.dispatch_table, *command_buffer);
+        end_rendering();
+        end_command_buffer_recording(image_index, is_last);
+    }
 
-        camera_data.projection =  camera->get_projection_matrix();
-        camera_data.view = camera->get_view_matrix();
+    void GeometryPass::clear_overdraw_counts(VkCommandBuffer command_buffer) const
+    {
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        //The previous frame's heatmap resolve reads the same counters
+        utils::MemoryUtils::memory_barrier(dispatch_table, command_buffer,
+                                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_CLEAR_BIT,
+                                           0, VK_ACCESS_2_TRANSFER_WRITE_BIT);
 
-        memcpy(buffer_container->camera_data_buffer.allocation_info.pMappedData, &camera_data, sizeof(CameraData));
+        dispatch_table.cmdFillBuffer(command_buffer, buffer_container->overdraw_buffer.buffer, 0, VK_WHOLE_SIZE, 0);
 
-        //Vertices
-        VkBuffer vertex_buffers[] = {buffer_container->gaussian_buffer.buffer};
+        utils::MemoryUtils::memory_barrier(dispatch_table, command_buffer,
+                                           VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                           VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    }
+
+    void GeometryPass::record_vertex_path(VkCommandBuffer command_buffer) const
+    {
+        if (device_manager->is_mesh_shader_supported() && device_manager->is_shader_object_supported())
+        {
+            material::ShaderObject::unbind_mesh_stages(engine_context.dispatch_table, command_buffer);
+        }
+
+        material_to_use->bind(command_buffer);
+
+        //Vertices (screen space records produced by the preprocess pass)
+        VkBuffer vertex_buffers[] = {buffer_container->get_splat_record_buffer().buffer};
         VkDeviceSize offsets[] = {0};
-        engine_context.dispatch_table.cmdBindVertexBuffers(*command_buffer, 0, 1, vertex_buffers, offsets);
+        engine_context.dispatch_table.cmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
 
         //Push Constants
-        PushConstantBlock push_constant_block = {buffer_container->camera_data_buffer.buffer_address};
-        engine_context.dispatch_table.cmdPushConstants(*command_buffer, material_to_use->get_pipeline_layout(),  VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        PushConstantBlock push_constant_block = {buffer_container->camera_data_address};
+        engine_context.dispatch_table.cmdPushConstants(command_buffer, material_to_use->get_pipeline_layout(),  VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
             0, sizeof(PushConstantBlock), &push_constant_block);
 
-        engine_context.dispatch_table.cmdDraw(*command_buffer, buffer_container->gaussian_count, 1, 0, 0);
+        engine_context.dispatch_table.cmdDraw(command_buffer, buffer_container->gaussian_count, 1, 0, 0);
+    }
 
-        end_rendering();
-        end_command_buffer_recording(image_index, is_last);
+    void GeometryPass::record_mesh_path(VkCommandBuffer command_buffer) const
+    {
+        //Quads instead of points. Mesh pipelines have fill mode baked in and no input assembly state
+        if (device_manager->is_shader_object_supported())
+        {
+            engine_context.dispatch_table.cmdSetPrimitiveTopologyEXT(command_buffer, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+            engine_context.dispatch_table.cmdSetPolygonModeEXT(command_buffer, VK_POLYGON_MODE_FILL);
+        }
+
+        mesh_material->bind(command_buffer);
+
+        MeshPushConstantBlock push_constant_block{};
+        push_constant_block.camera_data_address = buffer_container->camera_data_address;
+        push_constant_block.splat_record_address = buffer_container->get_splat_record_buffer().buffer_address;
+        push_constant_block.gaussian_count = buffer_container->gaussian_count;
+
+        engine_context.dispatch_table.cmdPushConstants(command_buffer, mesh_material->get_pipeline_layout(),
+            VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, sizeof(MeshPushConstantBlock), &push_constant_block);
+
+        //One task workgroup per cluster; spread over y to stay under the guaranteed 65535 groups per dimension
+        const uint32_t cluster_count = (buffer_container->gaussian_count + mesh_cluster_size - 1) / mesh_cluster_size;
+        const uint32_t group_count_x = std::min(cluster_count, 65535u);
+        const uint32_t group_count_y = (cluster_count + group_count_x - 1) / std::max(group_count_x, 1u);
+
+        if (cluster_count > 0)
+        {
+            engine_context.dispatch_table.cmdDrawMeshTasksEXT(command_buffer, group_count_x, group_count_y, 1);
+        }
     }
 
     void GeometryPass::cleanup()
     {
         Subpass::cleanup();
 
+        if (mesh_material)
+        {
+            mesh_material->cleanup();
+        }
+
         utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer_container->mesh_vertices_buffer);
         utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer_container->mesh_indices_buffer);
-        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer_container->gaussian_buffer);
-        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer_container->camera_data_buffer);
+        buffer_container->gaussian_buffer.destroy();
+        buffer_container->destroy_splat_record_buffers();
+        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer_container->color_cache_buffer);
+        utils::MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), buffer_container->compute_scratch_buffer);
+
+        if (buffer_container->frame_uniforms)
+        {
+            buffer_container->frame_uniforms->cleanup();
+        }
     }
 }
@@ -1,8 +1,14 @@
 #include "renderer/subpasses/ImGuiPass.h"
+#include "config/Config.inl"
 #include "structs/EngineContext.h"
 #include "vulkanapp/DeviceManager.h"
 #include "vulkanapp/SwapchainManager.h"
+#include "vulkanapp/utils/MemoryTracker.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
 #include <iostream>
+#include <utility>
 
 
 namespace core::renderer
@@ -75,7 +81,13 @@ namespace core::renderer
         init_info.MinImageCount = max_frames_in_flight;
         init_info.ImageCount = swapchain_manager->get_image_count();
         init_info.UseDynamicRendering = true;
-        init_info.UseShaderObjects = true;
+        init_info.UseShaderObjects = device_manager->is_shader_object_supported();
+
+        //Pipeline backend: ImGui builds its own pipeline for the swapchain format
+        VkFormat color_format = swapchain_manager->get_image_format();
+        init_info.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        init_info.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+        init_info.PipelineRenderingCreateInfo.pColorAttachmentFormats = &color_format;
 
         ImGui_ImplVulkan_Init(&init_info);
     }
@@ -137,9 +149,228 @@ namespace core::renderer
             engine_context.ui_action_manager->queue_string_action(UIAction::ALLOCATE_SPLAT_MEMORY, text_buffer);
         }
 
+        //Adds the file to the current scene, only its surfaces are uploaded
+        if (ImGui::Button("Append File", ImVec2(-1, 0)))
+        {
+            engine_context.ui_action_manager->queue_string_action(UIAction::APPEND_SPLAT_MEMORY, text_buffer);
+        }
+
+        //Later loads of the same PLY map the cache instead of parsing it
+        bool write_splat_cache = engine_context.renderer->get_render_settings().write_splat_cache;
+        if (ImGui::Checkbox("Write Splat Cache", &write_splat_cache))
+        {
+            engine_context.ui_action_manager->queue_bool_action(UIAction::TOGGLE_SPLAT_CACHE, write_splat_cache);
+        }
+
+        ImGui::Separator();
+
+        auto render_pass = engine_context.renderer->get_render_pass();
+        ImGui::Text("Frame %.2f ms | Record %.2f ms | Slot wait %.2f ms", ImGui::GetIO().DeltaTime * 1000.0f,
+                    render_pass->get_record_ms(), render_pass->get_slot_wait_ms());
+
+        //GPU time between the first and last command of each queue's work. Both queues tick the same clock only
+        //with calibrated timestamps, so the two ranges are not placed on a common timeline here
+        if (render_pass->has_queue_timestamps())
+        {
+            ImGui::Text("GPU compute %.2f ms | graphics %.2f ms%s", render_pass->get_compute_queue_ms(), render_pass->get_graphics_queue_ms(),
+                        render_pass->is_async_compute_active() ? " (async)" : "");
+
+            auto gpu_profiler = render_pass->get_gpu_profiler();
+            if (ImGui::CollapsingHeader("GPU Passes"))
+            {
+                const uint32_t history_offset = gpu_profiler->get_history_offset();
+
+                for (const auto& scope : gpu_profiler->get_history())
+                {
+                    const int value_count = static_cast<int>(scope.values.size());
+                    const float last_ms = scope.values[(history_offset + value_count - 1) % value_count];
+
+                    char overlay[32];
+                    snprintf(overlay, sizeof(overlay), "%.3f ms", last_ms);
+
+                    ImGui::PushID(scope.name.c_str());
+                    ImGui::Indent(12.0f * static_cast<float>(scope.depth + 1));
+                    ImGui::TextUnformatted(scope.name.c_str());
+                    ImGui::PlotLines("##history", scope.values.data(), value_count, static_cast<int>(history_offset), overlay,
+                                     0.0f, FLT_MAX, ImVec2(-1, 32));
+                    ImGui::Unindent(12.0f * static_cast<float>(scope.depth + 1));
+                    ImGui::PopID();
+                }
+
+                if (ImGui::Button("Export", ImVec2(-1, 0)))
+                {
+                    engine_context.ui_action_manager->queue_action(UIAction::EXPORT_GPU_PROFILE);
+                }
+            }
+        }
+
+        //Rasterized splats only. Fragment invocations include the ones the splat shader discards, so per pixel they are the overdraw
+        auto pipeline_statistics = render_pass->get_pipeline_statistics();
+        if (pipeline_statistics->is_supported())
+        {
+            if (pipeline_statistics->has_results())
+            {
+                const VkExtent2D extent = swapchain_manager->get_extent();
+                const double pixel_count = std::max(1.0, static_cast<double>(extent.width) * extent.height);
+
+                ImGui::Text("Vertex invocations %llu | primitives %llu", static_cast<unsigned long long>(pipeline_statistics->get_vertex_invocations()),
+                            static_cast<unsigned long long>(pipeline_statistics->get_clipping_primitives()));
+                ImGui::Text("Fragment invocations %llu (%.1f per pixel)", static_cast<unsigned long long>(pipeline_statistics->get_fragment_invocations()),
+                            static_cast<double>(pipeline_statistics->get_fragment_invocations()) / pixel_count);
+            }
+            else
+            {
+                ImGui::TextUnformatted("Pipeline statistics: hardware raster only");
+            }
+        }
+
+        //Zones of the last frames on every thread, for chrome://tracing or ui.perfetto.dev
+        if (ImGui::Button("Export CPU Trace", ImVec2(-1, 0)))
+        {
+            engine_context.ui_action_manager->queue_action(UIAction::EXPORT_CPU_TRACE);
+        }
+
+        auto upload_manager = render_pass->get_upload_manager();
+        ImGui::Text("Staged %.1f MB | last staging upload %.0f MB/s", static_cast<float>(upload_manager->get_uploaded_bytes()) / (1024.0f * 1024.0f),
+                    upload_manager->get_last_upload_mb_per_s());
+
+        //Direct = decoded into host visible VRAM (resizable BAR / UMA), otherwise decoded to RAM and staged
+        const UploadReport& splat_upload = engine_context.buffer_container->last_gaussian_upload;
+        const char* splat_upload_path = splat_upload.path == UploadPath::HostImport ? "host import" :
+                                        splat_upload.path == UploadPath::Direct ? "direct" : "staged";
+        ImGui::Text("Splat upload (%s) %.1f MB in %.2f ms, %.0f MB/s", splat_upload_path,
+                    static_cast<float>(splat_upload.bytes) / (1024.0f * 1024.0f), splat_upload.milliseconds, splat_upload.megabytes_per_second);
+
+        //Heap usage covers the whole process, the categories only what went through VMA (not the ImGui backend)
+        if (ImGui::CollapsingHeader("Memory"))
+        {
+            for (const auto& heap : utils::MemoryTracker::get_heap_budgets(engine_context.device_manager->get_allocator()))
+            {
+                const float usage_mb = static_cast<float>(heap.usage) / (1024.0f * 1024.0f);
+                const float budget_mb = static_cast<float>(heap.budget) / (1024.0f * 1024.0f);
+
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%.0f / %.0f MB", usage_mb, budget_mb);
+
+                ImGui::Text("Heap %u (%s)", heap.heap_index, heap.device_local ? "VRAM" : "system");
+                ImGui::ProgressBar(budget_mb > 0.0f ? std::min(usage_mb / budget_mb, 1.0f) : 0.0f, ImVec2(-1, 0), overlay);
+            }
+
+            for (uint32_t i = 0; i < static_cast<uint32_t>(MemoryCategory::Count); ++i)
+            {
+                const auto category = static_cast<MemoryCategory>(i);
+                ImGui::Text("%-8s %8.1f MB in %u", utils::MemoryTracker::get_category_name(category),
+                            static_cast<float>(utils::MemoryTracker::get_category_bytes(category)) / (1024.0f * 1024.0f),
+                            utils::MemoryTracker::get_category_allocations(category));
+            }
+
+            //Allocated bytes against the blocks the pool holds, the difference is free space inside the blocks
+            const std::pair<const char*, VmaPool> pools[] = { { "Splat pool", engine_context.device_manager->get_splat_pool() },
+                                                              { "Scratch pool", engine_context.device_manager->get_scratch_pool() } };
+            for (const auto& [pool_name, pool] : pools)
+            {
+                if (pool != VK_NULL_HANDLE)
+                {
+                    VmaStatistics pool_statistics{};
+                    vmaGetPoolStatistics(engine_context.device_manager->get_allocator(), pool, &pool_statistics);
+
+                    ImGui::Text("%s %.1f / %.1f MB in %u blocks", pool_name, static_cast<float>(pool_statistics.allocationBytes) / (1024.0f * 1024.0f),
+                                static_cast<float>(pool_statistics.blockBytes) / (1024.0f * 1024.0f), pool_statistics.blockCount);
+                }
+            }
+
+            if (engine_context.buffer_container->gaussians_in_system_memory)
+            {
+                ImGui::TextUnformatted("Splats are in system memory, the scene exceeded the VRAM budget");
+            }
+        }
+
+        //Host observed submit -> timeline signal latency per submission kind
+        for (const auto& [label, latency] : render_pass->get_frame_scheduler()->get_latencies())
+        {
+            ImGui::Text("%s latency %.2f ms (avg %.2f ms)", label.c_str(), latency.last_ms, latency.average_ms);
+        }
+
+        ImGui::Separator();
+
+        const char* render_modes[] = { "Hardware Raster", "Tile Compute" };
+        int render_mode = static_cast<int>(engine_context.renderer->get_render_settings().render_mode);
+        if (ImGui::Combo("Render Mode", &render_mode, render_modes, IM_ARRAYSIZE(render_modes)))
+        {
+            engine_context.ui_action_manager->queue_int_action(UIAction::SET_RENDER_MODE, render_mode);
+        }
+
+        int sh_degree = static_cast<int>(engine_context.renderer->get_render_settings().sh_degree);
+        if (ImGui::SliderInt("SH Degree", &sh_degree, 0, static_cast<int>(max_sh_degree)))
+        {
+            engine_context.ui_action_manager->queue_int_action(UIAction::SET_SH_DEGREE, sh_degree);
+        }
+
+        bool cache_view_colors = engine_context.renderer->get_render_settings().cache_view_colors;
+        if (ImGui::Checkbox("Cache SH Colors", &cache_view_colors))
+        {
+            engine_context.ui_action_manager->queue_bool_action(UIAction::TOGGLE_COLOR_CACHE, cache_view_colors);
+        }
+
+        if (cache_view_colors)
+        {
+            float color_cache_threshold = engine_context.renderer->get_render_settings().color_cache_threshold;
+            if (ImGui::SliderFloat("Cache Threshold", &color_cache_threshold, 0.0f, 1.0f))
+            {
+                engine_context.ui_action_manager->queue_float_action(UIAction::SET_COLOR_CACHE_THRESHOLD, color_cache_threshold);
+            }
+        }
+
+        bool frustum_culling = engine_context.renderer->get_render_settings().frustum_culling;
+        if (ImGui::Checkbox("Frustum Culling", &frustum_culling))
+        {
+            engine_context.ui_action_manager->queue_bool_action(UIAction::TOGGLE_FRUSTUM_CULLING, frustum_culling);
+        }
+
+        const char* debug_views[] = { "None", "Depth", "Radius", "Opacity", "Overdraw" };
+        int debug_view = static_cast<int>(engine_context.renderer->get_render_settings().debug_view);
+        if (ImGui::Combo("Debug View", &debug_view, debug_views, IM_ARRAYSIZE(debug_views)))
+        {
+            engine_context.ui_action_manager->queue_int_action(UIAction::SET_DEBUG_VIEW, debug_view);
+        }
+
+        if (debug_view == static_cast<int>(DebugView::Overdraw))
+        {
+            int overdraw_scale = static_cast<int>(engine_context.renderer->get_render_settings().overdraw_scale);
+            if (ImGui::SliderInt("Overdraw Scale", &overdraw_scale, 1, 1024, "%d", ImGuiSliderFlags_Logarithmic))
+            {
+                engine_context.ui_action_manager->queue_int_action(UIAction::SET_OVERDRAW_SCALE, overdraw_scale);
+            }
+        }
+
+        if (device_manager->is_async_compute_supported())
+        {
+            bool use_async_compute = engine_context.renderer->get_render_settings().use_async_compute;
+            if (ImGui::Checkbox("Async Compute", &use_async_compute))
+            {
+                engine_context.ui_action_manager->queue_bool_action(UIAction::TOGGLE_ASYNC_COMPUTE, use_async_compute);
+            }
+        }
+
+        if (device_manager->is_mesh_shader_supported())
+        {
+            bool use_mesh_shaders = engine_context.renderer->get_render_settings().use_mesh_shaders;
+            if (ImGui::Checkbox("Mesh Shaders", &use_mesh_shaders))
+            {
+                engine_context.ui_action_manager->queue_bool_action(UIAction::TOGGLE_MESH_SHADERS, use_mesh_shaders);
+            }
+        }
+
         ImGui::End();
 
         ImGui::Render();
+
+        //ImGui only binds vertex/fragment shader objects
+        if (device_manager->is_mesh_shader_supported() && device_manager->is_shader_object_supported())
+        {
+            material::ShaderObject::unbind_mesh_stages(engine_context.dispatch_table, *command_buffer);
+        }
+
         ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), *command_buffer);
 
         end_rendering();
@@ -0,0 +1,163 @@
+#include "renderer/subpasses/OverdrawPass.h"
+
+#include "config/Config.inl"
+#include "materials/MaterialUtils.h"
+#include "renderer/GPU_BufferContainer.h"
+#include "structs/EngineContext.h"
+#include "vulkanapp/utils/DescriptorUtils.h"
+#include "vulkanapp/utils/ImageUtils.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+#include "vulkanapp/utils/RenderUtils.h"
+#include "vulkanapp/utils/Vk_Utils.h"
+
+namespace
+{
+    constexpr VkFormat output_format = VK_FORMAT_R8G8B8A8_UNORM;
+    constexpr uint32_t heatmap_workgroup_size = 16;
+}
+
+namespace core::renderer
+{
+    OverdrawPass::OverdrawPass(EngineContext& engine_context, uint32_t max_frames_in_flight) : Subpass(engine_context, max_frames_in_flight)
+    {
+        buffer_container = engine_context.buffer_container.get();
+
+        create_descriptors();
+
+        material::MaterialUtils material_utils(engine_context);
+        set_material(material_utils.create_compute_material("overdraw_heatmap",
+                                                            std::string(shader_directory) + R"(gaussian_overdraw\overdraw_heatmap.comp.spv)",
+                                                            sizeof(OverdrawPushConstantBlock), &descriptor_set_layout, 1));
+        material_to_use->add_descriptor_set(descriptor_set);
+    }
+
+    void OverdrawPass::frame_pre_recording()
+    {
+        buffer_container->overdraw_enabled = engine_context.renderer->get_render_settings().debug_view == DebugView::Overdraw;
+        if (!buffer_container->overdraw_enabled)
+        {
+            return;
+        }
+
+        VkExtent2D extent = swapchain_manager->get_extent();
+        if (extent.width != output_extent.width || extent.height != output_extent.height)
+        {
+            create_resources(extent);
+        }
+    }
+
+    void OverdrawPass::record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last)
+    {
+        if (!buffer_container->overdraw_enabled)
+        {
+            return;
+        }
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VkCommandBuffer cmd = *command_buffer;
+
+        //Counts of this frame: atomics from the splat fragment shader or plain stores from the tile blend kernel
+        utils::MemoryUtils::memory_barrier(dispatch_table, cmd,
+                                           VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                           VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+        utils::ImageUtils::image_layout_transition(cmd, output_image.image,
+                                                   VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                   0, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                                   VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                                                   VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 });
+
+        push_constants.counts_address = buffer_container->overdraw_buffer.buffer_address;
+        push_constants.width = output_extent.width;
+        push_constants.height = output_extent.height;
+        push_constants.max_overdraw = engine_context.renderer->get_render_settings().overdraw_scale;
+
+        material_to_use->bind(cmd);
+        dispatch_table.cmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, material_to_use->get_pipeline_layout(),
+                                             0, 1, &material_to_use->get_descriptor_set(), 0, nullptr);
+        dispatch_table.cmdPushConstants(cmd, material_to_use->get_pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                                        0, sizeof(OverdrawPushConstantBlock), &push_constants);
+        dispatch_table.cmdDispatch(cmd, (output_extent.width + heatmap_workgroup_size - 1) / heatmap_workgroup_size,
+                                   (output_extent.height + heatmap_workgroup_size - 1) / heatmap_workgroup_size, 1);
+
+        blit_to_swapchain(cmd, output_image.image, output_extent, image_index);
+    }
+
+    void OverdrawPass::create_descriptors()
+    {
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        std::vector<VkDescriptorSetLayoutBinding> bindings = {
+            utils::DescriptorUtils::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 0)
+        };
+
+        VkDescriptorSetLayoutCreateInfo layout_info = utils::DescriptorUtils::descriptor_set_layout_create_info(bindings);
+        dispatch_table.createDescriptorSetLayout(&layout_info, nullptr, &descriptor_set_layout);
+
+        std::vector<VkDescriptorPoolSize> pool_sizes = {
+            utils::DescriptorUtils::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1)
+        };
+
+        VkDescriptorPoolCreateInfo pool_info = utils::DescriptorUtils::descriptor_pool_create_info(pool_sizes, 1);
+        dispatch_table.createDescriptorPool(&pool_info, nullptr, &descriptor_pool);
+
+        VkDescriptorSetAllocateInfo allocate_info = utils::DescriptorUtils::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layout, 1);
+        dispatch_table.allocateDescriptorSets(&allocate_info, &descriptor_set);
+    }
+
+    void OverdrawPass::create_resources(VkExtent2D extent)
+    {
+        engine_context.dispatch_table.deviceWaitIdle();
+
+        destroy_resources();
+
+        utils::RenderUtils::create_storage_image(engine_context, extent, output_format, device_manager->get_allocator(), MemoryCategory::Debug, output_image);
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) output_image.image, VK_OBJECT_TYPE_IMAGE, "Overdraw Heatmap");
+        output_extent = extent;
+
+        VkDescriptorImageInfo image_info{};
+        image_info.imageView = output_image.view;
+        image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet write = utils::DescriptorUtils::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0, &image_info);
+        engine_context.dispatch_table.updateDescriptorSets(1, &write, 0, nullptr);
+
+        //Cleared by the geometry pass at the start of every frame that counts
+        utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(),
+                                          sizeof(uint32_t) * static_cast<VkDeviceSize>(extent.width) * extent.height,
+                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                          VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, MemoryCategory::Debug, buffer_container->overdraw_buffer);
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) buffer_container->overdraw_buffer.buffer, VK_OBJECT_TYPE_BUFFER,
+                                      "Overdraw Counts");
+    }
+
+    void OverdrawPass::destroy_resources()
+    {
+        utils::MemoryUtils::destroy_image(engine_context.dispatch_table, device_manager->get_allocator(), output_image);
+
+        output_image = {};
+        output_extent = {};
+
+        utils::MemoryUtils::destroy_buffer(device_manager->get_allocator(), buffer_container->overdraw_buffer);
+    }
+
+    void OverdrawPass::cleanup()
+    {
+        Subpass::cleanup();
+
+        destroy_resources();
+
+        if (descriptor_pool != VK_NULL_HANDLE)
+        {
+            engine_context.dispatch_table.destroyDescriptorPool(descriptor_pool, nullptr);
+            descriptor_pool = VK_NULL_HANDLE;
+        }
+
+        if (descriptor_set_layout != VK_NULL_HANDLE)
+        {
+            engine_context.dispatch_table.destroyDescriptorSetLayout(descriptor_set_layout, nullptr);
+            descriptor_set_layout = VK_NULL_HANDLE;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "renderer/subpasses/PreprocessPass.h"
+
+#include "config/Config.inl"
+#include "renderer/GPU_BufferContainer.h"
+#include "renderer/Renderer.h"
+#include "structs/EngineContext.h"
+#include "structs/scene/PushConstantBlock.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+
+namespace core::renderer
+{
+    namespace
+    {
+        const std::string preprocess_shader_path = std::string(shader_directory) + R"(gaussian_preprocess\preprocess.comp.spv)";
+    }
+
+    PreprocessPass::PreprocessPass(EngineContext& engine_context, uint32_t max_frames_in_flight) : Subpass(engine_context, max_frames_in_flight),
+        material_utils(engine_context)
+    {
+        //Default variant up front, the others are compiled the first time they are selected
+        set_material(material_utils.get_compute_variant("preprocess", preprocess_shader_path, sizeof(PreprocessPushConstantBlock),
+                                                        material::ShaderVariant{}));
+
+        buffer_container = engine_context.buffer_container.get();
+    }
+
+    void PreprocessPass::frame_pre_recording()
+    {
+        const RenderSettings& settings = engine_context.renderer->get_render_settings();
+
+        material::ShaderVariant variant{};
+        variant.frustum_culling = settings.frustum_culling;
+        //The overdraw view keeps the splat colors, its heatmap is drawn by the overdraw pass
+        variant.debug_view = settings.debug_view == DebugView::Overdraw ? DebugView::None : settings.debug_view;
+
+        set_material(material_utils.get_compute_variant("preprocess", preprocess_shader_path, sizeof(PreprocessPushConstantBlock), variant));
+    }
+
+    void PreprocessPass::record_compute_commands(VkCommandBuffer* command_buffer)
+    {
+        if (buffer_container->gaussian_count == 0)
+        {
+            return;
+        }
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VkBuffer splat_records = buffer_container->get_splat_record_buffer().buffer;
+
+        //On the graphics queue an earlier frame may still be reading these records as vertex input.
+        //On the async queue the frame slot wait already covers it
+        if (!async_compute)
+        {
+            utils::MemoryUtils::buffer_memory_barrier(dispatch_table, *command_buffer, splat_records,
+                                                      VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                      VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                      0, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+        }
+
+        material_to_use->bind(*command_buffer);
+
+        PreprocessPushConstantBlock push_constant_block{};
+        push_constant_block.camera_data_address = buffer_container->camera_data_address;
+        push_constant_block.gaussian_buffer_address = buffer_container->gaussian_buffer.get_buffer().buffer_address;
+        push_constant_block.splat_record_address = buffer_container->get_splat_record_buffer().buffer_address;
+        push_constant_block.color_cache_address = buffer_container->color_cache_buffer.buffer_address;
+        push_constant_block.gaussian_count = buffer_container->gaussian_count;
+
+        dispatch_table.cmdPushConstants(*command_buffer, material_to_use->get_pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                                        0, sizeof(PreprocessPushConstantBlock), &push_constant_block);
+
+        uint32_t group_count = (buffer_container->gaussian_count + splat_workgroup_size - 1) / splat_workgroup_size;
+        dispatch_table.cmdDispatch(*command_buffer, group_count, 1, 1);
+
+        //Tile binning reads the records on the same queue
+        utils::MemoryUtils::buffer_memory_barrier(dispatch_table, *command_buffer, splat_records,
+                                                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                  VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+        release_to_graphics(*command_buffer, splat_records, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    }
+
+    void PreprocessPass::record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last)
+    {
+        if (buffer_container->gaussian_count == 0)
+        {
+            return;
+        }
+
+        //Records are consumed as vertex attributes (or storage by the mesh and tile paths) on the graphics queue
+        VkPipelineStageFlags2 consumer_stages = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        if (device_manager->is_mesh_shader_supported())
+        {
+            consumer_stages |= VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+        }
+
+        acquire_from_compute(*command_buffer, buffer_container->get_splat_record_buffer().buffer, consumer_stages,
+                             VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    }
+
+    void PreprocessPass::cleanup()
+    {
+        //material_to_use always points at one of the cached variants
+        material_utils.cleanup_variants();
+        material_to_use.reset();
+    }
+}
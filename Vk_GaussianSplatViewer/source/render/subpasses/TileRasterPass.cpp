@@ -0,0 +1,467 @@
+#include "renderer/subpasses/TileRasterPass.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+#include "config/Config.inl"
+#include "materials/MaterialUtils.h"
+#include "renderer/GPU_BufferContainer.h"
+#include "structs/EngineContext.h"
+#include "structs/geometry/SplatRecord.h"
+#include "vulkanapp/utils/DescriptorUtils.h"
+#include "vulkanapp/utils/ImageUtils.h"
+#include "vulkanapp/utils/MemoryUtils.h"
+#include "vulkanapp/utils/RenderUtils.h"
+#include "vulkanapp/utils/Vk_Utils.h"
+
+namespace
+{
+    //Layout of SortState in shaders/common/tile_raster.glsl
+    constexpr VkDeviceSize sort_state_size = 8 * sizeof(uint32_t);
+    constexpr VkDeviceSize sort_groups_offset = 1 * sizeof(uint32_t);
+    constexpr VkDeviceSize key_groups_offset = 4 * sizeof(uint32_t);
+
+    constexpr uint32_t radix_pass_count = 4;
+    constexpr uint32_t radix_bits = 8;
+    constexpr uint32_t radix_buckets = 256;
+
+    constexpr VkFormat output_format = VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+namespace core::renderer
+{
+    TileRasterPass::TileRasterPass(EngineContext& engine_context, uint32_t max_frames_in_flight) : Subpass(engine_context, max_frames_in_flight)
+    {
+        buffer_container = engine_context.buffer_container.get();
+        frame_sort_buffers.resize(max_frames_in_flight);
+
+        create_descriptors();
+
+        material::MaterialUtils material_utils(engine_context);
+        const std::string tile_directory = std::string(shader_directory) + R"(gaussian_tile\)";
+        constexpr uint32_t push_constant_size = sizeof(TileRasterPushConstantBlock);
+
+        duplicate_material = material_utils.create_compute_material("tile_duplicate", tile_directory + "tile_duplicate.comp.spv", push_constant_size);
+        sort_args_material = material_utils.create_compute_material("tile_sort_args", tile_directory + "tile_sort_args.comp.spv", push_constant_size);
+        histogram_material = material_utils.create_compute_material("radix_histogram", tile_directory + "radix_histogram.comp.spv", push_constant_size);
+        scan_material = material_utils.create_compute_material("radix_scan", tile_directory + "radix_scan.comp.spv", push_constant_size);
+        scatter_material = material_utils.create_compute_material("radix_scatter", tile_directory + "radix_scatter.comp.spv", push_constant_size);
+        ranges_material = material_utils.create_compute_material("tile_ranges", tile_directory + "tile_ranges.comp.spv", push_constant_size);
+
+        set_material(material_utils.create_compute_material("tile_render", tile_directory + "tile_render.comp.spv", push_constant_size,
+                                                            &descriptor_set_layout, 1));
+        material_to_use->add_descriptor_set(descriptor_set);
+    }
+
+    void TileRasterPass::frame_pre_recording()
+    {
+        if (engine_context.renderer->get_render_settings().render_mode != RenderMode::TileCompute)
+        {
+            return;
+        }
+
+        VkExtent2D extent = swapchain_manager->get_extent();
+        if (extent.width != output_extent.width || extent.height != output_extent.height)
+        {
+            create_output_image(extent);
+        }
+
+        //Sized for the gaussian buffer's capacity, so appends that fit in it keep the sort buffers
+        const auto gaussian_capacity = static_cast<uint32_t>(buffer_container->gaussian_buffer.get_capacity());
+        if (gaussian_capacity != allocated_gaussian_capacity)
+        {
+            allocate_sort_buffers(gaussian_capacity);
+        }
+        else if (key_capacity != 0 && scratch_version != buffer_container->compute_scratch_version)
+        {
+            //Another pass grew the shared scratch memory
+            bind_sort_scratch();
+        }
+    }
+
+    void TileRasterPass::record_compute_commands(VkCommandBuffer* command_buffer)
+    {
+        if (engine_context.renderer->get_render_settings().render_mode != RenderMode::TileCompute ||
+            buffer_container->gaussian_count == 0 || key_capacity == 0)
+        {
+            return;
+        }
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VkCommandBuffer cmd = *command_buffer;
+        FrameSortBuffers& frame_buffers = frame_sort_buffers[current_frame];
+
+        //Scratch memory is shared between frames and with earlier compute passes: wait for their readers and writers before clearing
+        utils::MemoryUtils::memory_barrier(dispatch_table, cmd,
+                                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                                           VK_PIPELINE_STAGE_2_CLEAR_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                           VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                           VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+        dispatch_table.cmdFillBuffer(cmd, sort_state_buffer.buffer, 0, VK_WHOLE_SIZE, 0);
+        dispatch_table.cmdFillBuffer(cmd, frame_buffers.tile_range_buffer.buffer, 0, VK_WHOLE_SIZE, 0);
+
+        utils::MemoryUtils::memory_barrier(dispatch_table, cmd,
+                                           VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                           VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+        push_constants.camera_data_address = buffer_container->camera_data_address;
+        push_constants.splat_record_address = buffer_container->get_splat_record_buffer().buffer_address;
+        push_constants.sort_state_address = sort_state_buffer.buffer_address;
+        push_constants.histogram_address = histogram_buffer.buffer_address;
+        push_constants.tile_range_address = frame_buffers.tile_range_buffer.buffer_address;
+        push_constants.gaussian_count = buffer_container->gaussian_count;
+        push_constants.key_capacity = key_capacity;
+        push_constants.tile_count_x = tile_count_x;
+        push_constants.tile_count_y = tile_count_y;
+        push_constants.tile_bits = tile_bits;
+        push_constants.radix_shift = 0;
+        push_constants.keys_in_address = key_buffers[0].buffer_address;
+        push_constants.values_in_address = get_value_buffer(0).buffer_address;
+        push_constants.keys_out_address = key_buffers[1].buffer_address;
+        push_constants.values_out_address = get_value_buffer(1).buffer_address;
+
+        //1. Key duplication, one key per touched tile. Spread over y to stay under the guaranteed 65535 groups per dimension
+        const uint32_t duplicate_groups = (buffer_container->gaussian_count + splat_workgroup_size - 1) / splat_workgroup_size;
+        const uint32_t duplicate_groups_x = std::min(duplicate_groups, 65535u);
+
+        begin_gpu_scope(cmd, "Duplicate keys");
+        dispatch(cmd, *duplicate_material, duplicate_groups_x, (duplicate_groups + duplicate_groups_x - 1) / duplicate_groups_x);
+        compute_barrier(cmd);
+        end_gpu_scope(cmd);
+
+        //2. Indirect arguments for the sort from the GPU side key count
+        begin_gpu_scope(cmd, "Sort args");
+        dispatch(cmd, *sort_args_material, 1);
+        compute_barrier(cmd);
+        end_gpu_scope(cmd);
+
+        begin_gpu_scope(cmd, "Radix sort");
+
+        //3. LSD radix sort, 8 bits per pass. An even pass count leaves the result in buffer 0
+        for (uint32_t pass = 0; pass < radix_pass_count; ++pass)
+        {
+            const uint32_t in = pass % 2;
+            const uint32_t out = 1 - in;
+
+            push_constants.radix_shift = pass * radix_bits;
+            push_constants.keys_in_address = key_buffers[in].buffer_address;
+            push_constants.values_in_address = get_value_buffer(in).buffer_address;
+            push_constants.keys_out_address = key_buffers[out].buffer_address;
+            push_constants.values_out_address = get_value_buffer(out).buffer_address;
+
+            begin_gpu_scope(cmd, "Histogram");
+            dispatch_indirect(cmd, *histogram_material, sort_groups_offset);
+            compute_barrier(cmd);
+            end_gpu_scope(cmd);
+
+            begin_gpu_scope(cmd, "Scan");
+            dispatch(cmd, *scan_material, 1);
+            compute_barrier(cmd);
+            end_gpu_scope(cmd);
+
+            begin_gpu_scope(cmd, "Scatter");
+            dispatch_indirect(cmd, *scatter_material, sort_groups_offset);
+            compute_barrier(cmd);
+            end_gpu_scope(cmd);
+        }
+
+        end_gpu_scope(cmd);
+
+        push_constants.keys_in_address = key_buffers[0].buffer_address;
+        push_constants.values_in_address = frame_buffers.sorted_value_buffer.buffer_address;
+
+        //4. Per tile ranges in the sorted list
+        begin_gpu_scope(cmd, "Tile ranges");
+        dispatch_indirect(cmd, *ranges_material, key_groups_offset);
+        compute_barrier(cmd);
+        end_gpu_scope(cmd);
+
+        release_to_graphics(cmd, frame_buffers.sorted_value_buffer.buffer, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+        release_to_graphics(cmd, frame_buffers.tile_range_buffer.buffer, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    }
+
+    void TileRasterPass::record_commands(VkCommandBuffer* command_buffer, uint32_t image_index, bool is_last)
+    {
+        if (engine_context.renderer->get_render_settings().render_mode != RenderMode::TileCompute ||
+            buffer_container->gaussian_count == 0 || key_capacity == 0)
+        {
+            return;
+        }
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VkCommandBuffer cmd = *command_buffer;
+        const FrameSortBuffers& frame_buffers = frame_sort_buffers[current_frame];
+
+        acquire_from_compute(cmd, frame_buffers.sorted_value_buffer.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+        acquire_from_compute(cmd, frame_buffers.tile_range_buffer.buffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+        push_constants.camera_data_address = buffer_container->camera_data_address;
+        push_constants.splat_record_address = buffer_container->get_splat_record_buffer().buffer_address;
+        push_constants.values_in_address = frame_buffers.sorted_value_buffer.buffer_address;
+        push_constants.tile_range_address = frame_buffers.tile_range_buffer.buffer_address;
+
+        //5. Front to back blending, one workgroup per tile
+        utils::ImageUtils::image_layout_transition(cmd, output_image.image,
+                                                   VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                                   0, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                                   VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                                                   VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 });
+
+        dispatch_table.cmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, material_to_use->get_pipeline_layout(),
+                                             0, 1, &material_to_use->get_descriptor_set(), 0, nullptr);
+        begin_gpu_scope(cmd, "Blend tiles");
+        dispatch(cmd, *material_to_use, tile_count_x, tile_count_y);
+        end_gpu_scope(cmd);
+
+        begin_gpu_scope(cmd, "Composite");
+        blit_to_swapchain(cmd, output_image.image, output_extent, image_index);
+        end_gpu_scope(cmd);
+    }
+
+    void TileRasterPass::dispatch(VkCommandBuffer command_buffer, const material::Material& material, uint32_t group_count_x, uint32_t group_count_y) const
+    {
+        material.bind(command_buffer);
+        engine_context.dispatch_table.cmdPushConstants(command_buffer, material.get_pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                                                       0, sizeof(TileRasterPushConstantBlock), &push_constants);
+        engine_context.dispatch_table.cmdDispatch(command_buffer, group_count_x, group_count_y, 1);
+    }
+
+    void TileRasterPass::dispatch_indirect(VkCommandBuffer command_buffer, const material::Material& material, VkDeviceSize offset) const
+    {
+        material.bind(command_buffer);
+        engine_context.dispatch_table.cmdPushConstants(command_buffer, material.get_pipeline_layout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                                                       0, sizeof(TileRasterPushConstantBlock), &push_constants);
+        engine_context.dispatch_table.cmdDispatchIndirect(command_buffer, sort_state_buffer.buffer, offset);
+    }
+
+    void TileRasterPass::compute_barrier(VkCommandBuffer command_buffer) const
+    {
+        utils::MemoryUtils::memory_barrier(engine_context.dispatch_table, command_buffer,
+                                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                                           VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                           VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+    }
+
+    void TileRasterPass::create_descriptors()
+    {
+        auto& dispatch_table = engine_context.dispatch_table;
+
+        std::vector<VkDescriptorSetLayoutBinding> bindings = {
+            utils::DescriptorUtils::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 0)
+        };
+
+        VkDescriptorSetLayoutCreateInfo layout_info = utils::DescriptorUtils::descriptor_set_layout_create_info(bindings);
+        dispatch_table.createDescriptorSetLayout(&layout_info, nullptr, &descriptor_set_layout);
+
+        std::vector<VkDescriptorPoolSize> pool_sizes = {
+            utils::DescriptorUtils::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1)
+        };
+
+        VkDescriptorPoolCreateInfo pool_info = utils::DescriptorUtils::descriptor_pool_create_info(pool_sizes, 1);
+        dispatch_table.createDescriptorPool(&pool_info, nullptr, &descriptor_pool);
+
+        VkDescriptorSetAllocateInfo allocate_info = utils::DescriptorUtils::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layout, 1);
+        dispatch_table.allocateDescriptorSets(&allocate_info, &descriptor_set);
+    }
+
+    void TileRasterPass::create_output_image(VkExtent2D extent)
+    {
+        engine_context.dispatch_table.deviceWaitIdle();
+
+        destroy_output_image();
+
+        utils::RenderUtils::create_storage_image(engine_context, extent, output_format, device_manager->get_allocator(), MemoryCategory::Targets, output_image);
+        utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) output_image.image, VK_OBJECT_TYPE_IMAGE, "Tile Raster Output");
+        output_extent = extent;
+
+        VkDescriptorImageInfo image_info{};
+        image_info.imageView = output_image.view;
+        image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet write = utils::DescriptorUtils::write_descriptor_set(descriptor_set, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0, &image_info);
+        engine_context.dispatch_table.updateDescriptorSets(1, &write, 0, nullptr);
+
+        //Tile index bits are part of the sort key; the rest of the key holds depth
+        tile_count_x = (extent.width + tile_size - 1) / tile_size;
+        tile_count_y = (extent.height + tile_size - 1) / tile_size;
+        tile_bits = std::max(1u, static_cast<uint32_t>(std::bit_width(tile_count_x * tile_count_y - 1)));
+
+        //Tile ranges depend on the tile count
+        allocate_tile_range_buffers();
+    }
+
+    void TileRasterPass::allocate_tile_range_buffers()
+    {
+        destroy_tile_range_buffers();
+
+        for (auto& frame_buffers : frame_sort_buffers)
+        {
+            utils::MemoryUtils::create_buffer(engine_context.dispatch_table, device_manager->get_allocator(),
+                                              sizeof(uint32_t) * 2 * tile_count_x * tile_count_y,
+                                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                              VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, MemoryCategory::Sort, frame_buffers.tile_range_buffer, {},
+                                              device_manager->get_scratch_pool());
+        }
+    }
+
+    void TileRasterPass::destroy_tile_range_buffers()
+    {
+        for (auto& frame_buffers : frame_sort_buffers)
+        {
+            utils::MemoryUtils::destroy_buffer(device_manager->get_allocator(), frame_buffers.tile_range_buffer);
+        }
+    }
+
+    const GPU_Buffer& TileRasterPass::get_value_buffer(uint32_t slot) const
+    {
+        return slot == 0 ? frame_sort_buffers[current_frame].sorted_value_buffer : value_scratch_buffer;
+    }
+
+    void TileRasterPass::destroy_output_image()
+    {
+        utils::MemoryUtils::destroy_image(engine_context.dispatch_table, device_manager->get_allocator(), output_image);
+
+        output_image = {};
+        output_extent = {};
+    }
+
+    void TileRasterPass::allocate_sort_buffers(uint32_t gaussian_capacity)
+    {
+        engine_context.dispatch_table.deviceWaitIdle();
+
+        destroy_sort_buffers();
+
+        allocated_gaussian_capacity = gaussian_capacity;
+        if (gaussian_capacity == 0)
+        {
+            return;
+        }
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VmaAllocator allocator = device_manager->get_allocator();
+
+        //Key indices are 32 bit on the GPU, and the buffers would outgrow any heap long before that
+        const uint64_t wanted_keys = static_cast<uint64_t>(gaussian_capacity) * tile_keys_per_splat;
+        key_capacity = static_cast<uint32_t>(std::min(wanted_keys, max_tile_keys));
+        if (wanted_keys > max_tile_keys)
+        {
+            std::cout << "Tile keys clamped to " << key_capacity << " (" << gaussian_capacity << " splats want " << wanted_keys
+                      << "), splats past it are dropped in crowded frames" << std::endl;
+        }
+
+        const VkDeviceSize key_buffer_size = sizeof(uint32_t) * static_cast<VkDeviceSize>(key_capacity);
+
+        //Read by the blend kernel on the graphics queue, so they cannot live in the shared compute scratch
+        for (auto& frame_buffers : frame_sort_buffers)
+        {
+            utils::MemoryUtils::create_buffer(dispatch_table, allocator, key_buffer_size,
+                                              VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                              VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0, MemoryCategory::Sort, frame_buffers.sorted_value_buffer, {},
+                                              device_manager->get_scratch_pool());
+        }
+
+        bind_sort_scratch();
+    }
+
+    void TileRasterPass::bind_sort_scratch()
+    {
+        destroy_sort_scratch();
+
+        auto& dispatch_table = engine_context.dispatch_table;
+        VmaAllocator allocator = device_manager->get_allocator();
+
+        const uint32_t sort_group_capacity = (key_capacity + sort_keys_per_workgroup - 1) / sort_keys_per_workgroup;
+        const VkDeviceSize key_buffer_size = sizeof(uint32_t) * static_cast<VkDeviceSize>(key_capacity);
+        const VkDeviceSize histogram_size = sizeof(uint32_t) * radix_buckets * static_cast<VkDeviceSize>(sort_group_capacity);
+
+        constexpr VkBufferUsageFlags state_usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                                   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        constexpr VkBufferUsageFlags scratch_usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+        const VkDeviceSize alignment = std::max(utils::MemoryUtils::get_buffer_alignment(dispatch_table, state_usage),
+                                                utils::MemoryUtils::get_buffer_alignment(dispatch_table, scratch_usage));
+
+        //Sort state, both key slots, the value scratch and the histograms packed back to back
+        const VkDeviceSize sizes[5] = { sort_state_size, key_buffer_size, key_buffer_size, key_buffer_size, histogram_size };
+        VkDeviceSize offsets[5]{};
+        VkDeviceSize scratch_size = 0;
+
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            offsets[i] = (scratch_size + alignment - 1) / alignment * alignment;
+            scratch_size = offsets[i] + sizes[i];
+        }
+
+        buffer_container->reserve_compute_scratch(scratch_size);
+        const GPU_Buffer& scratch = buffer_container->compute_scratch_buffer;
+
+        utils::MemoryUtils::create_aliasing_buffer(dispatch_table, allocator, scratch, offsets[0], sizes[0], state_usage, sort_state_buffer);
+        utils::MemoryUtils::create_aliasing_buffer(dispatch_table, allocator, scratch, offsets[1], sizes[1], scratch_usage, key_buffers[0]);
+        utils::MemoryUtils::create_aliasing_buffer(dispatch_table, allocator, scratch, offsets[2], sizes[2], scratch_usage, key_buffers[1]);
+        utils::MemoryUtils::create_aliasing_buffer(dispatch_table, allocator, scratch, offsets[3], sizes[3], scratch_usage, value_scratch_buffer);
+        utils::MemoryUtils::create_aliasing_buffer(dispatch_table, allocator, scratch, offsets[4], sizes[4], scratch_usage, histogram_buffer);
+
+        scratch_version = buffer_container->compute_scratch_version;
+    }
+
+    void TileRasterPass::destroy_sort_scratch()
+    {
+        VmaAllocator allocator = device_manager->get_allocator();
+
+        utils::MemoryUtils::destroy_buffer(allocator, sort_state_buffer);
+        utils::MemoryUtils::destroy_buffer(allocator, histogram_buffer);
+        utils::MemoryUtils::destroy_buffer(allocator, value_scratch_buffer);
+
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            utils::MemoryUtils::destroy_buffer(allocator, key_buffers[i]);
+        }
+    }
+
+    void TileRasterPass::destroy_sort_buffers()
+    {
+        VmaAllocator allocator = device_manager->get_allocator();
+
+        destroy_sort_scratch();
+
+        for (auto& frame_buffers : frame_sort_buffers)
+        {
+            utils::MemoryUtils::destroy_buffer(allocator, frame_buffers.sorted_value_buffer);
+        }
+
+        key_capacity = 0;
+        allocated_gaussian_capacity = 0;
+    }
+
+    void TileRasterPass::cleanup()
+    {
+        Subpass::cleanup();
+
+        for (auto& material : { duplicate_material, sort_args_material, histogram_material, scan_material, scatter_material, ranges_material })
+        {
+            if (material)
+            {
+                material->cleanup();
+            }
+        }
+
+        destroy_sort_buffers();
+        destroy_output_image();
+        destroy_tile_range_buffers();
+
+        if (descriptor_pool != VK_NULL_HANDLE)
+        {
+            engine_context.dispatch_table.destroyDescriptorPool(descriptor_pool, nullptr);
+            descriptor_pool = VK_NULL_HANDLE;
+        }
+
+        if (descriptor_set_layout != VK_NULL_HANDLE)
+        {
+            engine_context.dispatch_table.destroyDescriptorSetLayout(descriptor_set_layout, nullptr);
+            descriptor_set_layout = VK_NULL_HANDLE;
+        }
+    }
+}
@@ -1,17 +1,21 @@
 #include "vulkanapp/DeviceManager.h"
 
+#include <algorithm>
 #include <iostream>
+#include "config/Config.inl"
 #include "structs/EngineContext.h"
 #include "vulkanapp/VulkanCleanupQueue.h"
 #include "vulkanapp/feature_activator/VulkanFeatureActivator.h"
 
-vulkanapp::DeviceManager::DeviceManager(EngineContext& engine_context): surface(nullptr), compute_queue(nullptr),
+vulkanapp::DeviceManager::DeviceManager(EngineContext& engine_context): surface(nullptr), compute_queue(nullptr), transfer_queue(nullptr),
                                                                                                        graphics_queue(nullptr), present_queue(nullptr),
                                                                                                        vma_allocator(nullptr), engine_context(engine_context){ }
 vulkanapp::DeviceManager::~DeviceManager()= default;
 
-bool vulkanapp::DeviceManager::device_init()
+bool vulkanapp::DeviceManager::device_init(bool headless)
 {
+    this->headless = headless;
+
     //Instance Creation
     // Create the disable feature struct
     VkValidationFeatureDisableEXT disables[] =
@@ -20,15 +24,22 @@ bool vulkanapp::DeviceManager::device_init()
     };
     
     vkb::InstanceBuilder instance_builder;
+
+    //The emulation layer adds per draw overhead; without it, drivers lacking VK_EXT_shader_object use the pipeline backend
+    if (allow_shader_object_emulation)
+    {
+        instance_builder.enable_layer("VK_LAYER_KHRONOS_shader_object");
+    }
+
     auto instance_ret = instance_builder.
         set_minimum_instance_version(VK_API_VERSION_1_4)
         .use_default_debug_messenger()
         .add_validation_feature_disable(*disables)
-        .enable_layer("VK_LAYER_KHRONOS_shader_object")
         .enable_extension(VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME)
         .enable_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
         .enable_extension(VK_EXT_DEBUG_UTILS_EXTENSION_NAME)
         .request_validation_layers()
+        .set_headless(headless)
         .build();
     
     if (!instance_ret)
@@ -46,7 +57,11 @@ bool vulkanapp::DeviceManager::device_init()
     features.largePoints = VK_TRUE;
     features.fillModeNonSolid = VK_TRUE;
 
-    surface = engine_context.window_manager->create_surface_sdl3(instance_ret.value().instance, nullptr);
+    //The splat fragment shader holds the overdraw counter atomics, so every device needs them
+    features.fragmentStoresAndAtomics = VK_TRUE;
+
+    //Headless instances have no surface extensions, the selector then does not ask for present support or VK_KHR_swapchain
+    surface = headless ? VK_NULL_HANDLE : engine_context.window_manager->create_surface_sdl3(instance_ret.value().instance, nullptr);
 
     vkb::PhysicalDeviceSelector phys_device_selector(instance);
     auto phys_device_ret = phys_device_selector
@@ -55,7 +70,6 @@ bool vulkanapp::DeviceManager::device_init()
         .add_required_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
         .add_required_extension(VK_EXT_VERTEX_INPUT_DYNAMIC_STATE_EXTENSION_NAME)
         .add_required_extension(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME)
-        .add_required_extension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
         .add_required_extension(VK_KHR_MULTIVIEW_EXTENSION_NAME)
         .add_required_extension(VK_KHR_MAINTENANCE_2_EXTENSION_NAME)
         .add_required_extension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME)
@@ -78,22 +92,65 @@ bool vulkanapp::DeviceManager::device_init()
     auto descriptorIndexingFeatures = VulkanFeatureActivator::create_physical_device_descriptor_indexing_features();
     auto synchronization2_features = VulkanFeatureActivator::create_synchronization2_features();
     auto vertex_input_dynamic_state_features = VulkanFeatureActivator::create_vertex_input_dynamic_state_features();
+    auto timeline_semaphore_features = VulkanFeatureActivator::create_timeline_semaphore_features();
     
     if (!phys_device_ret)
     {
         std::cout << phys_device_ret.error().message() << "\n";
         return false;
     }
-    const vkb::PhysicalDevice& p_device = phys_device_ret.value();
+    vkb::PhysicalDevice p_device = phys_device_ret.value();
+
+    //Optional: task/mesh shader splat path. Falls back to the vertex path when missing
+    auto mesh_shader_features = VulkanFeatureActivator::create_mesh_shader_features();
+    mesh_shader_supported = p_device.enable_extension_if_present(VK_EXT_MESH_SHADER_EXTENSION_NAME) &&
+                            p_device.enable_extension_features_if_present(mesh_shader_features);
+
+    std::cout << "Mesh shaders " << (mesh_shader_supported ? "available" : "not available, using the vertex path") << "\n";
+
+    //Optional: shader objects. Materials are built as VkPipelines when the driver does not expose them
+    shader_object_supported = p_device.enable_extension_if_present(VK_EXT_SHADER_OBJECT_EXTENSION_NAME) &&
+                              p_device.enable_extension_features_if_present(shader_object_features);
+
+    std::cout << "Shader objects " << (shader_object_supported ? "available" : "not available, using pipelines") << "\n";
+
+    //Optional: zero-copy import of mapped splat cache files. Falls back to the staging upload when missing
+    external_memory_host_supported = p_device.enable_extension_if_present(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+    if (external_memory_host_supported)
+    {
+        VkPhysicalDeviceExternalMemoryHostPropertiesEXT host_memory_properties{};
+        host_memory_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &host_memory_properties;
+        engine_context.instance_dispatch_table.getPhysicalDeviceProperties2(p_device.physical_device, &properties2);
+
+        min_imported_host_pointer_alignment = host_memory_properties.minImportedHostPointerAlignment;
+    }
+
+    std::cout << "Host memory import " << (external_memory_host_supported ? "available" : "not available, splat caches are staged") << "\n";
+
+    //Optional: vertex/fragment invocation counts in the UI
+    VkPhysicalDeviceFeatures pipeline_statistics_features{};
+    pipeline_statistics_features.pipelineStatisticsQuery = VK_TRUE;
+    pipeline_statistics_query_supported = p_device.enable_features_if_present(pipeline_statistics_features);
+
+    std::cout << "Pipeline statistics " << (pipeline_statistics_query_supported ? "available" : "not available") << "\n";
+
+    //Optional: OS provided heap budgets. Without it VMA estimates them from the heap sizes
+    memory_budget_supported = p_device.enable_extension_if_present(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    std::cout << "Memory budget " << (memory_budget_supported ? "available" : "not available, budgets are estimated") << "\n";
 
     vkb::DeviceBuilder device_builder{ p_device };
     auto device_ret = device_builder
         .add_pNext(&dynamic_rendering_features)
-        .add_pNext(&shader_object_features)
         .add_pNext(&device_memory_features)
         .add_pNext(&descriptorIndexingFeatures)
         .add_pNext(&synchronization2_features)
         .add_pNext(&vertex_input_dynamic_state_features)
+        .add_pNext(&timeline_semaphore_features)
         .build();
     
     if (!device_ret)
@@ -118,32 +175,106 @@ bool vulkanapp::DeviceManager::init_queues()
         return false;
     }
     graphics_queue = gq.value();
+    graphics_queue_family = device.get_queue_index(vkb::QueueType::graphics).value();
 
-    auto pq = device.get_queue(vkb::QueueType::present);
-    if (!pq.has_value())
+    if (headless)
     {
-        std::cout << "failed to get present queue: " << pq.error().message() << "\n";
-        return false;
+        present_queue = graphics_queue;
     }
+    else
+    {
+        auto pq = device.get_queue(vkb::QueueType::present);
+        if (!pq.has_value())
+        {
+            std::cout << "failed to get present queue: " << pq.error().message() << "\n";
+            return false;
+        }
 
-    present_queue = pq.value();
+        present_queue = pq.value();
+    }
     
+    //A separate compute family enables async compute, otherwise compute work shares the graphics queue
     auto cq = device.get_queue(vkb::QueueType::compute);
     if (!cq.has_value())
     {
-        std::cout << "failed to get compute queue: " << cq.error().message() << "\n";
-        return false;
+        std::cout << "no separate compute queue (" << cq.error().message() << "), async compute disabled\n";
+        compute_queue = graphics_queue;
+        compute_queue_family = graphics_queue_family;
+        async_compute_supported = false;
+    }
+    else
+    {
+        compute_queue = cq.value();
+        compute_queue_family = device.get_queue_index(vkb::QueueType::compute).value();
+        async_compute_supported = compute_queue_family != graphics_queue_family;
     }
 
-    compute_queue = cq.value();
+    //Uploads prefer a transfer only family (DMA engine), then any non graphics one, then the graphics queue
+    auto tq = device.get_dedicated_queue(vkb::QueueType::transfer);
+    if (tq.has_value())
+    {
+        transfer_queue = tq.value();
+        transfer_queue_family = device.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+    }
+    else if (auto separate_tq = device.get_queue(vkb::QueueType::transfer); separate_tq.has_value())
+    {
+        transfer_queue = separate_tq.value();
+        transfer_queue_family = device.get_queue_index(vkb::QueueType::transfer).value();
+    }
+    else
+    {
+        std::cout << "no separate transfer queue, uploads use the graphics queue\n";
+        transfer_queue = graphics_queue;
+        transfer_queue_family = graphics_queue_family;
+    }
     
     return true;
 }
 
+std::vector<uint32_t> vulkanapp::DeviceManager::get_shared_queue_families() const
+{
+    std::vector<uint32_t> families = { graphics_queue_family };
+
+    for (uint32_t family : { compute_queue_family, transfer_queue_family })
+    {
+        if (std::find(families.begin(), families.end(), family) == families.end())
+        {
+            families.push_back(family);
+        }
+    }
+
+    if (families.size() == 1)
+    {
+        return {};
+    }
+
+    return families;
+}
+
+uint32_t vulkanapp::DeviceManager::get_timestamp_valid_bits(uint32_t queue_family) const
+{
+    auto queue_families = physical_device.get_queue_families();
+    if (queue_family >= queue_families.size())
+    {
+        return 0;
+    }
+
+    return queue_families[queue_family].timestampValidBits;
+}
+
 void vulkanapp::DeviceManager::cleanup()
 {
     if (vma_allocator != VK_NULL_HANDLE)
     {
+        for (VmaPool* pool : { &splat_pool, &scratch_pool })
+        {
+            if (*pool != VK_NULL_HANDLE)
+            {
+                vmaDestroyPool(vma_allocator, *pool);
+                *pool = VK_NULL_HANDLE;
+            }
+        }
+
         vmaDestroyAllocator(vma_allocator);
         vma_allocator = VK_NULL_HANDLE;
     }
@@ -153,7 +284,10 @@ void vulkanapp::DeviceManager::cleanup()
         engine_context.instance_dispatch_table.destroyDebugUtilsMessengerEXT(instance.debug_messenger, nullptr);
     }
 
-    engine_context.instance_dispatch_table.destroySurfaceKHR(surface, nullptr);
+    if (surface != VK_NULL_HANDLE)
+    {
+        engine_context.instance_dispatch_table.destroySurfaceKHR(surface, nullptr);
+    }
     
     //No corresponding Vk Bootstrapper function for destroy device
     vkDestroyDevice(device.device, nullptr);
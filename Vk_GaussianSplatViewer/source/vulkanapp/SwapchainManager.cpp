@@ -1,6 +1,7 @@
 ﻿#include "vulkanapp/SwapchainManager.h"
 
 #include "structs/EngineContext.h"
+#include "vulkanapp/utils/MemoryTracker.h"
 #include <iostream>
 #include <vulkan/vulkan_core.h>
 #include <algorithm>
@@ -36,6 +37,62 @@ namespace vulkanapp
         }
     }
 
+    void SwapchainManager::initialize_offscreen(VkDevice device, VmaAllocator allocator, uint32_t image_count, VkExtent2D extent, VkFormat format)
+    {
+        if (device == VK_NULL_HANDLE || allocator == VK_NULL_HANDLE)
+        {
+            throw std::invalid_argument("Invalid Vulkan handles provided to SwapchainManager");
+        }
+
+        m_device = device;
+        m_allocator = allocator;
+        m_image_format = format;
+        m_extent = extent;
+        max_image_count = image_count;
+
+        if (!create_offscreen_images(image_count))
+        {
+            throw std::runtime_error("Failed to create offscreen images");
+        }
+    }
+
+    bool SwapchainManager::create_offscreen_images(uint32_t image_count)
+    {
+        VkImageCreateInfo image_info{};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.format = m_image_format;
+        image_info.extent = { m_extent.width, m_extent.height, 1 };
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        //Same usage as the swapchain images plus transfer src for the readback
+        image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VmaAllocationCreateInfo allocation_info{};
+        allocation_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+        m_images.resize(image_count);
+        for (auto& image : m_images)
+        {
+            image.image = VK_NULL_HANDLE;
+            image.image_view = VK_NULL_HANDLE;
+
+            if (vmaCreateImage(m_allocator, &image_info, &allocation_info, &image.image, &image.allocation, nullptr) != VK_SUCCESS)
+            {
+                std::cerr << "failed to create offscreen image\n";
+                return false;
+            }
+
+            utils::MemoryTracker::track(m_allocator, image.allocation, MemoryCategory::Targets);
+        }
+
+        return create_image_views();
+    }
+
     bool SwapchainManager::create_swapchain(uint32_t window_width, uint32_t window_height)
     {
         SwapchainSupportDetails swapchain_support = query_swapchain_support();
@@ -73,7 +130,8 @@ namespace vulkanapp
         create_info.imageColorSpace = surface_format.colorSpace;
         create_info.imageExtent = extent;
         create_info.imageArrayLayers = 1;
-        create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        //Transfer dst lets the compute rasterizer blit its output into the swapchain
+        create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
         create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
         create_info.queueFamilyIndexCount = 0;
         create_info.pQueueFamilyIndices = nullptr;
@@ -129,6 +187,7 @@ namespace vulkanapp
         m_physical_device = VK_NULL_HANDLE;
         m_device = VK_NULL_HANDLE;
         m_surface = VK_NULL_HANDLE;
+        m_allocator = VK_NULL_HANDLE;
     }
 
     SwapchainSupportDetails SwapchainManager::query_swapchain_support() const
@@ -253,6 +312,15 @@ namespace vulkanapp
             m_swapchain = VK_NULL_HANDLE;
         }
 
+        for (auto& image : m_images)
+        {
+            if (image.allocation != VK_NULL_HANDLE)
+            {
+                utils::MemoryTracker::release(m_allocator, image.allocation);
+                vmaDestroyImage(m_allocator, image.image, image.allocation);
+            }
+        }
+
         m_images.clear();
         m_image_format = VK_FORMAT_UNDEFINED;
         m_extent = {0, 0};
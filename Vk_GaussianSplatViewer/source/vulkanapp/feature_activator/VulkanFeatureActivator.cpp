@@ -64,4 +64,21 @@ VkPhysicalDeviceVertexInputDynamicStateFeaturesEXT vulkanapp::VulkanFeatureActiv
     return vertexInputDynamicStateFeatures;
 }
 
+VkPhysicalDeviceMeshShaderFeaturesEXT vulkanapp::VulkanFeatureActivator::create_mesh_shader_features()
+{
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT};
+    meshShaderFeatures.pNext = nullptr;
+    meshShaderFeatures.taskShader = VK_TRUE;
+    meshShaderFeatures.meshShader = VK_TRUE;
+
+    return meshShaderFeatures;
+}
 
+VkPhysicalDeviceTimelineSemaphoreFeatures vulkanapp::VulkanFeatureActivator::create_timeline_semaphore_features()
+{
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+    timelineSemaphoreFeatures.pNext = nullptr;
+    timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
+    return timelineSemaphoreFeatures;
+}
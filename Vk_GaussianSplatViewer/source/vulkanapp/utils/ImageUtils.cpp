@@ -5,6 +5,7 @@
 
 #include <vma/vk_mem_alloc.h>
 #include <VkBootstrapDispatch.h>
+#include "vulkanapp/utils/MemoryTracker.h"
 #include "vulkanapp/utils/MemoryUtils.h"
 #include "structs/GPU_Buffer.h"
 #include "vulkanapp/DeviceManager.h"
@@ -55,7 +56,7 @@ Vk_Image utils::ImageUtils::create_texture_image(EngineContext& engine_context,
                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                                      VMA_MEMORY_USAGE_AUTO,
                                      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |  VMA_ALLOCATION_CREATE_MAPPED_BIT,
-                                     stagingImageBuffer);
+                                     MemoryCategory::Staging, stagingImageBuffer);
     
         void* data;
         vmaMapMemory(device_manager->get_allocator(), stagingImageBuffer.allocation, &data);
@@ -76,6 +77,7 @@ Vk_Image utils::ImageUtils::create_texture_image(EngineContext& engine_context,
         
         Vk_Image textureImage;
         vmaCreateImage(device_manager->get_allocator(), &imgIfo, &imgAllocInfo, &textureImage.image, &textureImage.allocation, &textureImage.allocation_info);
+        MemoryTracker::track(device_manager->get_allocator(), textureImage.allocation, MemoryCategory::Other);
 
         //Copy image to device Memory
         copy_image(engine_context, device_manager->get_graphics_queue(), command_pool, stagingImageBuffer, textureImage, imageSize, imageExtent);
@@ -208,7 +210,7 @@ void utils::ImageUtils::copy_image(EngineContext& engine_context, VkQueue queue,
 
     engine_context.dispatch_table.freeCommandBuffers(command_pool, 1, &commandBuffer);
 
-    vmaDestroyBuffer(engine_context.device_manager->get_allocator(), srcBuffer.buffer, srcBuffer.allocation);
+    MemoryUtils::destroy_buffer(engine_context.device_manager->get_allocator(), srcBuffer);
 }
 
 void utils::ImageUtils::copy_image_to_buffer(EngineContext& render_context, Vk_Image src_image, GPU_Buffer& dst_buffer, VkCommandBuffer cmd_buffer, VkOffset3D image_offset)
@@ -0,0 +1,157 @@
+#include "vulkanapp/utils/MemoryTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "config/Config.inl"
+
+namespace utils
+{
+    namespace
+    {
+        constexpr size_t category_count = static_cast<size_t>(MemoryCategory::Count);
+
+        constexpr const char* category_names[category_count] =
+        {
+            "Splats",
+            "Sort",
+            "Staging",
+            "Uniforms",
+            "Targets",
+            "Depth",
+            "Debug",
+            "Other"
+        };
+
+        std::atomic<uint64_t> category_bytes[category_count]{};
+        std::atomic<uint32_t> category_allocations[category_count]{};
+
+        //Heaps above the warning threshold, so the warning is only printed when a heap crosses it
+        std::atomic<uint32_t> warned_heaps{ 0 };
+
+        //User data holds category + 1, null marks allocations created before tracking or outside of it
+        void* encode_category(MemoryCategory category)
+        {
+            return reinterpret_cast<void*>(static_cast<uintptr_t>(category) + 1);
+        }
+    }
+
+    void MemoryTracker::track(VmaAllocator allocator, VmaAllocation allocation, MemoryCategory category)
+    {
+        if (allocation == VK_NULL_HANDLE || category >= MemoryCategory::Count)
+        {
+            return;
+        }
+
+        VmaAllocationInfo allocation_info{};
+        vmaGetAllocationInfo(allocator, allocation, &allocation_info);
+
+        vmaSetAllocationUserData(allocator, allocation, encode_category(category));
+        vmaSetAllocationName(allocator, allocation, get_category_name(category));
+
+        category_bytes[static_cast<size_t>(category)].fetch_add(allocation_info.size, std::memory_order_relaxed);
+        category_allocations[static_cast<size_t>(category)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::release(VmaAllocator allocator, VmaAllocation allocation)
+    {
+        if (allocation == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        VmaAllocationInfo allocation_info{};
+        vmaGetAllocationInfo(allocator, allocation, &allocation_info);
+
+        const auto encoded = reinterpret_cast<uintptr_t>(allocation_info.pUserData);
+        if (encoded == 0 || encoded > category_count)
+        {
+            return;
+        }
+
+        category_bytes[encoded - 1].fetch_sub(allocation_info.size, std::memory_order_relaxed);
+        category_allocations[encoded - 1].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    VkDeviceSize MemoryTracker::get_category_bytes(MemoryCategory category)
+    {
+        return category < MemoryCategory::Count ? category_bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed) : 0;
+    }
+
+    uint32_t MemoryTracker::get_category_allocations(MemoryCategory category)
+    {
+        return category < MemoryCategory::Count ? category_allocations[static_cast<size_t>(category)].load(std::memory_order_relaxed) : 0;
+    }
+
+    const char* MemoryTracker::get_category_name(MemoryCategory category)
+    {
+        return category < MemoryCategory::Count ? category_names[static_cast<size_t>(category)] : "Unknown";
+    }
+
+    std::vector<HeapBudget> MemoryTracker::get_heap_budgets(VmaAllocator allocator)
+    {
+        const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+        vmaGetMemoryProperties(allocator, &memory_properties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+        vmaGetHeapBudgets(allocator, budgets);
+
+        std::vector<HeapBudget> heaps(memory_properties->memoryHeapCount);
+        for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i)
+        {
+            heaps[i].heap_index = i;
+            heaps[i].device_local = (memory_properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+            heaps[i].usage = budgets[i].usage;
+            heaps[i].budget = budgets[i].budget;
+            heaps[i].block_bytes = budgets[i].statistics.blockBytes;
+            heaps[i].allocation_bytes = budgets[i].statistics.allocationBytes;
+        }
+
+        return heaps;
+    }
+
+    bool MemoryTracker::fits_device_local_budget(VmaAllocator allocator, VkDeviceSize size, VkDeviceSize* out_available)
+    {
+        VkDeviceSize available = 0;
+
+        for (const auto& heap : get_heap_budgets(allocator))
+        {
+            const auto limit = static_cast<VkDeviceSize>(static_cast<double>(heap.budget) * memory_budget_limit);
+            if (heap.device_local && limit > heap.usage)
+            {
+                available = std::max(available, limit - heap.usage);
+            }
+        }
+
+        if (out_available != nullptr)
+        {
+            *out_available = available;
+        }
+
+        return size <= available;
+    }
+
+    void MemoryTracker::check_budget(VmaAllocator allocator)
+    {
+        uint32_t over_warning = 0;
+
+        for (const auto& heap : get_heap_budgets(allocator))
+        {
+            if (heap.device_local && heap.budget > 0 &&
+                static_cast<double>(heap.usage) > static_cast<double>(heap.budget) * memory_budget_warning)
+            {
+                over_warning |= 1u << heap.heap_index;
+
+                if ((warned_heaps.load(std::memory_order_relaxed) & (1u << heap.heap_index)) == 0)
+                {
+                    std::cout << "Warning: VRAM heap " << heap.heap_index << " uses " << heap.usage / (1024 * 1024) << " MB of its "
+                              << heap.budget / (1024 * 1024) << " MB budget" << std::endl;
+                }
+            }
+        }
+
+        warned_heaps.store(over_warning, std::memory_order_relaxed);
+    }
+}
@@ -1,16 +1,21 @@
 #include "vulkanapp/utils/MemoryUtils.h"
+#include <bit>
+#include <chrono>
 #include <iostream>
+#include <unordered_map>
 
 #define VMA_IMPLEMENTATION
 #include <vma/vk_mem_alloc.h>
 
 #include "vulkanapp/utils/DescriptorUtils.h"
+#include "vulkanapp/utils/MemoryTracker.h"
 #include "vulkanapp/utils/Vk_Utils.h"
 #include "structs/GPU_Buffer.h"
 #include "structs/geometry/GaussianSurface.h"
 #include "structs/geometry/Vertex.h"
 #include "structs/geometry/Vertex2D.h"
 #include "vulkanapp/DeviceManager.h"
+#include "renderer/UploadManager.h"
 
 void utils::MemoryUtils::create_vma_allocator(vulkanapp::DeviceManager& device_manager)
 {
@@ -29,7 +34,13 @@ void utils::MemoryUtils::create_vma_allocator(vulkanapp::DeviceManager& device_m
     
     static VmaAllocatorCreateInfo allocatorInfo;
 
-    allocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT | VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    allocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+
+    //Setting the flag without the extension enabled on the device is invalid
+    if (device_manager.is_memory_budget_supported())
+    {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     allocatorInfo.physicalDevice = device_manager.get_device().physical_device;
     allocatorInfo.instance = device_manager.get_instance();
     allocatorInfo.device = device_manager.get_device();
@@ -48,11 +59,86 @@ void utils::MemoryUtils::create_vma_allocator(vulkanapp::DeviceManager& device_m
     device_manager.set_vma_allocator(allocator);
 
     std::cout << "VMA allocator created successfully." << std::endl;
+
+    create_memory_pools(device_manager);
+}
+
+void utils::MemoryUtils::create_memory_pools(vulkanapp::DeviceManager& device_manager)
+{
+    VmaAllocator allocator = device_manager.get_allocator();
+
+    //Every usage the splat and scratch buffers combine
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = 1024;
+    buffer_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+    VmaAllocationCreateInfo device_info{};
+    device_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    uint32_t device_type = 0;
+    if (vmaFindMemoryTypeIndexForBufferInfo(allocator, &buffer_info, &device_info, &device_type) != VK_SUCCESS)
+    {
+        std::cerr << "No memory type for the splat pools, using the default VMA pools" << std::endl;
+        return;
+    }
+
+    //The type create_device_buffer_prefer_mapped would get. It is only used for the pool when it sits in the same heap as plain VRAM:
+    //without resizable BAR the host visible VRAM is a separate small heap that large scenes would not fit in
+    VmaAllocationCreateInfo mapped_info{};
+    mapped_info.usage = VMA_MEMORY_USAGE_AUTO;
+    mapped_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                        VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+    vmaGetMemoryProperties(allocator, &memory_properties);
+
+    constexpr VkMemoryPropertyFlags mapped_vram = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    uint32_t splat_type = device_type;
+    uint32_t mapped_type = 0;
+    if (vmaFindMemoryTypeIndexForBufferInfo(allocator, &buffer_info, &mapped_info, &mapped_type) == VK_SUCCESS &&
+        (memory_properties->memoryTypes[mapped_type].propertyFlags & mapped_vram) == mapped_vram &&
+        memory_properties->memoryTypes[mapped_type].heapIndex == memory_properties->memoryTypes[device_type].heapIndex)
+    {
+        splat_type = mapped_type;
+    }
+
+    //Block size 0 is VMA's preferred one. Pools with an explicit block size cannot fall back to dedicated memory,
+    //which buffers above half a block still get
+    VmaPoolCreateInfo pool_info{};
+
+    VmaPool splat_pool = VK_NULL_HANDLE;
+    pool_info.memoryTypeIndex = splat_type;
+    if (vmaCreatePool(allocator, &pool_info, &splat_pool) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create the splat memory pool" << std::endl;
+        return;
+    }
+    vmaSetPoolName(allocator, splat_pool, "Splat Pool");
+
+    VmaPool scratch_pool = VK_NULL_HANDLE;
+    pool_info.memoryTypeIndex = device_type;
+    if (vmaCreatePool(allocator, &pool_info, &scratch_pool) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create the scratch memory pool" << std::endl;
+        vmaDestroyPool(allocator, splat_pool);
+        return;
+    }
+    vmaSetPoolName(allocator, scratch_pool, "Scratch Pool");
+
+    device_manager.set_memory_pools(splat_pool, scratch_pool);
+
+    const bool splat_pool_mapped = (memory_properties->memoryTypes[splat_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+    std::cout << "Splat pool in memory type " << splat_type << (splat_pool_mapped ? " (mapped VRAM)" : "")
+              << ", scratch pool in memory type " << device_type << std::endl;
 }
 
 void utils::MemoryUtils::create_buffer(vkb::DispatchTable dispatch_table, VmaAllocator allocator, VkDeviceSize size,
                                        VkBufferUsageFlags usage, VmaMemoryUsage memory_usage, VmaAllocationCreateFlags vmaAllocationFlags,
-                                       GPU_Buffer& out_buffer) 
+                                       MemoryCategory category, GPU_Buffer& out_buffer, const std::vector<uint32_t>& queue_families,
+                                       VmaPool pool)
 {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -60,16 +146,218 @@ void utils::MemoryUtils::create_buffer(vkb::DispatchTable dispatch_table, VmaAll
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    if (queue_families.size() > 1)
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size());
+        bufferInfo.pQueueFamilyIndices = queue_families.data();
+    }
+
     VmaAllocationCreateInfo allocCreateInfo = {};
     allocCreateInfo.usage = memory_usage;  
     allocCreateInfo.flags = vmaAllocationFlags;
+    allocCreateInfo.pool = pool;
 
     if (VkResult result = vmaCreateBuffer(allocator, &bufferInfo, &allocCreateInfo, &out_buffer.buffer, &out_buffer.allocation, &out_buffer.allocation_info); result != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create buffer with VMA!");
     }
 
+    MemoryTracker::track(allocator, out_buffer.allocation, category);
+
     out_buffer.buffer_address = MemoryUtils::get_buffer_device_address(dispatch_table, out_buffer.buffer);
+    out_buffer.size = size;
+    out_buffer.usage = usage;
+}
+
+void utils::MemoryUtils::create_aliasing_buffer(const vkb::DispatchTable& dispatch_table, VmaAllocator allocator, const GPU_Buffer& memory,
+                                                VkDeviceSize offset, VkDeviceSize size, VkBufferUsageFlags usage, GPU_Buffer& out_buffer)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (VkResult result = vmaCreateAliasingBuffer2(allocator, memory.allocation, offset, &bufferInfo, &out_buffer.buffer); result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create aliasing buffer with VMA!");
+    }
+
+    //No allocation of its own, destroy_buffer only destroys the handle
+    out_buffer.allocation = VK_NULL_HANDLE;
+    out_buffer.allocation_info = memory.allocation_info;
+    out_buffer.buffer_address = get_buffer_device_address(dispatch_table, out_buffer.buffer);
+    out_buffer.size = size;
+    out_buffer.usage = usage;
+}
+
+VkDeviceSize utils::MemoryUtils::get_buffer_alignment(const vkb::DispatchTable& dispatch_table, VkBufferUsageFlags usage)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = 1;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkDeviceBufferMemoryRequirements requirements_info{};
+    requirements_info.sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS;
+    requirements_info.pCreateInfo = &bufferInfo;
+
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    dispatch_table.getDeviceBufferMemoryRequirements(&requirements_info, &requirements);
+
+    return requirements.memoryRequirements.alignment;
+}
+
+void utils::MemoryUtils::defragment_pool(EngineContext& engine_context, VmaPool pool, const std::vector<GPU_Buffer*>& buffers)
+{
+    if (pool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    auto device_manager = engine_context.device_manager.get();
+    auto render_pass = engine_context.renderer->get_render_pass();
+    VmaAllocator allocator = device_manager->get_allocator();
+
+    //Nothing may read the buffers while they move
+    engine_context.dispatch_table.deviceWaitIdle();
+
+    std::unordered_map<VmaAllocation, GPU_Buffer*> owners;
+    for (GPU_Buffer* buffer : buffers)
+    {
+        if (buffer->allocation != VK_NULL_HANDLE)
+        {
+            owners[buffer->allocation] = buffer;
+        }
+    }
+
+    VmaDefragmentationInfo defragmentation_info{};
+    defragmentation_info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FULL_BIT;
+    defragmentation_info.pool = pool;
+
+    VmaDefragmentationContext context = VK_NULL_HANDLE;
+    if (vmaBeginDefragmentation(allocator, &defragmentation_info, &context) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to begin defragmentation" << std::endl;
+        return;
+    }
+
+    const std::vector<uint32_t> queue_families = device_manager->get_shared_queue_families();
+
+    for (;;)
+    {
+        VmaDefragmentationPassMoveInfo pass{};
+        VkResult result = vmaBeginDefragmentationPass(allocator, context, &pass);
+        if (result == VK_SUCCESS)
+        {
+            break;
+        }
+        if (result != VK_INCOMPLETE)
+        {
+            std::cerr << "Defragmentation pass failed: " << result << std::endl;
+            break;
+        }
+
+        //Old handles of the moved buffers, destroyed once their contents were copied
+        std::vector<VkBuffer> old_buffers;
+        core::renderer::TimelinePoint last_copy{ QueueLane::Transfer, 0 };
+
+        for (uint32_t i = 0; i < pass.moveCount; ++i)
+        {
+            VmaDefragmentationMove& move = pass.pMoves[i];
+
+            auto owner = owners.find(move.srcAllocation);
+            if (owner == owners.end())
+            {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            GPU_Buffer& buffer = *owner->second;
+
+            //The move is a vkCmdCopyBuffer from the old handle into the recreated one
+            constexpr VkBufferUsageFlags copy_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            if ((buffer.usage & copy_usage) != copy_usage)
+            {
+                std::cerr << "Buffer without transfer usage passed to defragment_pool, left in place" << std::endl;
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            VkBufferCreateInfo bufferInfo{};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = buffer.size;
+            bufferInfo.usage = buffer.usage;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            if (queue_families.size() > 1)
+            {
+                bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size());
+                bufferInfo.pQueueFamilyIndices = queue_families.data();
+            }
+
+            VkBuffer new_buffer = VK_NULL_HANDLE;
+            if (engine_context.dispatch_table.createBuffer(&bufferInfo, nullptr, &new_buffer) != VK_SUCCESS ||
+                vmaBindBufferMemory(allocator, move.dstTmpAllocation, new_buffer) != VK_SUCCESS)
+            {
+                engine_context.dispatch_table.destroyBuffer(new_buffer, nullptr);
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            const core::renderer::TimelinePoint copy_point = render_pass->get_upload_manager()->copy(buffer.buffer, 0, new_buffer, 0, buffer.size);
+            if (copy_point.value == 0)
+            {
+                //The contents would not reach the new place, the buffer stays where it is
+                std::cerr << "Failed to copy a buffer during defragmentation, left in place" << std::endl;
+                engine_context.dispatch_table.destroyBuffer(new_buffer, nullptr);
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            last_copy = copy_point;
+
+            old_buffers.push_back(buffer.buffer);
+            buffer.buffer = new_buffer;
+        }
+
+        render_pass->get_frame_scheduler()->wait_for(last_copy);
+
+        for (VkBuffer old_buffer : old_buffers)
+        {
+            engine_context.dispatch_table.destroyBuffer(old_buffer, nullptr);
+        }
+
+        //The source allocations now describe the new place
+        result = vmaEndDefragmentationPass(allocator, context, &pass);
+
+        for (GPU_Buffer* buffer : buffers)
+        {
+            if (buffer->allocation != VK_NULL_HANDLE)
+            {
+                vmaGetAllocationInfo(allocator, buffer->allocation, &buffer->allocation_info);
+                buffer->buffer_address = get_buffer_device_address(engine_context.dispatch_table, buffer->buffer);
+            }
+        }
+
+        if (result == VK_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    VmaDefragmentationStats stats{};
+    vmaEndDefragmentation(allocator, context, &stats);
+
+    if (stats.allocationsMoved != 0 || stats.deviceMemoryBlocksFreed != 0)
+    {
+        std::cout << "Defragmentation moved " << stats.allocationsMoved << " allocations (" << stats.bytesMoved / (1024 * 1024) << " MB), freed "
+                  << stats.deviceMemoryBlocksFreed << " blocks (" << stats.bytesFreed / (1024 * 1024) << " MB)" << std::endl;
+    }
 }
 
 VkResult utils::MemoryUtils::map_persistent_data(VmaAllocator vmaAllocator, VmaAllocation allocation, const VmaAllocationInfo& allocationInfo, const void* data, VkDeviceSize
@@ -101,142 +389,212 @@ VkDeviceAddress utils::MemoryUtils::get_buffer_device_address(const vkb::Dispatc
 }
 
 
-void utils::MemoryUtils::copy_buffer(vkb::DispatchTable disp, VkQueue queue, VkCommandPool command_pool, VkBuffer srcBuffer,
-                          VkBuffer dst_buffer, VkDeviceSize size)
+void utils::MemoryUtils::create_device_buffer_prefer_mapped(EngineContext& engine_context, VkDeviceSize size, VkBufferUsageFlags usage,
+                                                             MemoryCategory category, GPU_Buffer& out_buffer)
 {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = command_pool;
-    allocInfo.commandBufferCount = 1;
+    auto device_manager = engine_context.device_manager.get();
 
-    VkCommandBuffer commandBuffer;
-    disp.allocateCommandBuffers(&allocInfo, &commandBuffer);
+    //ALLOW_TRANSFER_INSTEAD makes VMA pick DEVICE_LOCAL | HOST_VISIBLE memory when there is any, and unmapped VRAM otherwise.
+    //Transfer dst stays in the usage for the fallback
+    create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), size,
+                  usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                  VMA_MEMORY_USAGE_AUTO,
+                  VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                  VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                  category, out_buffer, device_manager->get_shared_queue_families(), //Written by the transfer queue, read by the async compute passes
+                  device_manager->get_splat_pool());
+}
 
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+core::renderer::TimelinePoint utils::MemoryUtils::write_device_buffer(EngineContext& engine_context, const GPU_Buffer& buffer,
+                                                                      const void* data, VkDeviceSize size, UploadReport* report)
+{
+    return write_device_buffer_range(engine_context, buffer, 0, data, size, report);
+}
 
-    disp.beginCommandBuffer(commandBuffer, &beginInfo);
+core::renderer::TimelinePoint utils::MemoryUtils::write_device_buffer_range(EngineContext& engine_context, const GPU_Buffer& buffer, VkDeviceSize offset,
+                                                                            const void* data, VkDeviceSize size, UploadReport* report)
+{
+    const auto* source = static_cast<const char*>(data);
 
-    VkBufferCopy copyRegion{};
-    copyRegion.size = size;
-    disp.cmdCopyBuffer(commandBuffer, srcBuffer, dst_buffer, 1, &copyRegion);
+    return write_device_buffer_range(engine_context, buffer, offset, size, 1, [source](void* destination, VkDeviceSize chunk_offset, VkDeviceSize chunk_size)
+    {
+        memcpy(destination, source + chunk_offset, chunk_size);
+    }, report);
+}
 
-    disp.endCommandBuffer(commandBuffer);
+core::renderer::TimelinePoint utils::MemoryUtils::write_device_buffer_range(EngineContext& engine_context, const GPU_Buffer& buffer, VkDeviceSize offset,
+                                                                            VkDeviceSize size, VkDeviceSize granularity,
+                                                                            const core::renderer::UploadManager::ChunkWriter& writer, UploadReport* report)
+{
+    auto write_start = std::chrono::high_resolution_clock::now();
+    core::renderer::TimelinePoint point{ QueueLane::Transfer, 0 };
 
-    VkSubmitInfo2 submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-    submitInfo.pNext = nullptr;
-    submitInfo.flags = 0;
+    const bool direct = buffer.allocation_info.pMappedData != nullptr;
+    if (direct)
+    {
+        writer(static_cast<char*>(buffer.allocation_info.pMappedData) + offset, 0, size);
+        vmaFlushAllocation(engine_context.device_manager->get_allocator(), buffer.allocation, offset, size);
+    }
+    else
+    {
+        point = engine_context.renderer->get_render_pass()->get_upload_manager()->upload(size, writer, buffer.buffer, offset, granularity);
+    }
 
-    VkCommandBufferSubmitInfo commandBufferSubmitInfo{};
-    commandBufferSubmitInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
-    commandBufferSubmitInfo.pNext = nullptr;
-    commandBufferSubmitInfo.commandBuffer = commandBuffer;
-    commandBufferSubmitInfo.deviceMask = 0;
+    if (report != nullptr)
+    {
+        report->path = direct ? UploadPath::Direct : UploadPath::Staging;
+        report->bytes = size;
+        report->milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - write_start).count();
+        report->megabytes_per_second = report->milliseconds > 0.0f ?
+                                       static_cast<float>(size) / (1024.0f * 1024.0f) / (report->milliseconds / 1000.0f) : 0.0f;
+    }
 
-    std::vector commandBufferSubmitInfos = {commandBufferSubmitInfo};
+    return point;
+}
 
-    submitInfo.commandBufferInfoCount = commandBufferSubmitInfos.size();
-    submitInfo.pCommandBufferInfos = commandBufferSubmitInfos.data();
+bool utils::MemoryUtils::import_host_memory(EngineContext& engine_context, void* host_pointer, VkDeviceSize size,
+                                            VkBuffer& out_buffer, VkDeviceMemory& out_memory)
+{
+    auto device_manager = engine_context.device_manager.get();
+    auto& dispatch_table = engine_context.dispatch_table;
+
+    out_buffer = VK_NULL_HANDLE;
+    out_memory = VK_NULL_HANDLE;
+
+    const VkDeviceSize alignment = device_manager->get_min_imported_host_pointer_alignment();
+    if (!device_manager->is_external_memory_host_supported() || alignment == 0 ||
+        reinterpret_cast<uintptr_t>(host_pointer) % alignment != 0 || size % alignment != 0)
+    {
+        return false;
+    }
+
+    VkMemoryHostPointerPropertiesEXT host_pointer_properties{};
+    host_pointer_properties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+    if (dispatch_table.getMemoryHostPointerPropertiesEXT(VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, host_pointer,
+                                                         &host_pointer_properties) != VK_SUCCESS)
+    {
+        std::cerr << "Host pointer cannot be imported" << std::endl;
+        return false;
+    }
+
+    VkExternalMemoryBufferCreateInfo external_buffer_info{};
+    external_buffer_info.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+    external_buffer_info.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+    //Only ever read by the transfer queue
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.pNext = &external_buffer_info;
+    buffer_info.size = size;
+    buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (dispatch_table.createBuffer(&buffer_info, nullptr, &out_buffer) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to create host import buffer" << std::endl;
+        return false;
+    }
+
+    VkMemoryRequirements memory_requirements;
+    dispatch_table.getBufferMemoryRequirements(out_buffer, &memory_requirements);
+
+    const uint32_t memory_type_bits = memory_requirements.memoryTypeBits & host_pointer_properties.memoryTypeBits;
+    if (memory_type_bits == 0)
+    {
+        std::cerr << "No memory type can back the imported host pointer" << std::endl;
+        dispatch_table.destroyBuffer(out_buffer, nullptr);
+        out_buffer = VK_NULL_HANDLE;
+        return false;
+    }
 
-    disp.queueSubmit2(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    disp.queueWaitIdle(queue);
+    VkImportMemoryHostPointerInfoEXT import_info{};
+    import_info.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+    import_info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    import_info.pHostPointer = host_pointer;
 
-    disp.freeCommandBuffers(command_pool, 1, &commandBuffer);
+    //Lowest set bit: any of the allowed types maps the same pages
+    VkMemoryAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = &import_info;
+    allocate_info.allocationSize = size;
+    allocate_info.memoryTypeIndex = static_cast<uint32_t>(std::countr_zero(memory_type_bits));
+
+    if (dispatch_table.allocateMemory(&allocate_info, nullptr, &out_memory) != VK_SUCCESS ||
+        dispatch_table.bindBufferMemory(out_buffer, out_memory, 0) != VK_SUCCESS)
+    {
+        std::cerr << "Failed to import host memory" << std::endl;
+
+        if (out_memory != VK_NULL_HANDLE)
+        {
+            dispatch_table.freeMemory(out_memory, nullptr);
+            out_memory = VK_NULL_HANDLE;
+        }
+
+        dispatch_table.destroyBuffer(out_buffer, nullptr);
+        out_buffer = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
 }
 
 template <typename V>
-void utils::MemoryUtils::create_vertex_buffer_with_staging(EngineContext& engine_context, const std::vector<V>& vertices, VkCommandPool command_pool, GPU_Buffer& out_vertex_buffer)
+core::renderer::TimelinePoint utils::MemoryUtils::create_vertex_buffer_with_staging(EngineContext& engine_context, const std::vector<V>& vertices, GPU_Buffer& out_vertex_buffer,
+                                                                                    UploadReport* report)
 {
     VkDeviceSize vertexBufferSize = sizeof(V) * vertices.size();
-    auto device_manager = engine_context.device_manager.get();
-
-    // Create Staging Buffer for Vertices using VMA
-    GPU_Buffer staging_vertex_buffer;
-    create_buffer(engine_context.dispatch_table, device_manager->get_allocator(),
-                  vertexBufferSize,
-                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT,
-                  VMA_MEMORY_USAGE_AUTO,
-                  VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |  VMA_ALLOCATION_CREATE_MAPPED_BIT, staging_vertex_buffer);
 
-    // Copy Vertex Data to Staging Buffer using VMA mapping
     assert(vertices.size() != 0);
 
-    void* data;
-    vmaMapMemory(device_manager->get_allocator(), staging_vertex_buffer.allocation, &data);
-    memcpy(data, vertices.data(),  vertexBufferSize);
-    vmaUnmapMemory(engine_context.device_manager->get_allocator(), staging_vertex_buffer.allocation);
-
-    // Create Vertex Buffer (Device Local) using VMA
-    create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), vertexBufferSize,
-                  VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-                  VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_AUTO,VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT, out_vertex_buffer);
-
-    // Copy from Staging Vertex Buffer to Device Local Vertex Buffer
-    copy_buffer(engine_context.dispatch_table, device_manager->get_graphics_queue(), command_pool, staging_vertex_buffer.buffer, out_vertex_buffer.buffer, vertexBufferSize);
+    // Create Vertex Buffer (Device Local, mapped on ReBAR) using VMA
+    create_device_buffer_prefer_mapped(engine_context, vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, MemoryCategory::Other, out_vertex_buffer);
     set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) out_vertex_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Vertex Buffer");
 
-    // Clean up Staging Vertex Buffer using VMA
-    vmaDestroyBuffer(device_manager->get_allocator(), staging_vertex_buffer.buffer, staging_vertex_buffer.allocation);
+    // Written in place when mapped, otherwise streamed through the staging ring on the transfer queue
+    return write_device_buffer(engine_context, out_vertex_buffer, vertices.data(), vertexBufferSize, report);
 }
 
 //Specilizations
-template void utils::MemoryUtils::create_vertex_buffer_with_staging(EngineContext& engine_context, const std::vector<GaussianSurface>& vertices, VkCommandPool command_pool, GPU_Buffer& out_vertex_buffer);
+template core::renderer::TimelinePoint utils::MemoryUtils::create_vertex_buffer_with_staging(EngineContext& engine_context, const std::vector<GaussianSurface>& vertices, GPU_Buffer& out_vertex_buffer,
+                                                                                             UploadReport* report);
 
 template <typename V>
-void utils::MemoryUtils::create_index_buffer_with_staging(EngineContext& engine_context, const std::vector<uint32_t>& indices, VkCommandPool command_pool, GPU_Buffer& out_index_buffer)
+core::renderer::TimelinePoint utils::MemoryUtils::create_index_buffer_with_staging(EngineContext& engine_context, const std::vector<uint32_t>& indices, GPU_Buffer& out_index_buffer)
 {
     VkDeviceSize indexBufferSize = sizeof(uint32_t) * indices.size();
     auto device_manager = engine_context.device_manager.get();
 
-    // Create Staging Buffer for Indices using VMA
-    GPU_Buffer staging_index_buffer;
-    create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), indexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT,
-                  VMA_MEMORY_USAGE_AUTO,
-                  VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |  VMA_ALLOCATION_CREATE_MAPPED_BIT, staging_index_buffer);
-
-    void* index_data;
-
-    // Copy Index Data to Staging Buffer using VMA mapping
-    vmaMapMemory(device_manager->get_allocator(), staging_index_buffer.allocation, &index_data);
-    memcpy(index_data, indices.data(), (size_t) indexBufferSize);
-    vmaUnmapMemory(device_manager->get_allocator(), staging_index_buffer.allocation);
-
     // Create Index Buffer (Device Local) using VMA
     create_buffer(engine_context.dispatch_table, device_manager->get_allocator(), indexBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT |
                   VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                  VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT, out_index_buffer);
+                  VMA_MEMORY_USAGE_AUTO, 0, MemoryCategory::Other, out_index_buffer,
+                  device_manager->get_shared_queue_families());
 
     utils::set_vulkan_object_Name(engine_context.dispatch_table, (uint64_t) out_index_buffer.buffer, VK_OBJECT_TYPE_BUFFER, "Index Buffer");
 
-    // Copy from Staging Index Buffer to Device Local Index Buffer
-    copy_buffer(engine_context.dispatch_table, device_manager->get_graphics_queue(), command_pool, staging_index_buffer.buffer, out_index_buffer.buffer, indexBufferSize);
-
-    // Clean up Staging Index Buffer using VMA
-    vmaDestroyBuffer(device_manager->get_allocator(), staging_index_buffer.buffer, staging_index_buffer.allocation);
+    // Streamed through the staging ring on the transfer queue
+    return engine_context.renderer->get_render_pass()->get_upload_manager()->upload(indices.data(), indexBufferSize, out_index_buffer.buffer);
 }
 
 template<typename V>
-void utils::MemoryUtils::create_vertex_and_index_buffers(
+core::renderer::TimelinePoint utils::MemoryUtils::create_vertex_and_index_buffers(
     EngineContext& engine_context, const std::vector<V>& vertices,
-    const std::vector<uint32_t>& indices, VkCommandPool command_pool, GPU_Buffer& out_vertex_buffer, GPU_Buffer& out_index_buffer)
+    const std::vector<uint32_t>& indices, GPU_Buffer& out_vertex_buffer, GPU_Buffer& out_index_buffer)
 {
-    create_vertex_buffer_with_staging<V>(engine_context, vertices, command_pool, out_vertex_buffer);
+    create_vertex_buffer_with_staging<V>(engine_context, vertices, out_vertex_buffer);
 
-    create_index_buffer_with_staging<V>(engine_context, indices, command_pool, out_index_buffer);
+    return create_index_buffer_with_staging<V>(engine_context, indices, out_index_buffer);
 }
 
 //Instantiations
-template void utils::MemoryUtils::create_vertex_and_index_buffers<Vertex>(
+template core::renderer::TimelinePoint utils::MemoryUtils::create_vertex_and_index_buffers<Vertex>(
     EngineContext& engine_context, const std::vector<Vertex>& vertices,
-    const std::vector<uint32_t>& indices, VkCommandPool command_pool, GPU_Buffer& out_vertex_buffer, GPU_Buffer&
+    const std::vector<uint32_t>& indices, GPU_Buffer& out_vertex_buffer, GPU_Buffer&
     out_index_buffer);
 
-template void utils::MemoryUtils::create_vertex_and_index_buffers<Vertex2D>(
+template core::renderer::TimelinePoint utils::MemoryUtils::create_vertex_and_index_buffers<Vertex2D>(
     EngineContext& engine_context, const std::vector<Vertex2D>& vertices,
-    const std::vector<uint32_t>& indices, VkCommandPool command_pool, GPU_Buffer& out_vertex_buffer, GPU_Buffer&
+    const std::vector<uint32_t>& indices, GPU_Buffer& out_vertex_buffer, GPU_Buffer&
     out_index_buffer);
 
 
@@ -247,7 +605,7 @@ void utils::MemoryUtils::allocate_buffer_with_mapped_access(const vkb::DispatchT
                   VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                   VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
                   VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
-                  VMA_ALLOCATION_CREATE_MAPPED_BIT, buffer);
+                  VMA_ALLOCATION_CREATE_MAPPED_BIT, MemoryCategory::Other, buffer);
 }
 
 void utils::MemoryUtils::allocate_buffer_with_random_access(const vkb::DispatchTable& dispatch_table, VmaAllocator allocator,
@@ -257,15 +615,126 @@ void utils::MemoryUtils::allocate_buffer_with_random_access(const vkb::DispatchT
                   size,
                   VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
                   VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
-                  VMA_ALLOCATION_CREATE_MAPPED_BIT, buffer);
+                  VMA_ALLOCATION_CREATE_MAPPED_BIT, MemoryCategory::Other, buffer);
 }
 
 void utils::MemoryUtils::destroy_buffer(VmaAllocator allocator, GPU_Buffer& buffer)
 {
     if (buffer.buffer != VK_NULL_HANDLE)
     {
+        MemoryTracker::release(allocator, buffer.allocation);
         vmaDestroyBuffer(allocator, buffer.buffer, buffer.allocation);
         buffer.buffer = VK_NULL_HANDLE;
         buffer.allocation = VK_NULL_HANDLE;
     }
 }
+
+void utils::MemoryUtils::destroy_image(const vkb::DispatchTable& disp, VmaAllocator allocator, Vk_Image& image)
+{
+    if (image.view != VK_NULL_HANDLE)
+    {
+        disp.destroyImageView(image.view, nullptr);
+        image.view = VK_NULL_HANDLE;
+    }
+
+    if (image.image != VK_NULL_HANDLE)
+    {
+        MemoryTracker::release(allocator, image.allocation);
+        vmaDestroyImage(allocator, image.image, image.allocation);
+        image.image = VK_NULL_HANDLE;
+        image.allocation = VK_NULL_HANDLE;
+    }
+}
+
+void utils::MemoryUtils::buffer_memory_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer, VkBuffer buffer,
+                                               VkPipelineStageFlags2 src_stage_mask, VkPipelineStageFlags2 dst_stage_mask,
+                                               VkAccessFlags2 src_access_mask, VkAccessFlags2 dst_access_mask)
+{
+    VkBufferMemoryBarrier2 buffer_barrier{};
+    buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    buffer_barrier.srcStageMask = src_stage_mask;
+    buffer_barrier.srcAccessMask = src_access_mask;
+    buffer_barrier.dstStageMask = dst_stage_mask;
+    buffer_barrier.dstAccessMask = dst_access_mask;
+    buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_barrier.buffer = buffer;
+    buffer_barrier.offset = 0;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.bufferMemoryBarrierCount = 1;
+    dependency_info.pBufferMemoryBarriers = &buffer_barrier;
+
+    disp.cmdPipelineBarrier2(command_buffer, &dependency_info);
+}
+
+void utils::MemoryUtils::queue_release_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer, VkBuffer buffer,
+                                               VkPipelineStageFlags2 src_stage_mask, VkAccessFlags2 src_access_mask,
+                                               uint32_t src_queue_family, uint32_t dst_queue_family)
+{
+    //Destination scope is ignored for a release, the acquire on the other queue provides it
+    VkBufferMemoryBarrier2 buffer_barrier{};
+    buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    buffer_barrier.srcStageMask = src_stage_mask;
+    buffer_barrier.srcAccessMask = src_access_mask;
+    buffer_barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+    buffer_barrier.dstAccessMask = 0;
+    buffer_barrier.srcQueueFamilyIndex = src_queue_family;
+    buffer_barrier.dstQueueFamilyIndex = dst_queue_family;
+    buffer_barrier.buffer = buffer;
+    buffer_barrier.offset = 0;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.bufferMemoryBarrierCount = 1;
+    dependency_info.pBufferMemoryBarriers = &buffer_barrier;
+
+    disp.cmdPipelineBarrier2(command_buffer, &dependency_info);
+}
+
+void utils::MemoryUtils::queue_acquire_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer, VkBuffer buffer,
+                                               VkPipelineStageFlags2 dst_stage_mask, VkAccessFlags2 dst_access_mask,
+                                               uint32_t src_queue_family, uint32_t dst_queue_family)
+{
+    //Source scope is ignored for an acquire, the semaphore wait provides it
+    VkBufferMemoryBarrier2 buffer_barrier{};
+    buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    buffer_barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+    buffer_barrier.srcAccessMask = 0;
+    buffer_barrier.dstStageMask = dst_stage_mask;
+    buffer_barrier.dstAccessMask = dst_access_mask;
+    buffer_barrier.srcQueueFamilyIndex = src_queue_family;
+    buffer_barrier.dstQueueFamilyIndex = dst_queue_family;
+    buffer_barrier.buffer = buffer;
+    buffer_barrier.offset = 0;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.bufferMemoryBarrierCount = 1;
+    dependency_info.pBufferMemoryBarriers = &buffer_barrier;
+
+    disp.cmdPipelineBarrier2(command_buffer, &dependency_info);
+}
+
+void utils::MemoryUtils::memory_barrier(const vkb::DispatchTable& disp, VkCommandBuffer command_buffer,
+                                        VkPipelineStageFlags2 src_stage_mask, VkPipelineStageFlags2 dst_stage_mask,
+                                        VkAccessFlags2 src_access_mask, VkAccessFlags2 dst_access_mask)
+{
+    VkMemoryBarrier2 memory_barrier{};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    memory_barrier.srcStageMask = src_stage_mask;
+    memory_barrier.srcAccessMask = src_access_mask;
+    memory_barrier.dstStageMask = dst_stage_mask;
+    memory_barrier.dstAccessMask = dst_access_mask;
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.memoryBarrierCount = 1;
+    dependency_info.pMemoryBarriers = &memory_barrier;
+
+    disp.cmdPipelineBarrier2(command_buffer, &dependency_info);
+}
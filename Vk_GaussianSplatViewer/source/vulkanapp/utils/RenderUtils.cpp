@@ -3,13 +3,21 @@
 #include "VkBootstrap.h"
 #include "vulkanapp/DeviceManager.h"
 #include "structs/Vk_Image.h"
+#include "vulkanapp/utils/ImageUtils.h"
+#include "vulkanapp/utils/MemoryTracker.h"
 
-bool utils::RenderUtils::create_command_pool(const EngineContext& engine_context, VkCommandPool& out_command_pool)
+bool utils::RenderUtils::create_command_pool(const EngineContext& engine_context, VkCommandPool& out_command_pool, VkCommandPoolCreateFlags flags)
+{
+    return create_command_pool(engine_context, out_command_pool, flags, engine_context.device_manager->get_graphics_queue_family());
+}
+
+bool utils::RenderUtils::create_command_pool(const EngineContext& engine_context, VkCommandPool& out_command_pool, VkCommandPoolCreateFlags flags,
+                                             uint32_t queue_family_index)
 {
     VkCommandPoolCreateInfo pool_info = {};
     pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    pool_info.queueFamilyIndex = engine_context.device_manager->get_device().get_queue_index(vkb::QueueType::graphics).value();
-    pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pool_info.queueFamilyIndex = queue_family_index;
+    pool_info.flags = flags;
     
     if (engine_context.dispatch_table.createCommandPool(&pool_info, nullptr, &out_command_pool) != VK_SUCCESS)
     {
@@ -97,6 +105,8 @@ bool utils::RenderUtils::create_depth_stencil_image(const EngineContext& engine_
         return true;
     }
 
+    MemoryTracker::track(allocator, depth_image.allocation, MemoryCategory::Depth);
+
     VkImageViewCreateInfo imageViewCI{};
     imageViewCI.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     imageViewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
@@ -122,6 +132,31 @@ bool utils::RenderUtils::create_depth_stencil_image(const EngineContext& engine_
     return true;
 }
 
+bool utils::RenderUtils::create_storage_image(const EngineContext& engine_context, VkExtent2D extents, VkFormat format,
+    VmaAllocator allocator, MemoryCategory category, Vk_Image& storage_image)
+{
+    storage_image.format = format;
+
+    VkImageCreateInfo imageCI = ImageUtils::image_create_info(format,
+                                                              VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                                              { extents.width, extents.height, 1 });
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    if (vmaCreateImage(allocator, &imageCI, &allocInfo, &storage_image.image, &storage_image.allocation, &storage_image.allocation_info) != VK_SUCCESS)
+    {
+        std::cerr << "failed to create storage image!";
+        return false;
+    }
+
+    MemoryTracker::track(allocator, storage_image.allocation, category);
+
+    ImageUtils::create_image_view(engine_context.dispatch_table, storage_image, format);
+
+    return storage_image.view != VK_NULL_HANDLE;
+}
+
 VkRenderingInfoKHR utils::RenderUtils::rendering_info(VkRect2D render_area, uint32_t color_attachment_count,
     const VkRenderingAttachmentInfoKHR* pColorAttachments, VkRenderingFlagsKHR flags)
 {
@@ -79,4 +79,21 @@ if(NOT Imgui_FOUND)
 	)
 	message(STATUS "Using Imgui via FetchContent")
 	FetchContent_MakeAvailable(Imgui)
-endif()
\ No newline at end of file
+endif()
+
+#json
+find_package(nlohmann_json 3.11 QUIET)
+if(nlohmann_json_FOUND)
+	message(STATUS "Using nlohmann_json via find_package")
+endif()
+if(NOT nlohmann_json_FOUND)
+	FetchContent_Declare(
+			nlohmann_json
+			GIT_REPOSITORY "https://github.com/nlohmann/json.git"
+			GIT_TAG        v3.11.3
+			GIT_SHALLOW TRUE
+			GIT_PROGRESS TRUE
+	)
+	message(STATUS "Using nlohmann_json via FetchContent")
+	FetchContent_MakeAvailable(nlohmann_json)
+endif()
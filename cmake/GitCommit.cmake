@@ -0,0 +1,29 @@
+#Writes the checked out commit into OUTPUT as GSV_GIT_COMMIT, "unknown" outside of a git checkout.
+#Run at build time by the gsv_bench target with GIT_EXECUTABLE, SOURCE_DIR and OUTPUT set
+
+set(commit "unknown")
+if(GIT_EXECUTABLE)
+	execute_process(
+		COMMAND ${GIT_EXECUTABLE} describe --always --dirty
+		WORKING_DIRECTORY ${SOURCE_DIR}
+		OUTPUT_VARIABLE git_commit
+		RESULT_VARIABLE git_result
+		OUTPUT_STRIP_TRAILING_WHITESPACE
+		ERROR_QUIET
+	)
+	if(git_result EQUAL 0 AND git_commit)
+		set(commit "${git_commit}")
+	endif()
+endif()
+
+set(content "#pragma once\n\n//Generated by cmake/GitCommit.cmake, do not edit\n#define GSV_GIT_COMMIT \"${commit}\"\n")
+
+#Only rewritten when the commit changed, so index updates alone do not rebuild the benchmark
+set(previous "")
+if(EXISTS "${OUTPUT}")
+	file(READ "${OUTPUT}" previous)
+endif()
+
+if(NOT previous STREQUAL content)
+	file(WRITE "${OUTPUT}" "${content}")
+endif()